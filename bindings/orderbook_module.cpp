@@ -1,3 +1,4 @@
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -5,10 +6,17 @@
 #include <pybind11/stl.h>
 
 #include "SingleVariableCounter.h"
+#include "SnapshotContext.h"
 #include "MarketState.h"
 #include "TradeEntry.h"
 #include "DifferenceDepthEntry.h"
+#include "DecodedEntry.h"
+#include "Checkpoint.h"
+#include "FixedPoint.h"
+#include "EventArchive.h"
+#include "EventFile.h"
 #include "GlobalMarketState.h"
+#include "MMapData.h"
 #include "OrderBook.h"
 #include "OrderBookMetricsEntry.h"
 // #include "OrderBookMetrics.h"
@@ -29,6 +37,62 @@ static py::int_ parse_mask_py(const std::vector<std::string>& vars) {
     return pyint.cast<py::int_>();
 }
 
+// the Python API keeps taking the book / rolling statistics; each call gets its own context
+template <typename Source, typename R, typename... Args>
+static auto withContext(R (*calculate)(SnapshotContext&, Args...)) {
+    return [calculate](const Source& source, Args... args) {
+        SnapshotContext context(source);
+        return calculate(context, args...);
+    };
+}
+
+// windows come from Python in seconds; fractions of a second reach the 100 ms resolution
+static int64_t windowMicros(const double windowTimeSeconds) {
+    return std::llround(windowTimeSeconds * 1'000'000.0);
+}
+
+static std::vector<int64_t> windowsMicros(const std::vector<double>& windowsTimeSeconds) {
+    std::vector<int64_t> micros;
+    micros.reserve(windowsTimeSeconds.size());
+    for (const double seconds : windowsTimeSeconds) micros.push_back(windowMicros(seconds));
+    return micros;
+}
+
+template <typename Source, typename R>
+static auto withWindowContext(R (*calculate)(SnapshotContext&, int64_t)) {
+    return [calculate](const Source& source, const double windowTimeSeconds) {
+        SnapshotContext context(source);
+        return calculate(context, windowMicros(windowTimeSeconds));
+    };
+}
+
+template <typename Class, typename R>
+static auto inSeconds(R (Class::*query)(int64_t) const) {
+    return [query](const Class& self, const double windowTimeSeconds) { return (self.*query)(windowMicros(windowTimeSeconds)); };
+}
+
+// save_checkpoint / load_checkpoint and pickle support through the binary checkpoint format
+template <typename T, typename Class, typename MakeEmpty>
+static void defCheckpoint(Class& cls, const Checkpoint::Kind kind, MakeEmpty makeEmpty) {
+    cls.def("save_checkpoint",
+            [kind](const T& self, const std::string& path) { Checkpoint::writeFile(path, Checkpoint::save(self, kind)); },
+            py::arg("path"))
+       .def("load_checkpoint",
+            [kind](T& self, const std::string& path) { const MMapData file(path); Checkpoint::load(self, file.bytes(), kind); },
+            py::arg("path"))
+       .def(py::pickle(
+            [kind](const T& self) {
+                const std::vector<char> bytes = Checkpoint::save(self, kind);
+                return py::bytes(bytes.data(), bytes.size());
+            },
+            [kind, makeEmpty](const py::bytes& state) {
+                const std::string bytes = state;
+                T object = makeEmpty();
+                Checkpoint::load(object, std::span<const char>(bytes.data(), bytes.size()), kind);
+                return object;
+            }));
+}
+
 PYBIND11_MODULE(cpp_binance_orderbook, m) {
     // std::cout << std::fixed << std::setprecision(5);
 
@@ -37,30 +101,71 @@ PYBIND11_MODULE(cpp_binance_orderbook, m) {
         .def(py::init<>())
 
         .def("compute_variables",
-             &OrderBookSessionSimulator::computeVariables,
-             py::arg("csv_path"), py::arg("variables"),
-             "compute_variables(csv_path, variables) -> dict of numpy arrays")
+             py::overload_cast<const std::string&, const std::vector<std::string>&, std::optional<int64_t>, std::optional<int64_t>>(&OrderBookSessionSimulator::computeVariables),
+             py::arg("csv_path"), py::arg("variables"), py::arg("start_timestamp") = py::none(), py::arg("end_timestamp") = py::none(),
+             "compute_variables(csv_path, variables[, start_timestamp, end_timestamp]) -> dict of numpy arrays; tylko wiersze z TimestampOfReceiveUS w [start, end), CSV czytany od najbliższego snapshotu (indeks <csv>.tsidx)")
+        .def("compute_variables",
+             py::overload_cast<const std::vector<std::string>&, const std::vector<std::string>&>(&OrderBookSessionSimulator::computeVariables),
+             py::arg("csv_paths"), py::arg("variables"),
+             "compute_variables(csv_paths, variables) -> dict of numpy arrays; surowe pliki snapshot / diff / trade łączone po TimestampOfReceiveUS")
         .def("compute_backtest",
-             &OrderBookSessionSimulator::computeBacktest,
+             py::overload_cast<const std::string&, std::vector<std::string>&, const py::object&>(&OrderBookSessionSimulator::computeBacktest),
              py::arg("csv_path"), py::arg("variables"), py::arg("python_callback") = py::none(),
              "compute_backtest(csv_path, variables[, python_callback]) -> dict of numpy arrays")
+        .def("compute_backtest",
+             py::overload_cast<const std::vector<std::string>&, std::vector<std::string>&, const py::object&>(&OrderBookSessionSimulator::computeBacktest),
+             py::arg("csv_paths"), py::arg("variables"), py::arg("python_callback") = py::none(),
+             "compute_backtest(csv_paths, variables[, python_callback]) -> dict of numpy arrays")
+        .def("compute_variables_over_days",
+             &OrderBookSessionSimulator::computeVariablesOverDays,
+             py::arg("day_paths"), py::arg("variables"),
+             "compute_variables_over_days(day_paths, variables) -> dict of numpy arrays; kolejne dni jako jedna sesja (książki i okna kroczące przechodzą przez północ)")
+        .def("compute_backtest_over_days",
+             &OrderBookSessionSimulator::computeBacktestOverDays,
+             py::arg("day_paths"), py::arg("variables"), py::arg("python_callback") = py::none(),
+             "compute_backtest_over_days(day_paths, variables[, python_callback]) -> dict of numpy arrays")
 
         .def("compute_final_depth_snapshot", &OrderBookSessionSimulator::computeFinalDepthSnapshot,
              py::arg("csv_path"),
              "Zwraca FinalOrderBookSnapshot")
         ;
 
+    // ----- EventFile -----
+    m.def("convert_csv_to_event_file",
+          [](const std::string &csvPath, const std::string &outPath, const bool singleAsset) {
+              if (singleAsset) EventFile::convertSingleAssetParametersCSV(csvPath, outPath);
+              else EventFile::convertMultiAssetParametersCSV(csvPath, outPath);
+          },
+          py::arg("csv_path"), py::arg("out_path"), py::arg("single_asset") = false,
+          "Konwertuje CSV do binarnego pliku kolumnowego, który compute_variables czyta bez parsowania tekstu");
+    m.def("is_event_file", &EventFile::isEventFile, py::arg("path"));
+
+    // ----- EventArchive -----
+    m.def("convert_csv_to_event_archive",
+          [](const std::string &csvPath, const std::string &outPath, const bool singleAsset) {
+              if (singleAsset) EventArchive::convertSingleAssetParametersCSV(csvPath, outPath);
+              else EventArchive::convertMultiAssetParametersCSV(csvPath, outPath);
+          },
+          py::arg("csv_path"), py::arg("out_path"), py::arg("single_asset") = false,
+          "Konwertuje CSV do skompresowanego archiwum bloków (delta + varint) z indeksem timestampów");
+    m.def("is_event_archive", &EventArchive::isEventArchive, py::arg("path"));
+
     // ----- GlobalMarketState -----
-    py::class_<GlobalMarketState>(m, "GlobalMarketState")
-        .def(py::init<MetricMask>(), py::arg("mask"),
+    py::class_<GlobalMarketState> globalMarketStateClass(m, "GlobalMarketState");
+    globalMarketStateClass
+        .def(py::init<MetricMask, size_t>(), py::arg("mask"), py::arg("depth_limit") = OrderBook::UNBOUNDED_DEPTH,
              "Tworzy GlobalMarketState z podaną maską zmiennych")
-        .def(py::init<const std::vector<std::string>&>(), py::arg("variables"))
+        .def(py::init<const std::vector<std::string>&, size_t>(), py::arg("variables"), py::arg("depth_limit") = OrderBook::UNBOUNDED_DEPTH)
         .def("update",
              &GlobalMarketState::update,
              py::arg("entry"),
              "Aktualizuje stan rynkowy na podstawie DifferenceDepthEntry lub TradeEntry")
+        .def("update_batch",
+             [](GlobalMarketState &self, const std::vector<DifferenceDepthEntry> &group) { self.updateBatch(group); },
+             py::arg("group"),
+             "Aktualizuje stan rynkowy całą wiadomością głębokości (wiersze do is_last)")
         .def("count_market_state_metrics_by_entry",
-             &GlobalMarketState::countMarketStateMetricsByEntry,
+             py::overload_cast<DecodedEntry*>(&GlobalMarketState::countMarketStateMetricsByEntry),
              py::arg("entry"),
              "Stara wersja: liczy metryki dla podanego DecodedEntry")
         .def("count_market_state_metrics",
@@ -78,11 +183,17 @@ PYBIND11_MODULE(cpp_binance_orderbook, m) {
             .def("get_market_state_list", &GlobalMarketState::getMarketStateList,
                  "Zwraca listę (symbol, market) dostępnych w GlobalMarketState")
         ;
+    defCheckpoint<GlobalMarketState>(globalMarketStateClass, Checkpoint::Kind::GLOBAL_MARKET_STATE,
+                                     [] { return GlobalMarketState(MetricMask{}); });
 
 
     // ----- MarketState -----
-    py::class_<MS>(m, "MarketState")
+    py::class_<MS> marketStateClass(m, "MarketState");
+    marketStateClass
         .def(py::init<>(), "Tworzy nowy MarketState")
+        .def(py::init<Market, Symbol, size_t>(),
+             py::arg("market"), py::arg("symbol"), py::arg("depth_limit") = OrderBook::UNBOUNDED_DEPTH,
+             "Tworzy MarketState; depth_limit > 0 trzyma w książce tylko tyle poziomów na stronę")
         .def_readonly("order_book", &MS::orderBook, py::return_value_policy::reference_internal)
         .def_readonly("rolling_trade_statistics",
               &MS::rollingTradeStatistics,
@@ -96,6 +207,10 @@ PYBIND11_MODULE(cpp_binance_orderbook, m) {
                  &MS::update,
                  py::arg("entry"),
                  "Aktualizuje stan rynkowy na podstawie DifferenceDepthEntry lub TradeEntry")
+        .def("update_batch",
+                 [](MS &self, const std::vector<DifferenceDepthEntry> &group) { self.updateBatch(group); },
+                 py::arg("group"),
+                 "Aktualizuje stan rynkowy całą wiadomością głębokości (wiersze do is_last)")
         .def("update_orderbook",
              &MS::updateOrderBook,
              py::call_guard<py::gil_scoped_release>(),
@@ -143,10 +258,15 @@ PYBIND11_MODULE(cpp_binance_orderbook, m) {
             &MS::getMarket,
             "Zwraca market tej MarketState"
         );
+    defCheckpoint<MS>(marketStateClass, Checkpoint::Kind::MARKET_STATE, [] { return MS(); });
 
     // ----- OrderBook -----
-    py::class_<OrderBook>(m, "OrderBook")
+    py::class_<OrderBook> orderBookClass(m, "OrderBook");
+    orderBookClass
         .def(py::init<>())
+        .def(py::init([](Symbol symbol, size_t depthLimit) { return OrderBook(symbol, depthLimit); }),
+             py::arg("symbol"), py::arg("depth_limit") = OrderBook::UNBOUNDED_DEPTH)
+        .def("depth_limit",                         &OrderBook::depthLimit, "Levels per side kept in the sorted book (0 = all)")
         .def("print_order_book",                    &OrderBook::printOrderBook)
         .def("asks",                                &OrderBook::getAsks, "Return list of all ask levels in the book, in linked-list order")
         .def("bids",                                &OrderBook::getBids, "Return list of all bid levels in the book, in linked-list order")
@@ -182,44 +302,61 @@ PYBIND11_MODULE(cpp_binance_orderbook, m) {
              &OrderBook::update,
              py::arg("entry"),
              "Apply a single DifferenceDepthEntry update to this order book")
+        .def("load_snapshot",
+             [](OrderBook &self, const std::vector<DifferenceDepthEntry> &levels) { self.loadSnapshot(levels); },
+             py::arg("levels"),
+             "Replace the whole book with a depth snapshot")
+        .def("clear",                               &OrderBook::clear, "Remove every level from the book")
+        .def("apply_batch",
+             [](OrderBook &self, const std::vector<DifferenceDepthEntry> &group) { self.applyBatch(group); },
+             py::arg("group"),
+             "Apply one depth message (rows up to is_last) in a single price-ordered pass")
         ;
+    defCheckpoint<OrderBook>(orderBookClass, Checkpoint::Kind::ORDER_BOOK, [] { return OrderBook(); });
 
     // ----- SingleVariableCounter -----
     auto svc = m.def_submodule("single_variable_counter", "Compute single-variable order book metrics");
-    svc.def("calculate_best_ask_price",                             &SingleVariableCounter::calculateBestAskPrice,                                          py::arg("order_book"));
-    svc.def("calculate_best_bid_price",                             &SingleVariableCounter::calculateBestBidPrice,                                          py::arg("order_book"));
-    svc.def("calculate_mid_price",                                  &SingleVariableCounter::calculateMidPrice,                                              py::arg("order_book"));
-    svc.def("calculate_best_volume_imbalance",                      &SingleVariableCounter::calculateBestVolumeImbalance,                                   py::arg("order_book"));
-    svc.def("calculate_best_n_price_levels_volume_imbalance",       &SingleVariableCounter::calculateBestNPriceLevelsVolumeImbalance,                       py::arg("order_book"), py::arg("nPriceLevels"));
-    svc.def("calculate_volume_imbalance",                           &SingleVariableCounter::calculateVolumeImbalance,                                       py::arg("order_book"));
-    svc.def("calculate_queue_imbalance",                            &SingleVariableCounter::calculateQueueImbalance,                                        py::arg("order_book"));
-    svc.def("calculate_gap",                                        &SingleVariableCounter::calculateGap,                                                   py::arg("order_book"));
-    svc.def("calculate_vwap_deviation",                             &SingleVariableCounter::calculateVwapDeviation,                                         py::arg("order_book"));
+    svc.def("calculate_best_ask_price",                             withContext<OrderBook>(&SingleVariableCounter::calculateBestAskPrice),                                         py::arg("order_book"));
+    svc.def("calculate_best_bid_price",                             withContext<OrderBook>(&SingleVariableCounter::calculateBestBidPrice),                                         py::arg("order_book"));
+    svc.def("calculate_mid_price",                                  withContext<OrderBook>(&SingleVariableCounter::calculateMidPrice),                                             py::arg("order_book"));
+    svc.def("calculate_best_volume_imbalance",                      withContext<OrderBook>(&SingleVariableCounter::calculateBestVolumeImbalance),                                  py::arg("order_book"));
+    svc.def("calculate_best_n_price_levels_volume_imbalance",       withContext<OrderBook>(&SingleVariableCounter::calculateBestNPriceLevelsVolumeImbalance),                      py::arg("order_book"), py::arg("nPriceLevels"));
+    svc.def("calculate_volume_imbalance",                           withContext<OrderBook>(&SingleVariableCounter::calculateVolumeImbalance),                                      py::arg("order_book"));
+    svc.def("calculate_queue_imbalance",                            withContext<OrderBook>(&SingleVariableCounter::calculateQueueImbalance),                                       py::arg("order_book"));
+    svc.def("calculate_gap",                                        withContext<OrderBook>(&SingleVariableCounter::calculateGap),                                                  py::arg("order_book"));
+    svc.def("calculate_vwap_deviation",                             withContext<OrderBook>(&SingleVariableCounter::calculateVwapDeviation),                                        py::arg("order_book"));
     svc.def("calculate_is_aggressor_ask", [](const TradeEntry &t){ return SingleVariableCounter::calculateIsAggressorAsk(&t); },                    py::arg("trade_entry"));
-    svc.def("calculate_simplified_slope_imbalance",                 &SingleVariableCounter::calculateSimplifiedSlopeImbalance,                              py::arg("order_book"));
-
-    svc.def("calculate_trade_count_imbalance",                      &SingleVariableCounter::calculateTradeCountImbalance,                                   py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
-    svc.def("calculate_cumulative_delta",                           &SingleVariableCounter::calculateTradeVolumeDiff,                                       py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
-    svc.def("calculate_price_difference",                           &SingleVariableCounter::calculatePriceDifference,                                       py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
-    svc.def("calculate_rate_of_return",                             &SingleVariableCounter::calculateRateOfReturn,                                          py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
-    svc.def("calculate_difference_depth_volatility_imbalance",      &SingleVariableCounter::calculateDifferenceDepthCountImbalance,                    py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
-
-    svc.def("calculate_rsi",                                        &SingleVariableCounter::calculateRSI,                                                   py::arg("rolling_statistics_data"), py::arg("startWindowTimeSeconds"), py::arg("windowTimeSeconds"));
-    svc.def("calculate_stoch_rsi",                                  &SingleVariableCounter::calculateStochRSI,                                              py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
-    svc.def("calculate_macd",                                       &SingleVariableCounter::calculateMacd,                                                  py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
+    svc.def("calculate_simplified_slope_imbalance",                 withContext<OrderBook>(&SingleVariableCounter::calculateSimplifiedSlopeImbalance),                             py::arg("order_book"));
+
+    svc.def("calculate_trade_count_imbalance",                      withWindowContext<RollingTradeStatistics>(&SingleVariableCounter::calculateTradeCountImbalance),               py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
+    svc.def("calculate_cumulative_delta",                           withWindowContext<RollingTradeStatistics>(&SingleVariableCounter::calculateTradeVolumeDiff),                   py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
+    svc.def("calculate_price_difference",                           withWindowContext<RollingTradeStatistics>(&SingleVariableCounter::calculatePriceDifference),                   py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
+    svc.def("calculate_rate_of_return",                             withWindowContext<RollingTradeStatistics>(&SingleVariableCounter::calculateRateOfReturn),                      py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
+    svc.def("calculate_difference_depth_volatility_imbalance",      withWindowContext<RollingDifferenceDepthStatistics>(&SingleVariableCounter::calculateDifferenceDepthCountImbalance), py::arg("rolling_statistics_data"), py::arg("windowTimeSeconds"));
+
+    static_assert(RollingTradeStatistics::INDICATOR_CANDLE_SECONDS == std::array<int, 2>{2, 5}, "update candleSecondsDoc");
+    const char* candleSecondsDoc = "candle_seconds: candle length of the indicator, 2 or 5 (INDICATOR_CANDLE_SECONDS); other lengths raise RuntimeError";
+    svc.def("calculate_rsi",                                        withContext<RollingTradeStatistics>(&SingleVariableCounter::calculateRSI),                                     py::arg("rolling_statistics_data"), py::arg("candle_seconds"),
+            candleSecondsDoc);
+    svc.def("calculate_stoch_rsi",                                  withContext<RollingTradeStatistics>(&SingleVariableCounter::calculateStochRSI),                                py::arg("rolling_statistics_data"), py::arg("candle_seconds"),
+            candleSecondsDoc);
+    svc.def("calculate_macd",                                       withContext<RollingTradeStatistics>(&SingleVariableCounter::calculateMacd),                                    py::arg("rolling_statistics_data"), py::arg("candle_seconds"),
+            candleSecondsDoc);
 
     // ----- DifferenceDepthEntry (DifferenceDepthEntry) -----
     py::class_<DifferenceDepthEntry>(m, "DifferenceDepthEntry")
         .def(py::init<>())
-        .def(py::init<
-            int64_t,
-            Symbol,
-            bool,
-            double,
-            double,
-            bool,
-            Market
-            >(),
+        .def(py::init([](int64_t timestampOfReceive, Symbol symbol, bool isAsk, double price, double quantity, bool isLast, Market market) {
+                return DifferenceDepthEntry(
+                    timestampOfReceive,
+                    symbol,
+                    isAsk,
+                    priceToTicks(price, symbol),
+                    quantityToLots(quantity, symbol),
+                    isLast,
+                    market
+                );
+            }),
             py::arg("timestamp_of_receive"),
             py::arg("symbol"),
             py::arg("is_ask"),
@@ -229,12 +366,27 @@ PYBIND11_MODULE(cpp_binance_orderbook, m) {
             py::arg("market")
         )
         .def_readwrite("timestamp_of_receive", &DifferenceDepthEntry::timestampOfReceive)
-        .def_readwrite("symbol", &DifferenceDepthEntry::symbol)
+        .def_property("symbol",
+            [](const DifferenceDepthEntry &e) { return e.symbol; },
+            [](DifferenceDepthEntry &e, Symbol symbol) {
+                const double price = ticksToPrice(e.priceTicks, e.symbol);
+                const double quantity = lotsToQuantity(e.quantityLots, e.symbol);
+                e.symbol = symbol;
+                e.priceTicks = priceToTicks(price, symbol);
+                e.quantityLots = quantityToLots(quantity, symbol);
+            })
         .def_readwrite("is_ask", &DifferenceDepthEntry::isAsk)
-        .def_readwrite("price", &DifferenceDepthEntry::price)
-        .def_readwrite("quantity", &DifferenceDepthEntry::quantity)
+        .def_property("price",
+            [](const DifferenceDepthEntry &e) { return ticksToPrice(e.priceTicks, e.symbol); },
+            [](DifferenceDepthEntry &e, double price) { e.priceTicks = priceToTicks(price, e.symbol); })
+        .def_property("quantity",
+            [](const DifferenceDepthEntry &e) { return lotsToQuantity(e.quantityLots, e.symbol); },
+            [](DifferenceDepthEntry &e, double quantity) { e.quantityLots = quantityToLots(quantity, e.symbol); })
+        .def_readwrite("price_ticks", &DifferenceDepthEntry::priceTicks)
+        .def_readwrite("quantity_lots", &DifferenceDepthEntry::quantityLots)
         .def_readwrite("is_last", &DifferenceDepthEntry::isLast)
         .def_readwrite("market", &DifferenceDepthEntry::market)
+        .def_readwrite("is_snapshot", &DifferenceDepthEntry::isSnapshot)
         .def("__str__", [](const DifferenceDepthEntry &entry) {
             std::ostringstream oss;
             // oss << std::fixed << std::setprecision(5);
@@ -242,8 +394,8 @@ PYBIND11_MODULE(cpp_binance_orderbook, m) {
             << "TimestampOfReceive: " << entry.timestampOfReceive << " "
             << "Symbol: " << entry.symbol << " "
             << "IsAsk: " << entry.isAsk << " "
-            << "Price: " << entry.price << " "
-            << "Quantity: " << entry.quantity << " "
+            << "Price: " << ticksToPrice(entry.priceTicks, entry.symbol) << " "
+            << "Quantity: " << lotsToQuantity(entry.quantityLots, entry.symbol) << " "
             << "IsLast: " << entry.isLast << " "
             << "Market_: " << entry.market << " ";
             return oss.str();
@@ -253,8 +405,8 @@ PYBIND11_MODULE(cpp_binance_orderbook, m) {
             v.append(e.timestampOfReceive);
             v.append(e.symbol);
             v.append(e.isAsk ? 1 : 0);
-            v.append(e.price);
-            v.append(e.quantity);
+            v.append(ticksToPrice(e.priceTicks, e.symbol));
+            v.append(lotsToQuantity(e.quantityLots, e.symbol));
             v.append(e.isLast ? 1 : 0);
             v.append(e.market);
             return v;
@@ -335,59 +487,111 @@ PYBIND11_MODULE(cpp_binance_orderbook, m) {
         })
     ;
 
+    // ----- DecodedEntry -----
+    py::class_<DecodedEntry>(m, "DecodedEntry")
+        .def(py::init<const DifferenceDepthEntry&>(), py::arg("entry"))
+        .def(py::init<const TradeEntry&>(), py::arg("entry"))
+        .def_readonly("timestamp_of_receive", &DecodedEntry::timestampOfReceive)
+        .def_readonly("symbol", &DecodedEntry::symbol)
+        .def_readonly("market", &DecodedEntry::market)
+        .def_property_readonly("is_trade", &DecodedEntry::isTrade)
+        .def_property_readonly("is_last", &DecodedEntry::isLast)
+        .def("__str__", [](const DecodedEntry &entry) {
+            std::ostringstream oss;
+            oss << entry;
+            return oss.str();
+        });
+    // update(entry) przyjmuje bezpośrednio DifferenceDepthEntry / TradeEntry
+    py::implicitly_convertible<DifferenceDepthEntry, DecodedEntry>();
+    py::implicitly_convertible<TradeEntry, DecodedEntry>();
+
     // ----- RollingTradeStatistics -----
-    py::class_<RollingTradeStatistics>(m, "RollingTradeStatistics")
+    py::class_<RollingTradeStatistics> rollingTradeStatisticsClass(m, "RollingTradeStatistics");
+    py::class_<RollingTradeStatistics::WindowTotals>(rollingTradeStatisticsClass, "WindowTotals")
+        .def_readonly("buy_trade_count",  &RollingTradeStatistics::WindowTotals::buyTradeCount)
+        .def_readonly("sell_trade_count", &RollingTradeStatistics::WindowTotals::sellTradeCount)
+        .def_readonly("buy_trade_volume", &RollingTradeStatistics::WindowTotals::buyTradeVolume)
+        .def_readonly("sell_trade_volume", &RollingTradeStatistics::WindowTotals::sellTradeVolume)
+        ;
+    rollingTradeStatisticsClass
         .def(py::init<>())
         .def("update",
              &RollingTradeStatistics::update,
              py::arg("trade_entry"),
              "Dodaje nowy TradeEntry do statystyk")
         .def("buy_trade_count",
-             &RollingTradeStatistics::buyTradeCount,
+             inSeconds(&RollingTradeStatistics::buyTradeCount),
              py::arg("windowTimeSeconds"),
              "Liczba kupna w oknie [s]")
         .def("sell_trade_count",
-             &RollingTradeStatistics::sellTradeCount,
+             inSeconds(&RollingTradeStatistics::sellTradeCount),
              py::arg("windowTimeSeconds"),
              "Liczba sprzedaży w oknie [s]")
         .def("buy_trade_volume",
-             &RollingTradeStatistics::buyTradeVolume,
+             inSeconds(&RollingTradeStatistics::buyTradeVolume),
              py::arg("windowTimeSeconds"),
              "Wolumen kupna w oknie [s]")
         .def("sell_trade_volume",
-             &RollingTradeStatistics::sellTradeVolume,
+             inSeconds(&RollingTradeStatistics::sellTradeVolume),
              py::arg("windowTimeSeconds"),
              "Wolumen sprzedaży w oknie [s]")
         .def("price_difference",
-             &RollingTradeStatistics::priceDifference,
+             inSeconds(&RollingTradeStatistics::priceDifference),
              py::arg("windowTimeSeconds"),
              "Różnica ceny w oknie [s]")
         .def("oldest_price",
-             &RollingTradeStatistics::oldestPrice,
+             inSeconds(&RollingTradeStatistics::oldestPrice),
              py::arg("windowTimeSeconds"),
              "Najstarsza cena w oknie [s]")
         .def("simple_moving_average",
-             &RollingTradeStatistics::simpleMovingAverage,
+             inSeconds(&RollingTradeStatistics::simpleMovingAverage),
              py::arg("windowTimeSeconds"),
              "Prosta średnia ruchoma ceny w oknie [s]")
+        .def("window_snapshot",
+             [](const RollingTradeStatistics &self, const std::vector<double> &windows) {
+                 std::vector<RollingTradeStatistics::WindowTotals> out(windows.size());
+                 self.windowSnapshot(windowsMicros(windows), out);
+                 return out;
+             },
+             py::arg("windowsTimeSeconds") = std::vector<double>(RollingTradeStatistics::STANDARD_WINDOWS_SECONDS.begin(),
+                                                                 RollingTradeStatistics::STANDARD_WINDOWS_SECONDS.end()),
+             "Liczby i wolumeny kupna / sprzedaży dla wszystkich okien naraz [s]")
         ;
+    defCheckpoint<RollingTradeStatistics>(rollingTradeStatisticsClass, Checkpoint::Kind::ROLLING_TRADE_STATISTICS,
+                                          [] { return RollingTradeStatistics(); });
 
     // ----- RollingDifferenceDepthStatistics -----
-    py::class_<RollingDifferenceDepthStatistics>(m, "RollingDifferenceDepthStatistics")
+    py::class_<RollingDifferenceDepthStatistics> rollingDifferenceDepthStatisticsClass(m, "RollingDifferenceDepthStatistics");
+    py::class_<RollingDifferenceDepthStatistics::WindowCounts>(rollingDifferenceDepthStatisticsClass, "WindowCounts")
+        .def_readonly("bid_difference_depth_entry_count", &RollingDifferenceDepthStatistics::WindowCounts::bidDifferenceDepthEntryCount)
+        .def_readonly("ask_difference_depth_entry_count", &RollingDifferenceDepthStatistics::WindowCounts::askDifferenceDepthEntryCount)
+        ;
+    rollingDifferenceDepthStatisticsClass
         .def(py::init<>())
         .def("update",
              &RollingDifferenceDepthStatistics::update,
              py::arg("depth_entry"),
              "Dodaje nowy DifferenceDepthEntry do statystyk")
         .def("bid_difference_depth_entry_count",
-             &RollingDifferenceDepthStatistics::bidDifferenceDepthEntryCount,
+             inSeconds(&RollingDifferenceDepthStatistics::bidDifferenceDepthEntryCount),
              py::arg("windowTimeSeconds"),
              "Liczba bid‐entry w oknie [s]")
         .def("ask_difference_depth_entry_count",
-             &RollingDifferenceDepthStatistics::askDifferenceDepthEntryCount,
+             inSeconds(&RollingDifferenceDepthStatistics::askDifferenceDepthEntryCount),
              py::arg("windowTimeSeconds"),
              "Liczba ask‐entry w oknie [s]")
+        .def("window_snapshot",
+             [](const RollingDifferenceDepthStatistics &self, const std::vector<double> &windows) {
+                 std::vector<RollingDifferenceDepthStatistics::WindowCounts> out(windows.size());
+                 self.windowSnapshot(windowsMicros(windows), out);
+                 return out;
+             },
+             py::arg("windowsTimeSeconds") = std::vector<double>(RollingTradeStatistics::STANDARD_WINDOWS_SECONDS.begin(),
+                                                                 RollingTradeStatistics::STANDARD_WINDOWS_SECONDS.end()),
+             "Liczby bid / ask‐entry dla wszystkich okien naraz [s]")
         ;
+    defCheckpoint<RollingDifferenceDepthStatistics>(rollingDifferenceDepthStatisticsClass, Checkpoint::Kind::ROLLING_DIFFERENCE_DEPTH_STATISTICS,
+                                                    [] { return RollingDifferenceDepthStatistics(); });
 
     // ----- OrderBookMetricsEntry -----
     py::class_<OrderBookMetricsEntry>(m, "OrderBookMetricsEntry")
@@ -437,7 +641,7 @@ PYBIND11_MODULE(cpp_binance_orderbook, m) {
         .def(py::init<MetricMask>(), py::arg("mask"))
         .def(py::init<const std::vector<std::string>&>(), py::arg("variables"))
         .def("count_market_state_metrics",
-             &OrderBookMetricsCalculator::countMarketStateMetrics,
+             py::overload_cast<const MarketState&>(&OrderBookMetricsCalculator::countMarketStateMetrics, py::const_),
              py::arg("market_state"),
              "Oblicza OrderBookMetricsEntry dla podanego MarketState i maski");
 
@@ -1,15 +1,11 @@
 #pragma once
 
-#include <variant>
 #include <cstdint>
 #include <stdexcept>
-#include "enums/DifferenceDepthEntry.h"
-#include "enums/TradeEntry.h"
+#include "enums/DecodedEntry.h"
 #include "enums/symbol.h"
 #include "enums/Market.h"
 
-using DecodedEntry = std::variant<DifferenceDepthEntry, TradeEntry>;
-
 struct AssetKey {
     Market market;
     Symbol symbol;
@@ -18,19 +14,9 @@ struct AssetKey {
       : market(m), symbol(s)
     {}
 
-    AssetKey(const DecodedEntry &d) noexcept {
-        if (auto dd = std::get_if<DifferenceDepthEntry>(&d)) {
-            market = dd->market;
-            symbol = dd->symbol;
-        }
-        else if (auto te = std::get_if<TradeEntry>(&d)) {
-            market = te->market;
-            symbol = te->symbol;
-        }
-        else {
-            std::terminate();
-        }
-    }
+    AssetKey(const DecodedEntry &d) noexcept
+      : market(d.market), symbol(d.symbol)
+    {}
 
     bool operator==(const AssetKey &o) const noexcept {
         return market == o.market
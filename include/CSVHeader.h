@@ -2,7 +2,8 @@
 
 #include <array>
 #include <string_view>
-#include <vector>
+
+#include "CSVTokenizer.h"
 
 enum CSVHeader {
     COL_TimestampOfReceiveUS,
@@ -31,6 +32,4 @@ constexpr std::array<std::string_view, COL_COUNT> CSVHeaderFieldNames = {{
 
 using ColMap = std::array<int, COL_COUNT>;
 
-std::vector<std::string_view> splitLineSV(std::string_view line, char delimiter = ',');
-
-ColMap buildColMap(const std::vector<std::string_view>& headerTokens);
+ColMap buildColMap(const CSVFields& headerTokens);
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Appends the offset of every delimiter and newline in text to out, scanning
+// 32 (AVX2) or 16 (SSE2) bytes per step where available, scalar otherwise.
+void scanStructural(std::string_view text, char delimiter, std::vector<uint32_t>& out);
+
+// Fields of one CSV line as views into the indexed text. ends[i] is the offset
+// one past field i (its delimiter or the line terminator).
+class CSVFields {
+public:
+    CSVFields(const char* base, const uint32_t start, const uint32_t* ends, const size_t count)
+        : base_(base), start_(start), ends_(ends), count_(count) {}
+
+    size_t size() const { return count_; }
+
+    std::string_view operator[](const size_t i) const {
+        const uint32_t from = i ? ends_[i - 1] + 1 : start_;
+        return {base_ + from, ends_[i] - from};
+    }
+
+    std::string_view at(const size_t i) const {
+        if (i >= count_) throw std::out_of_range("CSVFields::at: field " + std::to_string(i) + " of " + std::to_string(count_));
+        return (*this)[i];
+    }
+
+    std::string_view line() const { return {base_ + start_, ends_[count_ - 1] - start_}; }
+
+private:
+    const char* base_;
+    uint32_t start_;
+    const uint32_t* ends_;
+    size_t count_;
+};
+
+// Indexes a single line into ends (reused by the caller) and returns its fields.
+inline CSVFields splitFields(const std::string_view line, std::vector<uint32_t>& ends, const char delimiter = ',') {
+    ends.clear();
+    scanStructural(line, delimiter, ends);
+    ends.push_back(static_cast<uint32_t>(line.size()));
+    return {line.data(), 0, ends.data(), ends.size()};
+}
+
+// Structural index of a block of CSV text (at most 4 GiB). Rebuilding reuses the
+// position buffer, so walking lines and fields allocates nothing once warm.
+class CSVIndex {
+public:
+    explicit CSVIndex(const char delimiter = ',') : delimiter_(delimiter) {}
+
+    void build(std::string_view text) {
+        if (text.size() > UINT32_MAX) throw std::runtime_error("CSVIndex: block larger than 4 GiB");
+        text_ = text;
+        positions_.clear();
+        scanStructural(text, delimiter_, positions_);
+        if (!text.empty() && text.back() != '\n') positions_.push_back(static_cast<uint32_t>(text.size()));
+    }
+
+    // Calls f(const CSVFields&) for every line, including empty ones, in order.
+    template <typename F>
+    void forEachLine(F&& f) const {
+        const size_t n = positions_.size();
+        uint32_t lineStart = 0;
+        size_t first = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t p = positions_[i];
+            if (p == text_.size() || text_[p] == '\n') {
+                f(CSVFields(text_.data(), lineStart, positions_.data() + first, i - first + 1));
+                lineStart = p + 1;
+                first = i + 1;
+            }
+        }
+    }
+
+private:
+    char delimiter_;
+    std::string_view text_;
+    std::vector<uint32_t> positions_;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "Checkpoint.h"
+
+// Momentum indicators of the last trade price sampled at fixed-length candles:
+// Wilder-smoothed RSI, StochRSI over the last RSI values and the MACD line of
+// short / long EMAs. The state moves once per closed candle and every read is O(1).
+// A candle without trades closes at the previous close.
+class CandleIndicators {
+public:
+    static constexpr int RSI_PERIODS = 14;
+    static constexpr int STOCH_RSI_PERIODS = 14;
+    static constexpr int MACD_SHORT_PERIODS = 12;
+    static constexpr int MACD_LONG_PERIODS = 26;
+
+    // Candles after which the starting state no longer shows in the values (a replay
+    // started this many candles before a row agrees with a full one to about 1e-9).
+    // A run of this many candles without trades starts the indicators over.
+    static constexpr int64_t WARMUP_CANDLES = 300;
+
+    CandleIndicators() = default;
+    explicit CandleIndicators(int candleSeconds);
+
+    int candleSeconds() const { return static_cast<int>(candleMicros_ / 1'000'000); }
+
+    // Closes every candle that ends at or before timestamp; closePrice is the last
+    // trade price before timestamp.
+    void advanceTo(int64_t timestamp, double closePrice);
+
+    // 50 until RSI_PERIODS price changes have been seen
+    double rsi() const { return rsi_; }
+    // 0 until STOCH_RSI_PERIODS RSI values have been seen
+    double stochRsi() const { return stochRsi_; }
+    double macd() const { return emaShort_ - emaLong_; }
+
+    void saveState(Checkpoint::Writer& w) const;
+    // the checkpoint must hold indicators of the same candle length
+    void loadState(Checkpoint::Reader& r);
+
+private:
+    int64_t candleMicros_{1'000'000};
+    int64_t openCandle_{-1};
+
+    double lastClose_{0.0};
+    bool hasClose_{false};
+
+    int rsiSamples_{0};
+    double averageGain_{0.0};
+    double averageLoss_{0.0};
+    double rsi_{50.0};
+
+    std::array<double, STOCH_RSI_PERIODS> rsiHistory_{};
+    int rsiHistoryNext_{0};
+    bool rsiHistoryFull_{false};
+    double stochRsi_{0.0};
+
+    double emaShort_{0.0};
+    double emaLong_{0.0};
+
+    void closeCandle(double closePrice);
+    void reset();
+};
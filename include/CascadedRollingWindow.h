@@ -0,0 +1,296 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "Checkpoint.h"
+
+// One resolution of a CascadedRollingWindow: a ring of `slots` slots, slotMicros long each.
+struct RollingLevel {
+    int64_t slotMicros;
+    size_t slots;
+};
+
+// 100 ms slots for sub-second windows, 1 s up to 5 min, 1 min up to 1 h and 1 h up to a day
+inline constexpr std::array<RollingLevel, 4> STANDARD_ROLLING_LEVELS{{
+    {100'000, 10},
+    {1'000'000, 301},
+    {60'000'000, 61},
+    {3'600'000'000, 25},
+}};
+
+// Rolling aggregates of an event stream kept at several resolutions at once. Every event
+// lands in the open slot of each level; a window is served by the finest level whose ring
+// still spans it, as that level's open slot plus one running aggregate of its closed
+// slots, so a 200 ms and a 6 h window cost the same. A slot is in the window when it
+// starts at or after now - window, which makes the window edge as fine as the serving
+// level (whole-second windows up to 5 min keep the per-second edges).
+//
+// Slot is a trivially copyable struct that is empty when value-initialised, has a
+// bool hasData member and checkpoints itself through saveState / loadState; Totals
+// aggregates slots through add(const Slot&).
+template <typename Slot, typename Totals, auto Levels = STANDARD_ROLLING_LEVELS>
+class CascadedRollingWindow {
+public:
+    static_assert(std::is_trivially_copyable_v<Slot>);
+    static constexpr size_t LEVEL_COUNT = Levels.size();
+
+    int64_t lastTimestamp() const { return lastTimestamp_; }
+
+    // moves now forward; the slots the rings wrap onto are emptied
+    void advanceTo(int64_t timestamp);
+
+    // apply(slot) on the slot holding timestamp, at every level that still keeps it
+    template <typename Apply>
+    void record(int64_t timestamp, Apply&& apply);
+
+    // the window as the aggregate of its closed slots plus the open slot (nullptr when the
+    // open slot has no data); closed is nullptr when the window does not reach the open slot
+    struct Parts {
+        const Totals* closed = nullptr;
+        const Slot* open = nullptr;
+    };
+    Parts parts(int64_t windowMicros) const;
+
+    Totals totals(int64_t windowMicros) const;
+
+    static constexpr int64_t NO_MAX_AGE = INT64_MAX;
+
+    // newest slot with data that starts at or before now - windowMicros, on the level
+    // serving the window; the open slot counts when the window does not reach past it.
+    // Closed slots starting maxAgeMicros or more before the open one are left out.
+    const Slot* newestAtCutoff(int64_t windowMicros, int64_t maxAgeMicros = NO_MAX_AGE) const;
+    // newest slot with data on the level serving the window
+    const Slot* newest(const int64_t windowMicros, const int64_t maxAgeMicros = NO_MAX_AGE) const {
+        return newestOfAge(levelFor(windowMicros), 0, maxAgeMicros);
+    }
+
+    // events older than this no longer reach windows of up to windowMicros
+    static constexpr int64_t historyMicros(const int64_t windowMicros) {
+        const RollingLevel& level = Levels[levelFor(windowMicros)];
+        return level.slotMicros * static_cast<int64_t>(level.slots);
+    }
+
+    void saveState(Checkpoint::Writer& w) const;
+    void loadState(Checkpoint::Reader& r);
+
+private:
+    static constexpr std::array<size_t, LEVEL_COUNT + 1> OFFSETS = [] {
+        std::array<size_t, LEVEL_COUNT + 1> offsets{};
+        for (size_t level = 0; level < LEVEL_COUNT; ++level) offsets[level + 1] = offsets[level] + Levels[level].slots;
+        return offsets;
+    }();
+    static constexpr size_t TOTAL_SLOTS = OFFSETS[LEVEL_COUNT];
+
+    // where now falls on each level, kept by advanceTo so queries do not divide by the slot length
+    struct OpenSlot {
+        int64_t slotTime = 0;
+        int64_t intoSlot = 0;
+        size_t index = 0;
+    };
+
+    std::array<Slot, TOTAL_SLOTS> slots_{};
+    int64_t lastTimestamp_ = 0;
+    std::array<OpenSlot, LEVEL_COUNT> open_{};
+
+    // closed_[OFFSETS[level] + k] aggregates the k slots before the open one; they only
+    // change when the open slot moves on or a late event lands in a closed slot
+    std::array<Totals, TOTAL_SLOTS> closed_{};
+    // slots_ index of the newest closed slot with data that is at least k slots old, -1 for none
+    std::array<int32_t, TOTAL_SLOTS> newestAtLeast_{};
+
+    // longest window each level serves with its closed slots
+    static constexpr std::array<int64_t, LEVEL_COUNT> SPANS = [] {
+        std::array<int64_t, LEVEL_COUNT> spans{};
+        for (size_t level = 0; level < LEVEL_COUNT; ++level) {
+            spans[level] = Levels[level].slotMicros * static_cast<int64_t>(Levels[level].slots - 1);
+        }
+        return spans;
+    }();
+
+    static constexpr size_t levelFor(const int64_t windowMicros) {
+        for (size_t level = 0; level + 1 < LEVEL_COUNT; ++level) {
+            if (windowMicros <= SPANS[level]) return level;
+        }
+        return LEVEL_COUNT - 1;
+    }
+
+    // f(std::integral_constant<size_t, level>), so the level's slot length and ring size are
+    // compile-time constants inside f and divisions by them compile to multiplications
+    template <typename F>
+    static auto onLevel(const size_t level, F&& f) {
+        return [&]<size_t... L>(std::index_sequence<L...>) {
+            std::invoke_result_t<F, std::integral_constant<size_t, 0>> result{};
+            ((level == L && (result = f(std::integral_constant<size_t, L>{}), true)) || ...);
+            return result;
+        }(std::make_index_sequence<LEVEL_COUNT>{});
+    }
+
+    static int64_t slotsIn(const size_t level, const int64_t micros) {
+        return onLevel(level, [micros](auto L) { return micros / Levels[L].slotMicros; });
+    }
+
+    static size_t ringIndex(const size_t level, const int64_t slotTime) {
+        return onLevel(level, [slotTime](auto L) { return OFFSETS[L] + static_cast<size_t>(slotTime) % Levels[L].slots; });
+    }
+
+    void moveOpenSlots() {
+        for (size_t level = 0; level < LEVEL_COUNT; ++level) {
+            OpenSlot& open = open_[level];
+            open.slotTime = slotsIn(level, lastTimestamp_);
+            open.intoSlot = lastTimestamp_ - open.slotTime * Levels[level].slotMicros;
+            open.index = ringIndex(level, open.slotTime);
+        }
+    }
+
+    // age < slots of the level
+    const Slot* slotOfAge(const size_t level, const int64_t age) const {
+        const OpenSlot& open = open_[level];
+        if (open.slotTime < age) return nullptr;
+        size_t index = open.index - static_cast<size_t>(age);
+        if (index < OFFSETS[level] || index > open.index) index += Levels[level].slots;
+        const Slot& slot = slots_[index];
+        return slot.hasData ? &slot : nullptr;
+    }
+
+    const Slot* newestOfAge(size_t level, int64_t age, int64_t maxAgeMicros) const;
+    void rebuildLevel(size_t level);
+};
+
+template <typename Slot, typename Totals, auto Levels>
+void CascadedRollingWindow<Slot, Totals, Levels>::advanceTo(const int64_t timestamp) {
+    if (timestamp <= lastTimestamp_) return;
+    const std::array<OpenSlot, LEVEL_COUNT> previous = open_;
+    lastTimestamp_ = timestamp;
+    moveOpenSlots();
+
+    for (size_t level = 0; level < LEVEL_COUNT; ++level) {
+        const int64_t newSlot = open_[level].slotTime;
+        const int64_t moved = newSlot - previous[level].slotTime;
+        if (moved == 0) continue;
+
+        const int64_t toClear = std::min(moved, static_cast<int64_t>(Levels[level].slots));
+        for (int64_t slotTime = newSlot - toClear + 1; slotTime <= newSlot; ++slotTime) {
+            slots_[ringIndex(level, slotTime)] = Slot{};
+        }
+        rebuildLevel(level);
+    }
+}
+
+template <typename Slot, typename Totals, auto Levels>
+template <typename Apply>
+void CascadedRollingWindow<Slot, Totals, Levels>::record(const int64_t timestamp, Apply&& apply) {
+    for (size_t level = 0; level < LEVEL_COUNT; ++level) {
+        const int64_t slotTime = slotsIn(level, timestamp);
+        const int64_t age = open_[level].slotTime - slotTime;
+        if (age < 0 || age >= static_cast<int64_t>(Levels[level].slots)) continue;
+
+        Slot& slot = slots_[age == 0 ? open_[level].index : ringIndex(level, slotTime)];
+        apply(slot);
+        slot.hasData = true;
+        // a late event landed in a closed slot
+        if (age > 0) rebuildLevel(level);
+    }
+}
+
+template <typename Slot, typename Totals, auto Levels>
+void CascadedRollingWindow<Slot, Totals, Levels>::rebuildLevel(const size_t level) {
+    const size_t offset = OFFSETS[level];
+    const auto slots = static_cast<int64_t>(Levels[level].slots);
+
+    Totals running{};
+    closed_[offset] = running;
+    for (int64_t age = 1; age < slots; ++age) {
+        if (const Slot* slot = slotOfAge(level, age)) running.add(*slot);
+        closed_[offset + age] = running;
+    }
+
+    int32_t newest = -1;
+    for (int64_t age = slots - 1; age >= 1; --age) {
+        if (const Slot* slot = slotOfAge(level, age)) newest = static_cast<int32_t>(slot - slots_.data());
+        newestAtLeast_[offset + age] = newest;
+    }
+}
+
+template <typename Slot, typename Totals, auto Levels>
+typename CascadedRollingWindow<Slot, Totals, Levels>::Parts
+CascadedRollingWindow<Slot, Totals, Levels>::parts(const int64_t windowMicros) const {
+    if (lastTimestamp_ == 0) return {};
+
+    const size_t level = levelFor(windowMicros);
+    const OpenSlot& open = open_[level];
+    const int64_t sinceOpen = windowMicros - open.intoSlot;
+    if (sinceOpen < 0) return {};
+
+    const int64_t reached = std::min(slotsIn(level, sinceOpen), static_cast<int64_t>(Levels[level].slots) - 1);
+    const Slot& openSlot = slots_[open.index];
+    return {&closed_[OFFSETS[level] + reached], openSlot.hasData ? &openSlot : nullptr};
+}
+
+template <typename Slot, typename Totals, auto Levels>
+Totals CascadedRollingWindow<Slot, Totals, Levels>::totals(const int64_t windowMicros) const {
+    const auto [closed, open] = parts(windowMicros);
+    if (!closed) return {};
+
+    Totals totals = *closed;
+    if (open) totals.add(*open);
+    return totals;
+}
+
+template <typename Slot, typename Totals, auto Levels>
+const Slot* CascadedRollingWindow<Slot, Totals, Levels>::newestAtCutoff(const int64_t windowMicros, const int64_t maxAgeMicros) const {
+    if (lastTimestamp_ == 0) return nullptr;
+
+    const size_t level = levelFor(windowMicros);
+    const int64_t sinceOpen = windowMicros - open_[level].intoSlot;
+    return newestOfAge(level, sinceOpen <= 0 ? 0 : slotsIn(level, sinceOpen + Levels[level].slotMicros - 1), maxAgeMicros);
+}
+
+template <typename Slot, typename Totals, auto Levels>
+const Slot* CascadedRollingWindow<Slot, Totals, Levels>::newestOfAge(const size_t level, int64_t age, const int64_t maxAgeMicros) const {
+    if (lastTimestamp_ == 0) return nullptr;
+    if (age == 0) {
+        if (const Slot& open = slots_[open_[level].index]; open.hasData) return &open;
+        age = 1;
+    }
+    const auto slots = static_cast<int64_t>(Levels[level].slots);
+    // ages below reach start less than maxAgeMicros before the open slot
+    const int64_t slotMicros = Levels[level].slotMicros;
+    const int64_t reach = maxAgeMicros >= slotMicros * slots ? slots : slotsIn(level, maxAgeMicros + slotMicros - 1);
+    if (age >= reach) return nullptr;
+
+    const int32_t newest = newestAtLeast_[OFFSETS[level] + age];
+    if (newest < 0) return nullptr;
+    if (reach < slots) {
+        const auto openPosition = static_cast<int64_t>(open_[level].index - OFFSETS[level]);
+        const auto position = static_cast<int64_t>(newest - OFFSETS[level]);
+        if ((openPosition - position + slots) % slots >= reach) return nullptr;
+    }
+    return &slots_[newest];
+}
+
+template <typename Slot, typename Totals, auto Levels>
+void CascadedRollingWindow<Slot, Totals, Levels>::saveState(Checkpoint::Writer& w) const {
+    for (const RollingLevel& level : Levels) {
+        w.write(level.slotMicros);
+        w.write<uint64_t>(level.slots);
+    }
+    for (const Slot& slot : slots_) slot.saveState(w);
+    w.write(lastTimestamp_);
+}
+
+template <typename Slot, typename Totals, auto Levels>
+void CascadedRollingWindow<Slot, Totals, Levels>::loadState(Checkpoint::Reader& r) {
+    for (const RollingLevel& level : Levels) {
+        const auto slotMicros = r.read<int64_t>();
+        if (slotMicros != level.slotMicros || r.read<uint64_t>() != level.slots) {
+            throw std::runtime_error("CascadedRollingWindow checkpoint layout mismatch");
+        }
+    }
+    for (Slot& slot : slots_) slot.loadState(r);
+    lastTimestamp_ = r.read<int64_t>();
+    moveOpenSlots();
+    for (size_t level = 0; level < LEVEL_COUNT; ++level) rebuildLevel(level);
+}
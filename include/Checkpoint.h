@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Versioned binary format used to checkpoint replay state. Every blob
+// starts with a header naming the kind of object it holds, so a MarketState
+// checkpoint cannot be restored into an OrderBook by mistake.
+namespace Checkpoint {
+
+    inline constexpr char MAGIC[4] = {'O', 'B', 'C', 'P'};
+    inline constexpr uint16_t VERSION = 4;
+
+    enum class Kind : uint16_t {
+        ORDER_BOOK = 1,
+        ROLLING_TRADE_STATISTICS = 2,
+        ROLLING_DIFFERENCE_DEPTH_STATISTICS = 3,
+        MARKET_STATE = 4,
+        GLOBAL_MARKET_STATE = 5
+    };
+
+    // values copied byte for byte: no padding bytes and no bool, whose other byte values
+    // cannot be read back; structs are written field by field
+    template <typename T>
+    inline constexpr bool IS_RAW = std::is_floating_point_v<T>
+        || (std::has_unique_object_representations_v<T> && !std::is_same_v<T, bool>);
+
+    class Writer {
+    public:
+        explicit Writer(std::vector<char>& out) : out_(out) {}
+
+        template <typename T>
+        void write(const T& value) {
+            static_assert(IS_RAW<T>);
+            writeBytes(&value, sizeof(T));
+        }
+
+        void writeBool(const bool value) { write<uint8_t>(value ? 1 : 0); }
+
+        template <typename T>
+        void writeArray(std::span<const T> values) {
+            static_assert(IS_RAW<T>);
+            write<uint64_t>(values.size());
+            writeBytes(values.data(), values.size_bytes());
+        }
+
+        void writeBytes(const void* data, const size_t size) {
+            const auto *bytes = static_cast<const char*>(data);
+            out_.insert(out_.end(), bytes, bytes + size);
+        }
+
+    private:
+        std::vector<char>& out_;
+    };
+
+    class Reader {
+    public:
+        explicit Reader(std::span<const char> in) : p_(in.data()), end_(in.data() + in.size()) {}
+
+        template <typename T>
+        T read() {
+            static_assert(IS_RAW<T>);
+            T value;
+            readBytes(&value, sizeof(T));
+            return value;
+        }
+
+        bool readBool() {
+            const auto value = read<uint8_t>();
+            if (value > 1) throw std::runtime_error("Checkpoint holds an invalid bool");
+            return value == 1;
+        }
+
+        template <typename T>
+        std::vector<T> readArray() {
+            static_assert(IS_RAW<T>);
+            const auto count = read<uint64_t>();
+            if (count > static_cast<uint64_t>(end_ - p_) / sizeof(T)) throw std::runtime_error("Checkpoint is truncated");
+            std::vector<T> values(count);
+            readBytes(values.data(), count * sizeof(T));
+            return values;
+        }
+
+        void readBytes(void* data, const size_t size) {
+            if (static_cast<size_t>(end_ - p_) < size) throw std::runtime_error("Checkpoint is truncated");
+            std::memcpy(data, p_, size);
+            p_ += size;
+        }
+
+        bool atEnd() const { return p_ == end_; }
+
+    private:
+        const char* p_;
+        const char* end_;
+    };
+
+    inline void writeHeader(Writer& w, const Kind kind) {
+        w.writeBytes(MAGIC, sizeof(MAGIC));
+        w.write(VERSION);
+        w.write(kind);
+    }
+
+    inline void readHeader(Reader& r, const Kind kind) {
+        char magic[4];
+        r.readBytes(magic, sizeof(magic));
+        if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) throw std::runtime_error("Not an order book checkpoint");
+        if (r.read<uint16_t>() != VERSION) throw std::runtime_error("Unsupported checkpoint version");
+        if (r.read<Kind>() != kind) throw std::runtime_error("Checkpoint holds a different kind of object");
+    }
+
+    // T provides saveState(Writer&) const and loadState(Reader&).
+    template <typename T>
+    std::vector<char> save(const T& object, const Kind kind) {
+        std::vector<char> out;
+        Writer w(out);
+        writeHeader(w, kind);
+        object.saveState(w);
+        return out;
+    }
+
+    template <typename T>
+    void load(T& object, const std::span<const char> bytes, const Kind kind) {
+        Reader r(bytes);
+        readHeader(r, kind);
+        object.loadState(r);
+        if (!r.atEnd()) throw std::runtime_error("Checkpoint has trailing bytes");
+    }
+
+    inline void writeFile(const std::string& path, const std::vector<char>& bytes) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) throw std::runtime_error("Cannot open checkpoint file: " + path);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file) throw std::runtime_error("Cannot write checkpoint file: " + path);
+    }
+}
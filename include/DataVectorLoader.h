@@ -15,4 +15,7 @@ public:
 
     static std::vector<DecodedEntry> getEntriesFromMultiAssetParametersCSV(const std::string &csvPath);
 
+    // Raw snapshot / difference depth / trade files merged by TimestampOfReceiveUS.
+    static std::vector<DecodedEntry> getEntriesFromSingleAssetParametersCSVs(const std::vector<std::string> &csvPaths);
+
 };
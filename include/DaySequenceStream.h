@@ -0,0 +1,42 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "EntryStream.h"
+
+// Replays an ordered list of day files (merged CSV, EventFile or EventArchive,
+// mixed freely) as one continuous stream, so a single GlobalMarketState carries
+// books and rolling windows across midnight. While day N is being consumed, day
+// N+1 is opened and its first chunk decoded on a background thread.
+class DaySequenceStream {
+public:
+    using ChunkSource = std::function<bool(std::vector<DecodedEntry>&)>;
+
+    explicit DaySequenceStream(std::vector<std::string> dayPaths, size_t decodeThreads = EntryStream::defaultDecodeThreads());
+
+    DaySequenceStream(DaySequenceStream&&) = default;
+    DaySequenceStream& operator=(DaySequenceStream&&) = delete;
+
+    // Same contract as EntryStream::next; a chunk never spans two days.
+    bool next(std::vector<DecodedEntry>& chunk);
+
+private:
+    struct OpenedDay {
+        ChunkSource source;
+        std::vector<DecodedEntry> firstChunk;
+        bool hasFirstChunk{false};
+    };
+
+    static OpenedDay openDay(const std::string& path, size_t decodeThreads);
+
+    void prefetch();
+
+    std::vector<std::string> dayPaths_;
+    size_t decodeThreads_;
+    size_t nextDay_{0};
+    OpenedDay current_;
+    std::future<OpenedDay> prefetched_;
+};
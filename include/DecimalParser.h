@@ -0,0 +1,170 @@
+#pragma once
+
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+#include "FixedPoint.h"
+#include "enums/ParseStatus.h"
+
+// Parsers for the short unsigned fixed-point decimals, microsecond timestamps and
+// 0/1 flags of Binance CSVs. Runs of eight digits are converted at once (SWAR) and
+// failures come back as a ParseStatus, so a malformed field never throws.
+
+// value = (negative ? -1 : 1) * mantissa * 10^-scale, exactly as written in the text
+struct Decimal {
+    uint64_t mantissa{0};
+    int32_t scale{0};
+    bool negative{false};
+};
+
+namespace decimal_detail {
+
+    inline uint64_t load8(const char* p) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+
+    inline bool isEightDigits(const uint64_t v) {
+        return ((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+    }
+
+    inline uint32_t parseEightDigits(uint64_t v) {
+        v = (v & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+        v = (v & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+        return static_cast<uint32_t>((v & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32);
+    }
+
+    // Appends the digits at p to mantissa; digits counts everything accumulated so
+    // far, and up to 19 of them always fit in 64 bits.
+    inline const char* consumeDigits(const char* p, const char* const end, uint64_t& mantissa, int& digits, ParseStatus& status) {
+        if constexpr (std::endian::native == std::endian::little) {
+            while (end - p >= 8 && digits <= 11 && isEightDigits(load8(p))) {
+                mantissa = mantissa * 100'000'000 + parseEightDigits(load8(p));
+                digits += 8;
+                p += 8;
+            }
+        }
+        for (; p != end && static_cast<unsigned char>(*p - '0') <= 9; ++p) {
+            const auto d = static_cast<uint64_t>(*p - '0');
+            if (mantissa > (std::numeric_limits<uint64_t>::max() - d) / 10) {
+                status = ParseStatus::OUT_OF_RANGE;
+                return p;
+            }
+            mantissa = mantissa * 10 + d;
+            ++digits;
+        }
+        return p;
+    }
+
+    template <int K>
+    inline bool divideExact(uint64_t& m) {
+        constexpr auto divisor = static_cast<uint64_t>(POW10[K]);
+        if (m % divisor) return false;
+        m /= divisor;
+        return true;
+    }
+}
+
+inline ParseStatus parseDecimal(const std::string_view sv, Decimal& out) {
+    const char* p = sv.data();
+    const char* const end = p + sv.size();
+    out = {};
+    if (p == end) return ParseStatus::EMPTY_FIELD;
+
+    out.negative = *p == '-';
+    p += (*p == '-') | (*p == '+');
+
+    ParseStatus status = ParseStatus::OK;
+    int digits = 0;
+    const char* const integerStart = p;
+    p = decimal_detail::consumeDigits(p, end, out.mantissa, digits, status);
+    bool anyDigit = p != integerStart;
+
+    if (p != end && *p == '.' && status == ParseStatus::OK) {
+        const char* const fractionStart = ++p;
+        p = decimal_detail::consumeDigits(p, end, out.mantissa, digits, status);
+        out.scale = static_cast<int32_t>(p - fractionStart);
+        anyDigit |= p != fractionStart;
+    }
+    if (status != ParseStatus::OK) return status;
+    if (!anyDigit) return ParseStatus::INVALID_CHARACTER;
+
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        const bool negativeExponent = p != end && *p == '-';
+        p += p != end && (*p == '-' || *p == '+');
+        int exponent = 0;
+        const char* const exponentStart = p;
+        for (; p != end && static_cast<unsigned char>(*p - '0') <= 9 && exponent < 10'000; ++p) exponent = exponent * 10 + (*p - '0');
+        if (p == exponentStart) return ParseStatus::INVALID_CHARACTER;
+        out.scale += negativeExponent ? exponent : -exponent;
+    }
+    return p == end ? ParseStatus::OK : ParseStatus::INVALID_CHARACTER;
+}
+
+// Rescales a parsed decimal to an integer count of 10^-decimals units.
+inline ParseStatus decimalToFixed(const Decimal& d, const uint8_t decimals, int64_t& out) {
+    uint64_t m = d.mantissa;
+    const int shift = decimals - d.scale;
+    if (shift < 0 && m != 0) {
+        bool exact;
+        switch (-shift) {
+            case 1:  exact = decimal_detail::divideExact<1>(m);  break;
+            case 2:  exact = decimal_detail::divideExact<2>(m);  break;
+            case 3:  exact = decimal_detail::divideExact<3>(m);  break;
+            case 4:  exact = decimal_detail::divideExact<4>(m);  break;
+            case 5:  exact = decimal_detail::divideExact<5>(m);  break;
+            case 6:  exact = decimal_detail::divideExact<6>(m);  break;
+            case 7:  exact = decimal_detail::divideExact<7>(m);  break;
+            case 8:  exact = decimal_detail::divideExact<8>(m);  break;
+            default: exact = -shift < static_cast<int>(POW10.size()) && m % static_cast<uint64_t>(POW10[-shift]) == 0;
+                     if (exact) m /= static_cast<uint64_t>(POW10[-shift]);
+        }
+        if (!exact) return ParseStatus::OFF_GRID;
+    } else if (shift > 0 && m != 0) {
+        if (shift >= static_cast<int>(POW10.size()) || m > static_cast<uint64_t>(std::numeric_limits<int64_t>::max() / POW10[shift]))
+            return ParseStatus::OUT_OF_RANGE;
+        m *= static_cast<uint64_t>(POW10[shift]);
+    }
+    if (m > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) return ParseStatus::OUT_OF_RANGE;
+    out = d.negative ? -static_cast<int64_t>(m) : static_cast<int64_t>(m);
+    return ParseStatus::OK;
+}
+
+// Correctly rounded double of a parsed decimal: one exact IEEE division or
+// multiplication while the mantissa fits 53 bits, from_chars on the text otherwise.
+inline double decimalToDouble(const Decimal& d, const std::string_view text) {
+    static constexpr double EXACT_POW10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    double value;
+    if (d.mantissa <= (uint64_t{1} << 53) && d.scale >= -22 && d.scale <= 22) {
+        value = d.scale >= 0
+            ? static_cast<double>(d.mantissa) / EXACT_POW10[d.scale]
+            : static_cast<double>(d.mantissa) * EXACT_POW10[-d.scale];
+    } else {
+        value = 0.0;
+        std::from_chars(text.data() + (text.front() == '+'), text.data() + text.size(), value);
+        return value;
+    }
+    return d.negative ? -value : value;
+}
+
+inline ParseStatus parseInteger(const std::string_view sv, int64_t& out) {
+    Decimal d;
+    const ParseStatus status = parseDecimal(sv, d);
+    if (status != ParseStatus::OK) return status;
+    return decimalToFixed(d, 0, out);
+}
+
+// "1" is true; "0", an empty field or anything else is false.
+inline bool parseFlag(const std::string_view sv) {
+    const char c = sv.size() == 1 ? sv[0] : '\0';
+    return c == '1';
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "enums/Market.h"
+
+// Levels of one side that fall outside a bounded book's tracked depth. Lookups
+// go through a hash map; the best key is found through a lazily pruned min-heap,
+// so promoting a level into the book never needs a sorted structure.
+class DepthOverflow {
+public:
+    struct Level {
+        int64_t quantityLots;
+        int64_t timestampOfReceive;
+        Market market;
+    };
+
+    Level* find(const int64_t key) {
+        const auto it = levels_.find(key);
+        return it == levels_.end() ? nullptr : &it->second;
+    }
+
+    void insert(const int64_t key, const Level& level) {
+        levels_.insert_or_assign(key, level);
+        heap_.push_back(key);
+        std::ranges::push_heap(heap_, std::greater<>{});
+        if (heap_.size() > 2 * levels_.size() + 64) rebuildHeap();
+    }
+
+    void erase(const int64_t key) { levels_.erase(key); }
+
+    bool empty() const { return levels_.empty(); }
+    size_t size() const { return levels_.size(); }
+
+    // precondition: !empty()
+    std::pair<int64_t, Level> popBest() {
+        while (true) {
+            std::ranges::pop_heap(heap_, std::greater<>{});
+            const int64_t key = heap_.back();
+            heap_.pop_back();
+            const auto it = levels_.find(key);
+            if (it != levels_.end()) {
+                std::pair<int64_t, Level> best{key, it->second};
+                levels_.erase(it);
+                return best;
+            }
+        }
+    }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        for (const auto& [key, level] : levels_) f(key, level);
+    }
+
+    void clear() {
+        levels_.clear();
+        heap_.clear();
+    }
+
+private:
+    std::unordered_map<int64_t, Level> levels_;
+    std::vector<int64_t> heap_;
+
+    void rebuildHeap() {
+        heap_.clear();
+        for (const auto& [key, level] : levels_) heap_.push_back(key);
+        std::ranges::make_heap(heap_, std::greater<>{});
+    }
+};
@@ -1,21 +1,59 @@
 #pragma once
 
-#include <variant>
 #include <string_view>
 #include <array>
+#include <string>
+#include <vector>
 
 #include "CSVHeader.h"
+#include "CSVTokenizer.h"
 #include "enums/AssetParameters.h"
-#include "enums/DifferenceDepthEntry.h"
-#include "enums/TradeEntry.h"
+#include "enums/DecodedEntry.h"
+#include "enums/ParseStatus.h"
 
 using ColMap = std::array<int, COL_COUNT>;
 
-using DecodedEntry = std::variant<DifferenceDepthEntry, TradeEntry>;
+struct DecodePlan;
+
+using RowDecoder = ParseStatus (*)(const DecodePlan&, const CSVFields&, DecodedEntry&, std::string_view*);
+using LinesDecoder = void (*)(const DecodePlan&, const CSVIndex&, std::vector<DecodedEntry>&, std::vector<std::string>&);
+
+// What is fixed for a whole file, resolved once before its first line: the
+// single-asset stream type / market / symbol, or the multi-asset column positions
+// (with the field counts a row needs). decodeRow / decodeLines are specialised
+// for that layout, so the per-line work has no layout switches or lookups left.
+struct DecodePlan {
+    StreamType streamType{StreamType::UNKNOWN};
+    Market market{Market::UNKNOWN};
+    Symbol symbol{Symbol::UNKNOWN};
+    std::string symbolName;
+
+    ColMap columns{};
+    size_t commonFields{0};
+    size_t tradeFields{0};
+    size_t depthFields{0};
+
+    RowDecoder decodeRow{nullptr};
+    LinesDecoder decodeLines{nullptr};
+};
 
 class EntryDecoder {
 public:
-    static DecodedEntry decodeSingleAssetParameterEntry(const AssetParameters &params, std::string_view line);
+    static DecodePlan planSingleAssetParameters(const AssetParameters &params);
+
+    static DecodePlan planMultiAssetParameters(const ColMap &colMap);
+
+    // Decodes every non-empty, non-comment line of index into entries; lines that
+    // fail are reported in errors as "Error processing line: ...".
+    static void decodeLines(const DecodePlan &plan, const CSVIndex &index, std::vector<DecodedEntry> &entries, std::vector<std::string> &errors);
+
+    // Non-throwing decode of one row with a plan built once per file: returns the first
+    // failure and, when failedField is given, the field that caused it. out is only
+    // valid on ParseStatus::OK.
+    static ParseStatus tryDecodeEntry(const DecodePlan &plan, const CSVFields& tokens,
+                                      DecodedEntry& out, std::string_view* failedField = nullptr);
+
+    static std::string describeFailure(ParseStatus status, std::string_view field);
 
-    static DecodedEntry decodeMultiAssetParameterEntry(std::string_view line, const ColMap& colMap);
+    static DecodedEntry decodeEntry(const DecodePlan &plan, std::string_view line);
 };
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <deque>
+#include <future>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "EntryDecoder.h"
+#include "MMapData.h"
+
+// Decodes a CSV front to back in newline-aligned slices of about chunkBytes, so a
+// replay only ever holds a few slices of decoded rows instead of the whole day.
+// Up to decodeThreads slices are decoded ahead on worker threads while the caller
+// replays the current one; slices are always handed over in file order.
+// decodeThreads == 0 decodes on the calling thread.
+class EntryStream {
+public:
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 4 << 20;
+
+    static size_t defaultDecodeThreads();
+
+    static EntryStream openMultiAssetParametersCSV(const std::string& csvPath,
+                                                   size_t decodeThreads = defaultDecodeThreads(),
+                                                   size_t chunkBytes = DEFAULT_CHUNK_BYTES);
+
+    static EntryStream openSingleAssetParametersCSV(const std::string& csvPath,
+                                                    size_t decodeThreads = defaultDecodeThreads(),
+                                                    size_t chunkBytes = DEFAULT_CHUNK_BYTES);
+
+    EntryStream(EntryStream&&) = default;
+    EntryStream& operator=(EntryStream&&) = delete;
+
+    // Replaces chunk with the next decoded rows; false once the file is exhausted.
+    // The buffer handed in is recycled for slices decoded later.
+    bool next(std::vector<DecodedEntry>& chunk);
+
+    // Decodes only the line-aligned bytes [begin, end) of the file (see TimestampIndex);
+    // must be called before the first next().
+    void restrictToByteRange(size_t begin, size_t end);
+
+private:
+    struct DecodedSlice {
+        std::vector<DecodedEntry> entries;
+        std::vector<std::string> errors;
+        size_t end;
+        CSVIndex index;
+    };
+
+    EntryStream(const std::string& csvPath, size_t decodeThreads, size_t chunkBytes);
+
+    std::string_view nextLine();
+    void launch();
+
+    MMapData file_;
+    size_t pos_{0};
+    size_t end_;
+    size_t chunkBytes_;
+    size_t decodeThreads_;
+    DecodePlan plan_;
+
+    std::vector<std::vector<DecodedEntry>> spare_;
+    // structural indexes of finished slices, handed to the next launches with the buffers
+    std::vector<CSVIndex> spareIndexes_;
+    std::deque<std::future<DecodedSlice>> inFlight_;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "EntryDecoder.h"
+#include "MMapData.h"
+
+// Dense long-term storage for a decoded event stream. Rows are grouped into
+// independently decodable blocks; inside a block every field is its own byte
+// stream: timestamps as zig-zag varint deltas, (symbol, market, stream type) as
+// runs, each flag column as run lengths (or a bitmap when that is shorter), depth
+// prices as tick deltas from the previous level on the same side, quantities as
+// varint lots. Trade prices / quantities are kept as ticks / lots too when that
+// round-trips exactly, raw doubles otherwise.
+// A block index at the end of the file gives offsets and timestamp ranges.
+class EventArchive {
+public:
+    static constexpr char MAGIC[4] = {'O', 'B', 'E', 'A'};
+    static constexpr uint16_t VERSION = 2;
+    static constexpr uint32_t DEFAULT_BLOCK_ROWS = 1 << 16;
+
+    struct Header {
+        char magic[4];
+        uint16_t version;
+        uint16_t reserved;
+        uint32_t blockRows;
+        uint32_t blockCount;
+        uint64_t rowCount;
+        uint64_t indexOffset;
+    };
+
+    struct BlockInfo {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t rowCount;
+        int64_t firstTimestampOfReceive;
+        int64_t lastTimestampOfReceive;
+    };
+
+    using ChunkSource = std::function<bool(std::vector<DecodedEntry>&)>;
+
+    // Encodes everything source yields (EntryStream::next / EventFile::next shaped).
+    static void write(const ChunkSource& source, const std::string& outPath, uint32_t blockRows = DEFAULT_BLOCK_ROWS);
+
+    static void convertMultiAssetParametersCSV(const std::string& csvPath, const std::string& outPath);
+
+    static void convertSingleAssetParametersCSV(const std::string& csvPath, const std::string& outPath);
+
+    static bool isEventArchive(const std::string& path);
+
+    explicit EventArchive(const std::string& path);
+
+    size_t size() const { return rowCount_; }
+
+    const std::vector<BlockInfo>& blocks() const { return blocks_; }
+
+    // First block that may hold rows at or after timestampOfReceive.
+    size_t findBlock(int64_t timestampOfReceive) const;
+
+    void decodeBlock(size_t block, std::vector<DecodedEntry>& out) const;
+
+    // One block per call, in file order; same contract as EntryStream::next.
+    bool next(std::vector<DecodedEntry>& chunk);
+
+    void seek(const size_t block) { nextBlock_ = block; }
+
+private:
+    MMapData file_;
+    size_t rowCount_{0};
+    std::vector<BlockInfo> blocks_;
+    size_t nextBlock_{0};
+};
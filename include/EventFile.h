@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "EntryDecoder.h"
+#include "MMapData.h"
+
+// Binary columnar form of a decoded event stream. A fixed header (magic, version,
+// row count and one descriptor per column) is followed by one contiguous,
+// 64-byte aligned array per column, so a loaded file is just typed views into
+// the mapping. Depth rows keep priceTicks / quantityLots in the price / quantity
+// columns; trade rows keep the bits of their double price / quantity there. The
+// flags column holds DecodedEntry::Flag bits.
+class EventFile {
+public:
+    static constexpr char MAGIC[4] = {'O', 'B', 'E', 'V'};
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t DEFAULT_CHUNK_ROWS = 1 << 16;
+
+    enum class Column : uint16_t {
+        TIMESTAMP_OF_RECEIVE,
+        PRICE,
+        QUANTITY,
+        SYMBOL,
+        MARKET,
+        STREAM_TYPE,
+        FLAGS,
+        COUNT
+    };
+
+    struct ColumnInfo {
+        uint16_t column;
+        uint16_t width;
+        uint32_t reserved;
+        uint64_t offset;
+    };
+
+    struct Header {
+        char magic[4];
+        uint16_t version;
+        uint16_t columnCount;
+        uint64_t rowCount;
+        uint64_t capacity;
+        ColumnInfo columns[static_cast<size_t>(Column::COUNT)];
+    };
+
+    static void convertMultiAssetParametersCSV(const std::string& csvPath, const std::string& outPath);
+
+    static void convertSingleAssetParametersCSV(const std::string& csvPath, const std::string& outPath);
+
+    static bool isEventFile(const std::string& path);
+
+    explicit EventFile(const std::string& path, size_t chunkRows = DEFAULT_CHUNK_ROWS);
+
+    size_t size() const { return rowCount_; }
+
+    std::span<const int64_t> timestampsOfReceive() const { return column<int64_t>(Column::TIMESTAMP_OF_RECEIVE); }
+    std::span<const int64_t> prices() const { return column<int64_t>(Column::PRICE); }
+    std::span<const int64_t> quantities() const { return column<int64_t>(Column::QUANTITY); }
+    std::span<const uint16_t> symbols() const { return column<uint16_t>(Column::SYMBOL); }
+    std::span<const uint8_t> markets() const { return column<uint8_t>(Column::MARKET); }
+    std::span<const uint8_t> streamTypes() const { return column<uint8_t>(Column::STREAM_TYPE); }
+    std::span<const uint8_t> flags() const { return column<uint8_t>(Column::FLAGS); }
+
+    DecodedEntry entry(size_t row) const;
+
+    // Same contract as EntryStream::next: the following rows in file order, false at the end.
+    bool next(std::vector<DecodedEntry>& chunk);
+
+    void rewind() { position_ = 0; }
+
+private:
+    MMapData file_;
+    size_t rowCount_{0};
+    size_t chunkRows_;
+    size_t position_{0};
+    const char* columns_[static_cast<size_t>(Column::COUNT)]{};
+
+    template <typename T>
+    std::span<const T> column(const Column c) const {
+        return {reinterpret_cast<const T*>(columns_[static_cast<size_t>(c)]), rowCount_};
+    }
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "enums/Symbol.h"
+
+static constexpr std::array<int64_t, 19> POW10 = {{
+    1LL,
+    10LL,
+    100LL,
+    1'000LL,
+    10'000LL,
+    100'000LL,
+    1'000'000LL,
+    10'000'000LL,
+    100'000'000LL,
+    1'000'000'000LL,
+    10'000'000'000LL,
+    100'000'000'000LL,
+    1'000'000'000'000LL,
+    10'000'000'000'000LL,
+    100'000'000'000'000LL,
+    1'000'000'000'000'000LL,
+    10'000'000'000'000'000LL,
+    100'000'000'000'000'000LL,
+    1'000'000'000'000'000'000LL
+}};
+
+inline double priceScaleOf(Symbol s) {
+    return static_cast<double>(POW10[pricePrecisionOf(s)]);
+}
+
+inline double quantityScaleOf(Symbol s) {
+    return static_cast<double>(POW10[quantityPrecisionOf(s)]);
+}
+
+inline int64_t priceToTicks(const double price, const Symbol s) {
+    return std::llround(price * priceScaleOf(s));
+}
+
+inline double ticksToPrice(const int64_t ticks, const Symbol s) {
+    return static_cast<double>(ticks) / priceScaleOf(s);
+}
+
+inline int64_t quantityToLots(const double quantity, const Symbol s) {
+    return std::llround(quantity * quantityScaleOf(s));
+}
+
+inline double lotsToQuantity(const int64_t lots, const Symbol s) {
+    return static_cast<double>(lots) / quantityScaleOf(s);
+}
+
+// Exact running sum of ticks * lots products. A single product fits in 64 bits,
+// a whole book of them does not, so the sum is kept as an unsigned 128-bit pair.
+struct NotionalSum {
+    uint64_t hi{0};
+    uint64_t lo{0};
+
+    void add(const int64_t ticks, const int64_t lots) {
+        uint64_t pHi, pLo;
+        multiply(static_cast<uint64_t>(ticks), static_cast<uint64_t>(lots), pHi, pLo);
+        const uint64_t r = lo + pLo;
+        hi += pHi + (r < lo ? 1 : 0);
+        lo = r;
+    }
+
+    void subtract(const int64_t ticks, const int64_t lots) {
+        uint64_t pHi, pLo;
+        multiply(static_cast<uint64_t>(ticks), static_cast<uint64_t>(lots), pHi, pLo);
+        hi -= pHi + (lo < pLo ? 1 : 0);
+        lo -= pLo;
+    }
+
+    double toDouble() const {
+        return static_cast<double>(hi) * 18446744073709551616.0 + static_cast<double>(lo);
+    }
+
+private:
+    static void multiply(const uint64_t a, const uint64_t b, uint64_t& pHi, uint64_t& pLo) {
+        const uint64_t aL = a & 0xffffffffULL, aH = a >> 32;
+        const uint64_t bL = b & 0xffffffffULL, bH = b >> 32;
+        const uint64_t ll = aL * bL;
+        const uint64_t lh = aL * bH;
+        const uint64_t hl = aH * bL;
+        const uint64_t hh = aH * bH;
+        const uint64_t mid = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+        pLo = (mid << 32) | (ll & 0xffffffffULL);
+        pHi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    }
+};
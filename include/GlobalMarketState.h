@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include <string>
 #include <optional>
+#include <span>
 
 #include "MetricMask.h"
 #include "OrderBookMetricsCalculator.h"
@@ -11,14 +12,23 @@
 
 class GlobalMarketState {
 public:
-    explicit GlobalMarketState(const MetricMask& mask);
+    explicit GlobalMarketState(const MetricMask& mask, size_t depthLimit = OrderBook::UNBOUNDED_DEPTH);
 
-    explicit GlobalMarketState(const std::vector<std::string>& variables);
+    explicit GlobalMarketState(const std::vector<std::string>& variables, size_t depthLimit = OrderBook::UNBOUNDED_DEPTH);
+
+    GlobalMarketState(const GlobalMarketState&) = delete;
+    GlobalMarketState& operator=(const GlobalMarketState&) = delete;
+    GlobalMarketState(GlobalMarketState&&) = default;
+    GlobalMarketState& operator=(GlobalMarketState&&) = default;
 
     void update(DecodedEntry* entry);
 
+    void updateBatch(std::span<const DifferenceDepthEntry> group);
+
     std::optional<OrderBookMetricsEntry> countMarketStateMetricsByEntry(DecodedEntry* entry);
 
+    bool countMarketStateMetricsByEntry(DecodedEntry* entry, OrderBookMetricsEntry& out);
+
     std::optional<OrderBookMetricsEntry> countMarketStateMetrics(Symbol symbol, const Market& market);
 
     MarketState& getMarketState(Symbol symbol, const Market& market);
@@ -27,8 +37,12 @@ public:
 
     std::vector<std::pair<Symbol, Market>> getMarketStateList() const;
 
+    void saveState(Checkpoint::Writer& w) const;
+    void loadState(Checkpoint::Reader& r);
+
 private:
     MetricMask mask_;
     OrderBookMetricsCalculator calculator_;
+    size_t depthLimit_;
     std::unordered_map<AssetKey, MarketState, AssetKeyHash> marketStates_;
 };
\ No newline at end of file
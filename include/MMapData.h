@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only view of a whole file. The file is memory-mapped where the platform
+// and filesystem allow it (with sequential read-ahead hints) and read into an
+// owned buffer otherwise; either way the view lives as long as the object.
+class MMapData {
+public:
+    explicit MMapData(const std::string& path);
+    ~MMapData();
+
+    MMapData(const MMapData&) = delete;
+    MMapData& operator=(const MMapData&) = delete;
+    MMapData(MMapData&& other) noexcept;
+    MMapData& operator=(MMapData&& other) noexcept;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return {data_, size_}; }
+    std::span<const char> bytes() const { return {data_, size_}; }
+
+    bool isMapped() const { return mapped_; }
+
+    // Hint that bytes before offset will not be read again, letting the kernel
+    // drop those pages so a front-to-back scan keeps a bounded resident set.
+    void discardBefore(size_t offset) noexcept;
+
+private:
+    const char* data_{nullptr};
+    size_t size_{0};
+    bool mapped_{false};
+    size_t discarded_{0};
+    std::vector<char> buffer_;
+
+#ifdef _WIN32
+    void* hFile_{nullptr};
+    void* hMap_{nullptr};
+#endif
+
+    void release() noexcept;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "OrderBook.h"
+#include "enums/DecodedEntry.h"
 #include "enums/TradeEntry.h"
 #include "RollingDifferenceDepthStatistics.h"
 #include "RollingTradeStatistics.h"
@@ -9,8 +10,8 @@ class MarketState {
 public:
     MarketState() = default;
 
-    MarketState(const Market market_, const Symbol symbol)
-        : market(market_), symbol(symbol), lastTrade()
+    MarketState(const Market market_, const Symbol symbol, const size_t depthLimit = OrderBook::UNBOUNDED_DEPTH)
+        : orderBook(symbol, depthLimit), market(market_), symbol(symbol), lastTrade()
     {}
 
     RollingTradeStatistics rollingTradeStatistics;
@@ -20,6 +21,12 @@ public:
 
     void update(DecodedEntry* entry);
 
+    void updateBatch(std::span<const DifferenceDepthEntry> group);
+
+    // Snapshot rows are collected until their isLast row and then bulk-loaded;
+    // call this when a snapshot source ends without one (single-asset snapshot files).
+    void flushPendingSnapshot();
+
     void updateOrderBook(int64_t timestampOfReceive, double price, double quantity, bool isAsk);
 
     void updateTradeRegistry(int64_t timestampOfReceive, double price, double quantity, bool isBuyerMM);
@@ -33,18 +40,22 @@ public:
     Symbol getSymbol() const { return symbol; }
 
     const TradeEntry& getLastTrade() const {
-        if (!hasLastTrade || lastTradePtr == nullptr) { throw std::runtime_error("missing lastTradeEntry"); }
-        return *lastTradePtr;
+        if (!hasLastTrade) { throw std::runtime_error("missing lastTradeEntry"); }
+        return lastTrade;
     }
 
+    void saveState(Checkpoint::Writer& w) const;
+    void loadState(Checkpoint::Reader& r);
+
 
 private:
-    Market market;
-    Symbol symbol;
+    Market market{Market::UNKNOWN};
+    Symbol symbol{Symbol::UNKNOWN};
 
     uint64_t lastTimestampOfReceive{0};
 
+    std::vector<DifferenceDepthEntry> pendingSnapshot_;
+
     TradeEntry   lastTrade;
-    TradeEntry*  lastTradePtr{nullptr};
     bool         hasLastTrade{false};
 };
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "EntryStream.h"
+
+// Replays raw single-stream CSVs (depth snapshots, difference depth, trades, any
+// symbols and markets) as one stream ordered by TimestampOfReceiveUS, so they can
+// be fed to the simulator without building a merged file first. Every file is
+// decoded by its own EntryStream; a binary heap keyed by the timestamp of each
+// file's next message picks which file goes next, and whole messages are taken at
+// a time so isLast boundaries are never interleaved. Raw files carry no IsLast
+// column: a depth message is the run of rows sharing one TimestampOfReceive, a
+// trade is a message of its own. Files are expected to be time-ordered; on equal
+// timestamps the file listed first wins.
+class MergedEntryStream {
+public:
+    static constexpr size_t DEFAULT_CHUNK_ROWS = 1 << 16;
+
+    // decodeThreads is shared out between the files (at least one each, unless 0).
+    static MergedEntryStream openSingleAssetParametersCSVs(const std::vector<std::string>& csvPaths,
+                                                           size_t decodeThreads = EntryStream::defaultDecodeThreads(),
+                                                           size_t chunkRows = DEFAULT_CHUNK_ROWS);
+
+    MergedEntryStream(MergedEntryStream&&) = default;
+    MergedEntryStream& operator=(MergedEntryStream&&) = delete;
+
+    // Same contract as EntryStream::next; chunks always end on a message boundary.
+    bool next(std::vector<DecodedEntry>& chunk);
+
+private:
+    struct Source {
+        EntryStream stream;
+        std::vector<DecodedEntry> rows;
+        size_t pos{0};
+
+        // Makes rows[pos] valid; false once the file is exhausted.
+        bool fill();
+    };
+
+    struct Pending {
+        int64_t timestampOfReceive;
+        uint32_t source;
+    };
+
+    explicit MergedEntryStream(size_t chunkRows) : chunkRows_(chunkRows) {}
+
+    void appendMessage(Source& source, std::vector<DecodedEntry>& chunk);
+    void pushPending(uint32_t source);
+
+    size_t chunkRows_;
+    std::vector<Source> sources_;
+    std::vector<Pending> heap_;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "enums/DifferenceDepthEntry.h"
+
+// Free-list pool of order book nodes that grows in page-aligned chunks on demand.
+// Chunks are never moved or released before destruction, so node addresses stay
+// stable for the intrusive lists and the price ladders pointing into them.
+class NodeArena {
+public:
+    static constexpr size_t PAGE_BYTES = 4096;
+    static constexpr size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+    explicit NodeArena(size_t initialNodes = 1024, bool hugePages = false);
+    ~NodeArena();
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+    NodeArena(NodeArena&& other) noexcept;
+    NodeArena& operator=(NodeArena&& other) noexcept;
+
+    DifferenceDepthEntry* allocate() {
+        if (!freeListHead_) grow();
+        auto *node = freeListHead_;
+        freeListHead_ = node->next_;
+        return node;
+    }
+
+    void deallocate(DifferenceDepthEntry* node) {
+        node->next_ = freeListHead_;
+        freeListHead_ = node;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Chunk {
+        void* memory;
+        size_t bytes;
+    };
+
+    std::vector<Chunk> chunks_;
+    DifferenceDepthEntry* freeListHead_{nullptr};
+    size_t capacity_{0};
+    size_t nextChunkBytes_;
+    bool hugePages_;
+
+    void grow();
+    void addChunk(size_t bytes);
+    void release();
+};
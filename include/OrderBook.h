@@ -1,68 +1,83 @@
 #pragma once
 
-#include <variant>
 #include <optional>
+#include <span>
 #include <vector>
-#include <unordered_map>
-#include <map>
 
+#include "Checkpoint.h"
+#include "DepthOverflow.h"
+#include "FixedPoint.h"
 #include "MetricMask.h"
+#include "NodeArena.h"
+#include "PriceLadder.h"
 #include "enums/TradeEntry.h"
 #include "enums/DifferenceDepthEntry.h"
 
-using DecodedEntry = std::variant<DifferenceDepthEntry, TradeEntry>;
+class OrderBook {
+public:
+    static constexpr size_t DEFAULT_TOP_LEVELS = 64;
 
-struct PriceSide {
-    double price;
-    bool   isAsk;
-    bool operator==(PriceSide const& o) const noexcept {
-        return price == o.price && isAsk == o.isAsk;
-    }
-};
+    static constexpr size_t DEFAULT_INITIAL_LEVELS = 1024;
 
-struct PriceSideHash {
-    size_t operator()(PriceSide const& ps) const noexcept {
-        const auto h1 = std::hash<uint64_t>{}(
-            *reinterpret_cast<uint64_t const*>(&ps.price)
-        );
-        const auto h2 = std::hash<bool>{}(ps.isAsk);
-        return h1 ^ (h2 << 1);
-    }
-};
+    static constexpr size_t UNBOUNDED_DEPTH = 0;
 
-class OrderBook {
-public:
-    explicit OrderBook(size_t maxLevels = 150'000);
+    // depthLimit > 0 keeps only that many levels per side in the sorted book; the
+    // rest wait in a DepthOverflow store. Counts and sums still cover every level.
+    explicit OrderBook(size_t depthLimit = UNBOUNDED_DEPTH, size_t initialLevels = DEFAULT_INITIAL_LEVELS, size_t topLevels = DEFAULT_TOP_LEVELS, bool hugePages = false);
+
+    explicit OrderBook(Symbol symbol, size_t depthLimit = UNBOUNDED_DEPTH, size_t initialLevels = DEFAULT_INITIAL_LEVELS, size_t topLevels = DEFAULT_TOP_LEVELS, bool hugePages = false);
 
     void update(DifferenceDepthEntry* entryPtr);
 
+    // Applies one depth message (rows of a single symbol, ending with isLast) in
+    // price order and refreshes the deltas once for the whole group.
+    void applyBatch(std::span<const DifferenceDepthEntry> group);
+
+    // Replaces the whole book with a depth snapshot. Rows already ordered by price
+    // per side (either direction) are linked in one pass without any level search.
+    void loadSnapshot(std::span<const DifferenceDepthEntry> levels);
+
+    void clear();
+
+    void saveState(Checkpoint::Writer& w) const;
+    void loadState(Checkpoint::Reader& r);
+
     void printOrderBook() const;
 
+    size_t depthLimit() const { return depthLimit_; }
+
     size_t askCount() const { return askCount_; }
     size_t bidCount() const { return bidCount_; }
 
-    double sumAskQuantity() const { return sumAskQuantity_; }
-    double sumBidQuantity() const { return sumBidQuantity_; }
-    double sumTotalAskBidQuantity() const { return sumAskQuantity_ + sumBidQuantity_; }
-    double bestAskPrice() const { return askHead_->price; }
-    double bestBidPrice() const { return bidHead_->price; }
-    double bestAskQuantity() const { return askHead_->quantity; }
-    double bestBidQuantity() const { return bidHead_->quantity; }
-    double secondAskPrice() const { return askHead_->next_->price; }
-    double secondBidPrice() const { return bidHead_->next_->price; }
+    Symbol symbol() const { return symbol_; }
+
+    double sumAskQuantity() const { return toQuantity(sumAskQuantity_); }
+    double sumBidQuantity() const { return toQuantity(sumBidQuantity_); }
+    double sumTotalAskBidQuantity() const { return toQuantity(sumAskQuantity_ + sumBidQuantity_); }
+    double bestAskPrice() const { return toPrice(askHead_->priceTicks); }
+    double bestBidPrice() const { return toPrice(bidHead_->priceTicks); }
+    double bestAskQuantity() const { return toQuantity(askHead_->quantityLots); }
+    double bestBidQuantity() const { return toQuantity(bidHead_->quantityLots); }
+    double secondAskPrice() const { return toPrice(askHead_->next_->priceTicks); }
+    double secondBidPrice() const { return toPrice(bidHead_->next_->priceTicks); }
+
+    int64_t bestAskTicks() const { return askHead_->priceTicks; }
+    int64_t bestBidTicks() const { return bidHead_->priceTicks; }
+    int64_t sumAskLots() const { return sumAskQuantity_; }
+    int64_t sumBidLots() const { return sumBidQuantity_; }
 
     size_t deltaAskCount() const { return deltaAskCount_; }
     size_t deltaBidCount() const { return deltaBidCount_; }
-    double deltaBestAskQuantity() const { return deltaBestAskQuantity_; }
-    double deltaBestBidQuantity() const { return deltaBestBidQuantity_; }
-    double deltaBestAskPrice() const { return deltaBestAskPrice_; }
-    double deltaBestBidPrice() const { return deltaBestBidPrice_; }
-    double deltaSumAskQuantity() const { return deltaSumAskQuantity_; }
-    double deltaSumBidQuantity() const { return deltaSumBidQuantity_; }
+    double deltaBestAskQuantity() const { return toQuantity(deltaBestAskQuantity_); }
+    double deltaBestBidQuantity() const { return toQuantity(deltaBestBidQuantity_); }
+    double deltaBestAskPrice() const { return toPrice(deltaBestAskPrice_); }
+    double deltaBestBidPrice() const { return toPrice(deltaBestBidPrice_); }
+    double deltaSumAskQuantity() const { return toQuantity(deltaSumAskQuantity_); }
+    double deltaSumBidQuantity() const { return toQuantity(deltaSumBidQuantity_); }
 
     double cumulativeQuantityOfTopNAsks(size_t n) const;
     double cumulativeQuantityOfTopNBids(size_t n) const;
-    double sumOfPriceTimesQuantity() const { return sumOfPriceTimesQuantity_; }
+    double sumOfPriceTimesQuantity() const { return sumOfPriceTimesQuantity_.toDouble() / (priceScale_ * quantityScale_); }
     double bestNthAskPrice(size_t K) const;
     double bestNthBidPrice(size_t K) const;
 
@@ -70,48 +85,92 @@ public:
     std::vector<DifferenceDepthEntry> getBids() const;
 
 private:
-
-    std::vector<DifferenceDepthEntry> arena;
-    DifferenceDepthEntry* freeListHead_{nullptr};
+    // Prices and running quantity totals of the best levels of one side, rebuilt
+    // on the first query after an update touched a level inside the cached range.
+    struct TopLevelCache {
+        std::vector<int64_t> priceTicks;
+        std::vector<int64_t> cumulativeLots;
+        size_t size{0};
+        int64_t worstKey{0};
+        bool dirty{true};
+    };
+
+    NodeArena arena;
 
     DifferenceDepthEntry* askHead_{nullptr};
     DifferenceDepthEntry* askTail_{nullptr};
     DifferenceDepthEntry* bidHead_{nullptr};
     DifferenceDepthEntry* bidTail_{nullptr};
 
-    std::map<double, DifferenceDepthEntry*> askMap_;
-    std::map<double, DifferenceDepthEntry*, std::greater<double>> bidMap_;
+    Symbol symbol_{Symbol::UNKNOWN};
+    double priceScale_{1e8};
+    double quantityScale_{1e8};
+
+    PriceLadder askLadder_;
+    PriceLadder bidLadder_;
 
-    std::unordered_map<PriceSide, DifferenceDepthEntry*, PriceSideHash> index_;
+    size_t depthLimit_;
+    DepthOverflow askOverflow_;
+    DepthOverflow bidOverflow_;
+
+    size_t topLevels_;
+    mutable TopLevelCache askTop_;
+    mutable TopLevelCache bidTop_;
 
     size_t askCount_{0};
     size_t bidCount_{0};
 
-    double sumAskQuantity_{0.0};
-    double sumBidQuantity_{0.0};
-    double sumOfPriceTimesQuantity_{0.0};
+    int64_t sumAskQuantity_{0};
+    int64_t sumBidQuantity_{0};
+    NotionalSum sumOfPriceTimesQuantity_;
 
-    double prevBestAskPrice_{0.0};
-    double prevBestBidPrice_{0.0};
-    double prevBestAskQuantity_{0.0};
-    double prevBestBidQuantity_{0.0};
-    double prevSumAskQuantity_{0.0};
-    double prevSumBidQuantity_{0.0};
+    int64_t prevBestAskPrice_{0};
+    int64_t prevBestBidPrice_{0};
+    int64_t prevBestAskQuantity_{0};
+    int64_t prevBestBidQuantity_{0};
+    int64_t prevSumAskQuantity_{0};
+    int64_t prevSumBidQuantity_{0};
     size_t prevAskCount_{0};
     size_t prevBidCount_{0};
 
-    double deltaBestAskPrice_{0.0};
-    double deltaBestBidPrice_{0.0};
-    double deltaBestAskQuantity_{0.0};
-    double deltaBestBidQuantity_{0.0};
-    double deltaSumAskQuantity_{0.0};
-    double deltaSumBidQuantity_{0.0};
+    int64_t deltaBestAskPrice_{0};
+    int64_t deltaBestBidPrice_{0};
+    int64_t deltaBestAskQuantity_{0};
+    int64_t deltaBestBidQuantity_{0};
+    int64_t deltaSumAskQuantity_{0};
+    int64_t deltaSumBidQuantity_{0};
     size_t deltaAskCount_{0};
     size_t deltaBidCount_{0};
 
-    DifferenceDepthEntry* allocateNode(double price, bool isAsk, double quantity);
-    void deallocateNode(DifferenceDepthEntry* node);
+    DifferenceDepthEntry* allocateNode(int64_t priceTicks, bool isAsk, int64_t quantityLots);
+
+    void adoptSymbol(Symbol symbol);
+
+    std::vector<uint32_t> batchOrder_;
+    std::vector<uint32_t> snapshotBidOrder_;
+
+    void orderBestFirst(std::span<const DifferenceDepthEntry> levels, std::vector<uint32_t>& order, bool isAsk);
+    void appendSnapshotLevel(const DifferenceDepthEntry* e, int64_t key);
+
+    void applyLevel(const DifferenceDepthEntry* e);
+    void computeDeltas();
+    bool applyOverflowLevel(const DifferenceDepthEntry* e, int64_t key);
+    void promoteBestOverflowLevel(bool isAsk);
+
+    double toPrice(const int64_t ticks) const { return static_cast<double>(ticks) / priceScale_; }
+    double toQuantity(const int64_t lots) const { return static_cast<double>(lots) / quantityScale_; }
+
+    static int64_t ladderKey(const int64_t priceTicks, const bool isAsk) {
+        return isAsk ? priceTicks : -priceTicks;
+    }
+
+    void touchTopLevels(TopLevelCache& cache, int64_t key) const {
+        if (!cache.dirty && (cache.size < topLevels_ || key <= cache.worstKey)) cache.dirty = true;
+    }
+    const TopLevelCache& topLevels(TopLevelCache& cache, const DifferenceDepthEntry* head, bool isAsk) const;
+    double cumulativeQuantityOfTopN(TopLevelCache& cache, const DifferenceDepthEntry* head, bool isAsk, size_t n) const;
+    double bestNthPrice(TopLevelCache& cache, const DifferenceDepthEntry* head, bool isAsk, size_t K) const;
 
-    void addNode(DifferenceDepthEntry*& head, DifferenceDepthEntry*& tail, DifferenceDepthEntry* node, bool isAsk);
+    void insertNodeBefore(DifferenceDepthEntry*& head, DifferenceDepthEntry*& tail, DifferenceDepthEntry* node, DifferenceDepthEntry* next);
     void removeNode(DifferenceDepthEntry*& head, DifferenceDepthEntry*& tail, DifferenceDepthEntry* node);
 };
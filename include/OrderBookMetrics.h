@@ -9,8 +9,12 @@ namespace py = pybind11;
 
 class OrderBookMetrics {
 public:
-    explicit OrderBookMetrics(const std::vector<std::string>& variables, const size_t expected_count)
-        : variables_(variables) { entries_.reserve(expected_count); }
+    // Rows are appended as the replay produces them; the buffer grows geometrically
+    // from initial_capacity, so no counting pass over the input is needed.
+    static constexpr size_t DEFAULT_INITIAL_CAPACITY = 1 << 14;
+
+    explicit OrderBookMetrics(const std::vector<std::string>& variables, const size_t initial_capacity = DEFAULT_INITIAL_CAPACITY)
+        : variables_(variables) { entries_.reserve(initial_capacity); }
 
     void addOrderBookMetricsEntry(const OrderBookMetricsEntry& entry) { entries_.push_back(entry); }
 
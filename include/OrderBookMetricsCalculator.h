@@ -3,13 +3,27 @@
 #include "MarketState.h"
 #include "OrderBookMetricsEntry.h"
 #include "MetricMask.h"
+#include "SnapshotContext.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <optional>
+#include <vector>
 
+// units of the WINDOW_METRIC entries of metrics_list.def
+namespace WindowUnit {
+    inline constexpr int64_t Seconds = 1'000'000;
+    inline constexpr int64_t Milliseconds = 1'000;
+}
+
+// The mask is compiled once into the list of kernels of the selected metrics
+// (one per metrics_list.def entry), so a row costs only what was asked for. The
+// kernels of a row share one SnapshotContext, so common primitives are computed once.
 class OrderBookMetricsCalculator {
 public:
-    explicit OrderBookMetricsCalculator(const MetricMask& mask)
-      : mask_(mask) {}
+    using Kernel = void (*)(SnapshotContext&, OrderBookMetricsEntry&);
+
+    explicit OrderBookMetricsCalculator(const MetricMask& mask);
 
     explicit OrderBookMetricsCalculator(const std::vector<std::string>& variables)
     : OrderBookMetricsCalculator(parseMask(variables))
@@ -17,6 +31,22 @@ public:
 
     std::optional<OrderBookMetricsEntry> countMarketStateMetrics(const MarketState& marketState) const;
 
+    // Writes only the selected fields of out, so a reused out keeps its other fields as they were.
+    bool countMarketStateMetrics(const MarketState& marketState, OrderBookMetricsEntry& out) const;
+
+    static constexpr int64_t longestWindowMicros() {
+        int64_t longest = 0;
+        #define METRIC(name, ctype)
+        #define WINDOW_METRIC(base, ctype, length, unit) longest = std::max<int64_t>(longest, length * WindowUnit::unit);
+        #include "detail/metrics_list.def"
+        #undef WINDOW_METRIC
+        #undef METRIC
+        return longest;
+    }
+
 private:
     MetricMask mask_;
+    std::vector<Kernel> plan_;
+    // per-row memo only, not part of the calculator's observable state
+    mutable SnapshotContext context_;
 };
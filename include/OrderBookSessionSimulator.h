@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <vector>
 #include <pybind11/pybind11.h>
 
 #include "OrderBook.h"
@@ -11,11 +14,25 @@ class OrderBookSessionSimulator {
 public:
     explicit OrderBookSessionSimulator();
 
-    py::dict computeVariables(const std::string &csvPath, const std::vector<std::string> &variables);
+    // With a start and / or end only rows with TimestampOfReceive in [start, end) yield metrics;
+    // a merged CSV is then decoded from the nearest depth snapshot before start (via its
+    // TimestampIndex sidecar) and stops at end, so the cost follows the slice length.
+    py::dict computeVariables(const std::string &csvPath, const std::vector<std::string> &variables,
+                              std::optional<int64_t> startTimestampOfReceive = std::nullopt,
+                              std::optional<int64_t> endTimestampOfReceive = std::nullopt);
+
+    // Raw single-stream CSVs (snapshot / difference depth / trade files), merged by timestamp.
+    py::dict computeVariables(const std::vector<std::string> &csvPaths, const std::vector<std::string> &variables);
+
+    // Consecutive day files (merged CSV / EventFile / EventArchive) replayed as one session:
+    // books and rolling windows carry over midnight and the result is one contiguous table.
+    py::dict computeVariablesOverDays(const std::vector<std::string> &dayPaths, const std::vector<std::string> &variables);
 
     py::dict computeBacktest(const std::string& csvPath, std::vector<std::string> &variables, const py::object &python_callback = py::none());
 
+    py::dict computeBacktest(const std::vector<std::string>& csvPaths, std::vector<std::string> &variables, const py::object &python_callback = py::none());
+
+    py::dict computeBacktestOverDays(const std::vector<std::string>& dayPaths, std::vector<std::string> &variables, const py::object &python_callback = py::none());
+
     OrderBook computeFinalDepthSnapshot(const std::string &csvPath);
-private:
-    static size_t countOrderBookMetricsSize(const std::vector<DecodedEntry>& entries);
 };
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "enums/DifferenceDepthEntry.h"
+
+// One side of the book indexed by integer tick. Keys are ordered best-first
+// (asks use +ticks, bids use -ticks), so the lowest occupied key is the touch.
+// Keys inside [anchor_, anchor_ + capacity_) live in a dense slot array with an
+// occupancy bitmap; worse keys beyond the window fall back to far_.
+class PriceLadder {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 15;
+
+    explicit PriceLadder(size_t capacity = DEFAULT_CAPACITY);
+
+    DifferenceDepthEntry* find(int64_t key) const;
+
+    // Returns the level that must follow the inserted one (nullptr = new worst level).
+    DifferenceDepthEntry* insert(int64_t key, DifferenceDepthEntry* node);
+
+    // Bulk-build path: key must be worse than every key already present.
+    void append(int64_t key, DifferenceDepthEntry* node);
+
+    void erase(int64_t key);
+
+    void recentreIfDrifted(int64_t bestKey);
+
+    void clear();
+
+private:
+    size_t capacity_;
+    int64_t anchor_{0};
+    size_t windowCount_{0};
+
+    std::vector<DifferenceDepthEntry*> slots_;
+    std::vector<uint64_t> words_;
+    std::vector<uint64_t> summary_;
+    std::map<int64_t, DifferenceDepthEntry*> far_;
+
+    std::vector<std::pair<int64_t, DifferenceDepthEntry*>> scratch_;
+
+    void setBit(size_t idx);
+    void clearBit(size_t idx);
+    size_t nextSetAfter(size_t idx) const;
+
+    void place(int64_t key, DifferenceDepthEntry* node);
+    void recentre(int64_t bestKey);
+};
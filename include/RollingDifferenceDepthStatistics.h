@@ -1,35 +1,52 @@
 #pragma once
 #include <array>
 #include <cstdint>
+#include <span>
+#include "CascadedRollingWindow.h"
+#include "Checkpoint.h"
 #include "EntryDecoder.h"
 
 class RollingDifferenceDepthStatistics {
 public:
+    struct WindowCounts {
+        size_t bidDifferenceDepthEntryCount{0};
+        size_t askDifferenceDepthEntryCount{0};
+    };
+
     void update(const DifferenceDepthEntry& entry);
 
-    size_t bidDifferenceDepthEntryCount(int windowDurationSeconds) const;
-    size_t askDifferenceDepthEntryCount(int windowDurationSeconds) const;
+    WindowCounts windowCounts(int64_t windowMicros) const;
 
-private:
-    static constexpr int64_t    BUCKET_SIZE_US = 1'000'000; // 1 s
-    static constexpr size_t     MAX_BUCKETS    = 61;        // 60 s of history
+    // out[i] = windowCounts(windowsMicros[i])
+    void windowSnapshot(std::span<const int64_t> windowsMicros, std::span<WindowCounts> out) const;
 
-    struct Bucket {
+    size_t bidDifferenceDepthEntryCount(int64_t windowMicros) const;
+    size_t askDifferenceDepthEntryCount(int64_t windowMicros) const;
+
+    // rows older than this no longer reach any window of up to longestWindowMicros
+    static constexpr int64_t historyMicros(const int64_t longestWindowMicros) { return Window::historyMicros(longestWindowMicros); }
 
+    void saveState(Checkpoint::Writer& w) const;
+    void loadState(Checkpoint::Reader& r);
+
+private:
+    struct Bucket {
         size_t bidDifferenceDepthEntryCount = 0;
         size_t askDifferenceDepthEntryCount = 0;
+        bool hasData = false;
 
-        int64_t start_time = 0;
-        bool hasDifferenceDepthData = false;
-
-        void resetDepthBucket();
+        void saveState(Checkpoint::Writer& w) const;
+        void loadState(Checkpoint::Reader& r);
     };
 
-    std::array<Bucket, MAX_BUCKETS> buckets_;
-    size_t currentBucketIdx_ = 0;
-    int64_t lastDepthTimestamp_ = 0;
+    struct BucketCounts : WindowCounts {
+        void add(const Bucket& bucket) {
+            bidDifferenceDepthEntryCount += bucket.bidDifferenceDepthEntryCount;
+            askDifferenceDepthEntryCount += bucket.askDifferenceDepthEntryCount;
+        }
+    };
 
-    static size_t getBucketIndex(int64_t timestamp);
+    using Window = CascadedRollingWindow<Bucket, BucketCounts>;
 
-    void advanceDepthToTimestamp(int64_t timestamp);
+    Window window_;
 };
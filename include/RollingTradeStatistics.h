@@ -1,51 +1,110 @@
 #pragma once
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <span>
+#include "CandleIndicators.h"
+#include "CascadedRollingWindow.h"
+#include "Checkpoint.h"
 #include "EntryDecoder.h"
 
 class RollingTradeStatistics {
 public:
+    struct WindowTotals {
+        size_t buyTradeCount{0};
+        size_t sellTradeCount{0};
+        double buyTradeVolume{0.0};
+        double sellTradeVolume{0.0};
+    };
+
+    // windows of the per-row trade metrics
+    static constexpr std::array<int, 7> STANDARD_WINDOWS_SECONDS{1, 3, 5, 10, 15, 30, 60};
+    // candle lengths with RSI / StochRSI / MACD state
+    static constexpr std::array<int, 2> INDICATOR_CANDLE_SECONDS{2, 5};
+    // priceDifference / oldestPrice only look this far back for a price; across a
+    // longer gap without trades the price counts as missing and they return 0
+    static constexpr int64_t PRICE_LOOKBACK_MICROS = 136'000'000;
+
+    RollingTradeStatistics();
+
     void update(const TradeEntry& e);
 
-    size_t buyTradeCount(int windowDurationSeconds) const;
-    size_t sellTradeCount(int windowDurationSeconds) const;
-    double buyTradeVolume(int windowDurationSeconds) const;
-    double sellTradeVolume(int windowDurationSeconds) const;
-    double priceDifference(int windowDurationSeconds) const;
-    double oldestPrice(int windowTimeSeconds) const;
+    // buy / sell counts and volumes of one window, at the resolution CascadedRollingWindow serves it with
+    WindowTotals windowTotals(int64_t windowMicros) const;
+
+    // out[i] = windowTotals(windowsMicros[i])
+    void windowSnapshot(std::span<const int64_t> windowsMicros, std::span<WindowTotals> out) const;
+
+    size_t buyTradeCount(int64_t windowMicros) const;
+    size_t sellTradeCount(int64_t windowMicros) const;
+    double buyTradeVolume(int64_t windowMicros) const;
+    double sellTradeVolume(int64_t windowMicros) const;
+    double priceDifference(int64_t windowMicros) const;
+    double oldestPrice(int64_t windowMicros) const;
     double lastTradePrice() const { return lastTradePrice_; }
-    double biggestBuyTradeNSeconds(int windowSeconds) const;
-    double biggestSellTradeNSeconds(int windowSeconds) const;
-    double simpleMovingAverage(int windowTimeSeconds) const;
+    double biggestBuyTrade(int64_t windowMicros) const;
+    double biggestSellTrade(int64_t windowMicros) const;
+    double simpleMovingAverage(int64_t windowMicros) const;
 
-private:
-    static constexpr int64_t    BUCKET_SIZE_US = 1'000'000; // 1 s
-    static constexpr size_t     MAX_BUCKETS    = 136;       // 136 s of history
+    // candleSeconds must be one of INDICATOR_CANDLE_SECONDS
+    const CandleIndicators& indicators(int candleSeconds) const;
+    double rsi(int candleSeconds) const { return indicators(candleSeconds).rsi(); }
+    double stochRsi(int candleSeconds) const { return indicators(candleSeconds).stochRsi(); }
+    double macd(int candleSeconds) const { return indicators(candleSeconds).macd(); }
 
-    struct Bucket {
+    // rows older than this no longer reach any window of up to longestWindowMicros or any indicator
+    static constexpr int64_t historyMicros(const int64_t longestWindowMicros) {
+        return std::max(Window::historyMicros(longestWindowMicros),
+                        CandleIndicators::WARMUP_CANDLES * std::ranges::max(INDICATOR_CANDLE_SECONDS) * 1'000'000);
+    }
+
+    void saveState(Checkpoint::Writer& w) const;
+    void loadState(Checkpoint::Reader& r);
 
-        int64_t start_time = 0;
+private:
+    struct Bucket {
         size_t buyTradesCount = 0;
         size_t sellTradesCount = 0;
         double cumulatedBuyTradesQuantity = 0.0;
         double cumulatedSellTradesQuantity = 0.0;
-        double firstTradePrice = 0.0;
         double lastTradePrice = 0.0;
 
         double biggestBuyTrade = 0.0;
         double biggestSellTrade = 0.0;
 
-        bool hasTradeData = false;
+        bool hasData = false;
 
-        void resetTradeBucket();
+        void saveState(Checkpoint::Writer& w) const;
+        void loadState(Checkpoint::Reader& r);
     };
 
-    std::array<Bucket, MAX_BUCKETS> buckets_;
-    size_t currentBucketIdx_ = 0;
-    int64_t lastTradeTimestamp_ = 0;
-    double lastTradePrice_ = 0.0;
+    // running aggregate of the buckets of a window; the maxima are running maxima
+    struct BucketTotals {
+        size_t buyTradesCount = 0;
+        size_t sellTradesCount = 0;
+        double cumulatedBuyTradesQuantity = 0.0;
+        double cumulatedSellTradesQuantity = 0.0;
+        double biggestBuyTrade = 0.0;
+        double biggestSellTrade = 0.0;
+        double lastTradePriceSum = 0.0;
+        size_t tradeBucketsCount = 0;
+
+        void add(const Bucket& bucket) {
+            buyTradesCount += bucket.buyTradesCount;
+            sellTradesCount += bucket.sellTradesCount;
+            cumulatedBuyTradesQuantity += bucket.cumulatedBuyTradesQuantity;
+            cumulatedSellTradesQuantity += bucket.cumulatedSellTradesQuantity;
+            biggestBuyTrade = std::max(biggestBuyTrade, bucket.biggestBuyTrade);
+            biggestSellTrade = std::max(biggestSellTrade, bucket.biggestSellTrade);
+            lastTradePriceSum += bucket.lastTradePrice;
+            ++tradeBucketsCount;
+        }
+    };
 
-    static size_t getBucketIndex(int64_t timestamp);
+    using Window = CascadedRollingWindow<Bucket, BucketTotals>;
+
+    Window window_;
+    double lastTradePrice_ = 0.0;
 
-    void advanceTradeToTimestamp(int64_t timestamp);
+    std::array<CandleIndicators, INDICATOR_CANDLE_SECONDS.size()> indicators_;
 };
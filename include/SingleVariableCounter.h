@@ -1,105 +1,107 @@
 #pragma once
 
-#include "RollingDifferenceDepthStatistics.h"
-#include "RollingTradeStatistics.h"
+#include "SnapshotContext.h"
 #include "enums/TradeEntry.h"
-#include "OrderBook.h"
+
+// Every calculation reads the book and the rolling windows through a SnapshotContext,
+// so primitives shared by several metrics of a row are computed once per row.
 
 namespace SingleVariableCounter {
 
-    double calculateBestAskPrice(const OrderBook& orderBook);
-    double calculateBestBidPrice(const OrderBook& orderBook);
-    double calculateMidPrice(const OrderBook& orderBook);
-
-    double calculateMicroPriceDiff(const OrderBook& orderBook);
-    double calculateMicroPriceImbalance(const OrderBook& orderBook);
-    double calculateMicroPriceFisherImbalance(const OrderBook& orderBook);
-    double calculateMicroPriceDeviation(const OrderBook& orderBook);
-    double calculateMicroPriceLogRatio(const OrderBook& orderBook);
-
-    double calculateBestBidQuantity(const OrderBook& orderBook);
-    double calculateBestAskQuantity(const OrderBook& orderBook);
-
-    double calculateBestOrderFlowDiff(const OrderBook& orderBook);
-    double calculateBestOrderFlowImbalance(const OrderBook& orderBook);
-    double calculateBestOrderFlowFisherImbalance(const OrderBook& orderBook);
-
-    double calculateBestOrderFlowCKSDiff(const OrderBook& orderBook);
-    double calculateBestOrderFlowCKSImbalance(const OrderBook& orderBook);
-    double calculateBestOrderFlowCKSFisherImbalance(const OrderBook& orderBook);
-
-    double calculateOrderFlowDiff(const OrderBook& orderBook);
-    double calculateOrderFlowImbalance(const OrderBook& orderBook);
-    double calculateOrderFlowFisherImbalance(const OrderBook& orderBook);
-
-    double calculateQueueCountFlowDelta(const OrderBook& orderBook);
-    double calculateQueueCountFlowImbalance(const OrderBook& orderBook);
-    double calculateQueueCountFlowFisherImbalance(const OrderBook& orderBook);
-
-    double calculateBestVolumeDiff(const OrderBook& orderBook);
-    double calculateBestVolumeImbalance(const OrderBook& orderBook);
-    double calculateBestVolumeFisherImbalance(const OrderBook& orderBook);
-    double calculateBestVolumeLogRatio(const OrderBook& orderBook);
-    double calculateBestVolumeSignedLogRatioXVolume(const OrderBook& orderBook);
-    double calculateBestNPriceLevelsVolumeDiff(const OrderBook& orderBook, int nPriceLevels);
-    double calculateBestNPriceLevelsVolumeImbalance(const OrderBook& orderBook, int nPriceLevels);
-    double calculateBestNPriceLevelsVolumeLogRatio(const OrderBook& orderBook, int nPriceLevels);
-    double calculateBestNPriceLevelsVolumeLogRatioXVolume(const OrderBook& orderBook, int nPriceLevels);
-
-    double calculateVolumeDiff(const OrderBook& orderBook);
-    double calculateVolumeImbalance(const OrderBook& orderBook);
-    double calculateVolumeLogRatio(const OrderBook& orderBook);
-    double calculateVolumeLogRatioXVolume(const OrderBook& orderBook);
-
-    double calculateQueueDiff(const OrderBook& orderBook);
-    double calculateQueueImbalance(const OrderBook& orderBook);
-    double calculateQueueLogRatio(const OrderBook& orderBook);
-    double calculateQueueLogRatioXVolume(const OrderBook& orderBook);
-
-    double calculateGap(const OrderBook& orderBook);
+    double calculateBestAskPrice(SnapshotContext& context);
+    double calculateBestBidPrice(SnapshotContext& context);
+    double calculateMidPrice(SnapshotContext& context);
+
+    double calculateMicroPriceDiff(SnapshotContext& context);
+    double calculateMicroPriceImbalance(SnapshotContext& context);
+    double calculateMicroPriceFisherImbalance(SnapshotContext& context);
+    double calculateMicroPriceDeviation(SnapshotContext& context);
+    double calculateMicroPriceLogRatio(SnapshotContext& context);
+
+    double calculateBestBidQuantity(SnapshotContext& context);
+    double calculateBestAskQuantity(SnapshotContext& context);
+
+    double calculateBestOrderFlowDiff(SnapshotContext& context);
+    double calculateBestOrderFlowImbalance(SnapshotContext& context);
+    double calculateBestOrderFlowFisherImbalance(SnapshotContext& context);
+
+    double calculateBestOrderFlowCKSDiff(SnapshotContext& context);
+    double calculateBestOrderFlowCKSImbalance(SnapshotContext& context);
+    double calculateBestOrderFlowCKSFisherImbalance(SnapshotContext& context);
+
+    double calculateOrderFlowDiff(SnapshotContext& context);
+    double calculateOrderFlowImbalance(SnapshotContext& context);
+    double calculateOrderFlowFisherImbalance(SnapshotContext& context);
+
+    double calculateQueueCountFlowDelta(SnapshotContext& context);
+    double calculateQueueCountFlowImbalance(SnapshotContext& context);
+    double calculateQueueCountFlowFisherImbalance(SnapshotContext& context);
+
+    double calculateBestVolumeDiff(SnapshotContext& context);
+    double calculateBestVolumeImbalance(SnapshotContext& context);
+    double calculateBestVolumeFisherImbalance(SnapshotContext& context);
+    double calculateBestVolumeLogRatio(SnapshotContext& context);
+    double calculateBestVolumeSignedLogRatioXVolume(SnapshotContext& context);
+    double calculateBestNPriceLevelsVolumeDiff(SnapshotContext& context, int nPriceLevels);
+    double calculateBestNPriceLevelsVolumeImbalance(SnapshotContext& context, int nPriceLevels);
+    double calculateBestNPriceLevelsVolumeLogRatio(SnapshotContext& context, int nPriceLevels);
+    double calculateBestNPriceLevelsVolumeLogRatioXVolume(SnapshotContext& context, int nPriceLevels);
+
+    double calculateVolumeDiff(SnapshotContext& context);
+    double calculateVolumeImbalance(SnapshotContext& context);
+    double calculateVolumeLogRatio(SnapshotContext& context);
+    double calculateVolumeLogRatioXVolume(SnapshotContext& context);
+
+    double calculateQueueDiff(SnapshotContext& context);
+    double calculateQueueImbalance(SnapshotContext& context);
+    double calculateQueueLogRatio(SnapshotContext& context);
+    double calculateQueueLogRatioXVolume(SnapshotContext& context);
+
+    double calculateGap(SnapshotContext& context);
     bool calculateIsAggressorAsk(const TradeEntry *tradeEntry);
-    double calculateVwapDeviation(const OrderBook& orderBook);
-    double calculateVwapLogRatio(const OrderBook& orderBook);
-    double calculateSimplifiedSlopeImbalance(const OrderBook& orderBook);
-    double calculateSimplifiedSlopeDiff(const OrderBook& orderBook);
-    double calculateSimplifiedSlopeLogRatio(const OrderBook& orderBook);
-    double calculateBgcSlopeImbalance(const OrderBook& orderBook);
-    double calculateBgcSlopeDiff(const OrderBook& orderBook);
-    double calculateBgcSlopeLogRatio(const OrderBook& orderBook);
-
-    double calculateDifferenceDepthCount(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, int windowTimeSeconds);
-    double calculateTradeCount(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-
-    double calculateDifferenceDepthCountDiff(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, int windowTimeSeconds);
-    double calculateDifferenceDepthCountImbalance(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, int windowTimeSeconds);
-    double calculateDifferenceDepthCountFisherImbalance(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, int windowTimeSeconds);
-    double calculateDifferenceDepthCountLogRatio(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, int windowTimeSeconds);
-    double calculateDifferenceDepthCountLogRatioXEventCount(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, int windowTimeSeconds);
-
-    double calculateTradeCountDiff(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateTradeCountImbalance(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateTradeCountFisherImbalance(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateTradeCountLogRatio(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-
-    double calculateTradeVolumeDiff(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateTradeVolumeImbalance(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateTradeVolumeLogRatio(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-
-    double calculateAvgTradeSizeDiff(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateAvgTradeSizeImbalance(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateAvgTradeSizeLogRatio(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-
-    double calculateBiggestSingleBuyTradeVolume(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateBiggestSingleSellTradeVolume(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-
-    double calculatePriceDifference(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateRateOfReturn(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateLogReturnRatio(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-
-    double calculateLogKylesLambda(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-
-    double calculateRSI(const RollingTradeStatistics& rollingTradeStatistics, int startWindowTimeSeconds, int windowTimeSeconds);
-    double calculateStochRSI(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
-    double calculateMacd(const RollingTradeStatistics& rollingTradeStatistics, int windowTimeSeconds);
+    double calculateVwapDeviation(SnapshotContext& context);
+    double calculateVwapLogRatio(SnapshotContext& context);
+    double calculateSimplifiedSlopeImbalance(SnapshotContext& context);
+    double calculateSimplifiedSlopeDiff(SnapshotContext& context);
+    double calculateSimplifiedSlopeLogRatio(SnapshotContext& context);
+    double calculateBgcSlopeImbalance(SnapshotContext& context);
+    double calculateBgcSlopeDiff(SnapshotContext& context);
+    double calculateBgcSlopeLogRatio(SnapshotContext& context);
+
+    double calculateDifferenceDepthCount(SnapshotContext& context, int64_t windowMicros);
+    double calculateTradeCount(SnapshotContext& context, int64_t windowMicros);
+
+    double calculateDifferenceDepthCountDiff(SnapshotContext& context, int64_t windowMicros);
+    double calculateDifferenceDepthCountImbalance(SnapshotContext& context, int64_t windowMicros);
+    double calculateDifferenceDepthCountFisherImbalance(SnapshotContext& context, int64_t windowMicros);
+    double calculateDifferenceDepthCountLogRatio(SnapshotContext& context, int64_t windowMicros);
+    double calculateDifferenceDepthCountLogRatioXEventCount(SnapshotContext& context, int64_t windowMicros);
+
+    double calculateTradeCountDiff(SnapshotContext& context, int64_t windowMicros);
+    double calculateTradeCountImbalance(SnapshotContext& context, int64_t windowMicros);
+    double calculateTradeCountFisherImbalance(SnapshotContext& context, int64_t windowMicros);
+    double calculateTradeCountLogRatio(SnapshotContext& context, int64_t windowMicros);
+
+    double calculateTradeVolumeDiff(SnapshotContext& context, int64_t windowMicros);
+    double calculateTradeVolumeImbalance(SnapshotContext& context, int64_t windowMicros);
+    double calculateTradeVolumeLogRatio(SnapshotContext& context, int64_t windowMicros);
+
+    double calculateAvgTradeSizeDiff(SnapshotContext& context, int64_t windowMicros);
+    double calculateAvgTradeSizeImbalance(SnapshotContext& context, int64_t windowMicros);
+    double calculateAvgTradeSizeLogRatio(SnapshotContext& context, int64_t windowMicros);
+
+    double calculateBiggestSingleBuyTradeVolume(SnapshotContext& context, int64_t windowMicros);
+    double calculateBiggestSingleSellTradeVolume(SnapshotContext& context, int64_t windowMicros);
+
+    double calculatePriceDifference(SnapshotContext& context, int64_t windowMicros);
+    double calculateRateOfReturn(SnapshotContext& context, int64_t windowMicros);
+    double calculateLogReturnRatio(SnapshotContext& context, int64_t windowMicros);
+
+    double calculateLogKylesLambda(SnapshotContext& context, int64_t windowMicros);
+
+    // windowMicros is the candle length, one of RollingTradeStatistics::INDICATOR_CANDLE_SECONDS
+    double calculateRSI(SnapshotContext& context, int windowTimeSeconds);
+    double calculateStochRSI(SnapshotContext& context, int windowTimeSeconds);
+    double calculateMacd(SnapshotContext& context, int windowTimeSeconds);
 
 }
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "OrderBook.h"
+#include "RollingDifferenceDepthStatistics.h"
+#include "RollingTradeStatistics.h"
+
+class MarketState;
+
+// Primitives that several metrics of one emitted row share (mid / micro price, top-N
+// sums, n-th level prices, per-window trade and depth aggregates), computed on first
+// use and reused by every other metric of that row. reset() moves to the next row
+// in O(1) by bumping a generation stamp instead of clearing the memo slots.
+// A context built from a single OrderBook / rolling statistics object only serves
+// the primitives of that object and computes them on every call; the memo slots
+// are allocated by the first reset(), so one-off contexts stay cheap to build.
+class SnapshotContext {
+public:
+    SnapshotContext() = default;
+    explicit SnapshotContext(const MarketState& marketState) { reset(marketState); }
+    // copies the sources only; the copy starts without memoised values
+    SnapshotContext(const SnapshotContext& other);
+    SnapshotContext& operator=(const SnapshotContext& other);
+    SnapshotContext(SnapshotContext&&) noexcept = default;
+    SnapshotContext& operator=(SnapshotContext&&) noexcept = default;
+    explicit SnapshotContext(const OrderBook& orderBook) : orderBook_(&orderBook) {}
+    explicit SnapshotContext(const RollingTradeStatistics& trades) : trades_(&trades) {}
+    explicit SnapshotContext(const RollingDifferenceDepthStatistics& depth) : depth_(&depth) {}
+
+    void reset(const MarketState& marketState);
+
+    const MarketState& marketState() const { return *marketState_; }
+    const OrderBook& orderBook() const { return *orderBook_; }
+    const RollingTradeStatistics& trades() const { return *trades_; }
+    const RollingDifferenceDepthStatistics& depth() const { return *depth_; }
+
+    double midPrice();
+    double microPrice();
+
+    double cumulativeQuantityOfTopNBids(size_t n);
+    double cumulativeQuantityOfTopNAsks(size_t n);
+    double bestNthBidPrice(size_t n);
+    double bestNthAskPrice(size_t n);
+
+    RollingTradeStatistics::WindowTotals tradeTotals(int64_t windowMicros);
+    double priceDifference(int64_t windowMicros);
+    double oldestPrice(int64_t windowMicros);
+
+    RollingDifferenceDepthStatistics::WindowCounts depthCounts(int64_t windowMicros);
+
+private:
+    static constexpr size_t MAX_LEVELS = OrderBook::DEFAULT_TOP_LEVELS + 1;
+    static constexpr size_t MAX_WINDOWS = 61;
+
+    template <typename T>
+    struct Memo {
+        T value{};
+        uint32_t stamp{0};
+    };
+
+    template <typename T>
+    struct WindowMemo {
+        int64_t windowMicros{0};
+        T value{};
+        uint32_t stamp{0};
+    };
+
+    struct Memos {
+        Memo<double> midPrice;
+        Memo<double> microPrice;
+        std::array<Memo<double>, MAX_LEVELS> topNBids;
+        std::array<Memo<double>, MAX_LEVELS> topNAsks;
+        std::array<Memo<double>, MAX_LEVELS> nthBidPrice;
+        std::array<Memo<double>, MAX_LEVELS> nthAskPrice;
+        std::array<WindowMemo<RollingTradeStatistics::WindowTotals>, MAX_WINDOWS> tradeTotals;
+        std::array<WindowMemo<double>, MAX_WINDOWS> priceDifference;
+        std::array<WindowMemo<double>, MAX_WINDOWS> oldestPrice;
+        std::array<WindowMemo<RollingDifferenceDepthStatistics::WindowCounts>, MAX_WINDOWS> depthCounts;
+    };
+
+    template <auto Slot, typename Compute>
+    auto memo(Compute&& compute) {
+        if (!memos_) return compute();
+        auto& slot = memos_.get()->*Slot;
+        if (slot.stamp != generation_) {
+            slot.value = compute();
+            slot.stamp = generation_;
+        }
+        return slot.value;
+    }
+
+    template <auto Slots, typename Compute>
+    auto memo(const size_t key, Compute&& compute) {
+        if (!memos_) return compute();
+        auto& slots = memos_.get()->*Slots;
+        if (key >= slots.size()) return compute();
+        auto& slot = slots[key];
+        if (slot.stamp != generation_) {
+            slot.value = compute();
+            slot.stamp = generation_;
+        }
+        return slot.value;
+    }
+
+    // direct-mapped by the window in milliseconds; a window whose slot another window of
+    // the same row holds is computed on every use (MAX_WINDOWS is prime so the standard
+    // 1 / 3 / 5 / 10 / 15 / 30 / 60 s windows land in distinct slots)
+    template <auto Slots, typename Compute>
+    auto memoWindow(const int64_t windowMicros, Compute&& compute) {
+        if (!memos_) return compute();
+        auto& slots = memos_.get()->*Slots;
+        auto& slot = slots[static_cast<uint64_t>(windowMicros / 1'000) % slots.size()];
+        if (slot.stamp != generation_) {
+            slot = {windowMicros, compute(), generation_};
+            return slot.value;
+        }
+        return slot.windowMicros == windowMicros ? slot.value : compute();
+    }
+
+    const MarketState* marketState_{nullptr};
+    const OrderBook* orderBook_{nullptr};
+    const RollingTradeStatistics* trades_{nullptr};
+    const RollingDifferenceDepthStatistics* depth_{nullptr};
+    uint32_t generation_{1};
+
+    std::unique_ptr<Memos> memos_;
+};
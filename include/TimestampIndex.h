@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "enums/DecodedEntry.h"
+
+// Sparse seek index of a merged day CSV, kept next to it as <csv>.tsidx. It maps
+// timestamps to the byte offsets of isLast group boundaries (about one every
+// strideBytes), records where depth snapshots start and, at every boundary, where
+// each asset's last trade so far sits, so a [start, end) slice can be decoded from
+// the nearest snapshot instead of from the top of the file.
+// The sidecar carries the CSV's size and mtime and is rebuilt when either changes.
+class TimestampIndex {
+public:
+    static constexpr char MAGIC[4] = {'O', 'B', 'T', 'I'};
+    static constexpr uint16_t VERSION = 2;
+    static constexpr uint64_t NO_TRADE = UINT64_MAX;
+    static constexpr uint64_t DEFAULT_STRIDE_BYTES = 1 << 20;
+
+    struct Header {
+        char magic[4];
+        uint16_t version;
+        uint16_t reserved;
+        uint64_t sourceSize;
+        int64_t sourceWriteTime;
+        uint64_t dataBegin;
+        uint32_t boundaryCount;
+        uint32_t snapshotCount;
+        uint32_t assetCount;
+        uint32_t reserved2;
+    };
+
+    // Line offset of a group start and the timestamp of its first row.
+    struct Boundary {
+        int64_t timestampOfReceive;
+        uint64_t offset;
+    };
+
+    // A group of one asset: the start of a depth snapshot, or the asset's first group in the file.
+    struct AssetPoint {
+        int64_t timestampOfReceive;
+        uint64_t offset;
+        Symbol symbol;
+        Market market;
+    };
+
+    static std::string sidecarPathOf(const std::string& csvPath) { return csvPath + ".tsidx"; }
+
+    // One pass over the CSV.
+    static TimestampIndex build(const std::string& csvPath, uint64_t strideBytes = DEFAULT_STRIDE_BYTES);
+
+    // Empty when the sidecar is missing, corrupt or older than the CSV.
+    static std::optional<TimestampIndex> load(const std::string& csvPath);
+
+    // Reads the sidecar, or builds the index and writes the sidecar for the next call;
+    // a sidecar that cannot be written (read-only directory) only costs the rebuild.
+    static TimestampIndex loadOrBuild(const std::string& csvPath);
+
+    void save(const std::string& csvPath) const;
+
+    // Byte range [begin, end) of line-aligned groups to decode so that replaying it
+    // yields the same state as a full replay for every row in [start, end): begin lies
+    // at or before the latest snapshot ahead of start of every asset seen before start
+    // (or that asset's first row when it has none), at or before that asset's last
+    // trade ahead of start, and at least warmupMicros ahead of start; end is the first
+    // indexed boundary at or after end.
+    std::pair<uint64_t, uint64_t> replayRange(int64_t startTimestampOfReceive, int64_t endTimestampOfReceive, int64_t warmupMicros) const;
+
+    uint64_t dataBegin() const { return dataBegin_; }
+    const std::vector<Boundary>& boundaries() const { return boundaries_; }
+    const std::vector<AssetPoint>& snapshots() const { return snapshots_; }
+    const std::vector<AssetPoint>& assets() const { return assets_; }
+
+    // Offset of the group holding assets()[asset]'s last trade before boundaries()[boundary],
+    // NO_TRADE when it has none yet.
+    uint64_t lastTradeBefore(const size_t boundary, const size_t asset) const { return lastTrades_[boundary * assets_.size() + asset]; }
+
+private:
+    uint64_t sourceSize_{0};
+    int64_t sourceWriteTime_{0};
+    uint64_t dataBegin_{0};
+    std::vector<Boundary> boundaries_;
+    std::vector<AssetPoint> snapshots_;
+    std::vector<AssetPoint> assets_;
+    std::vector<uint64_t> lastTrades_;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "enums/DifferenceDepthEntry.h"
+#include "enums/EntryKind.h"
+#include "enums/TradeEntry.h"
+
+// One decoded CSV / event-file row as it travels through decoding and replay:
+// 32 bytes, tagged by kind. Depth rows keep priceTicks / quantityLots, trades keep
+// their double price / quantity in the same slots. Book levels are stored as
+// DifferenceDepthEntry nodes, which this converts to on the way in.
+struct DecodedEntry {
+    enum Flag : uint8_t {
+        IS_ASK                = 1 << 0,
+        IS_LAST               = 1 << 1,
+        IS_BUYER_MARKET_MAKER = 1 << 2
+    };
+
+    int64_t timestampOfReceive{0};
+    union {
+        int64_t priceTicks{0};
+        double price;
+    };
+    union {
+        int64_t quantityLots{0};
+        double quantity;
+    };
+    Symbol symbol{Symbol::UNKNOWN};
+    EntryKind kind{EntryKind::DIFFERENCE_DEPTH};
+    uint8_t flags{0};
+    Market market{Market::UNKNOWN};
+
+    DecodedEntry() = default;
+
+    static DecodedEntry depth(const int64_t timestampOfReceive, const Symbol symbol, const bool isAsk, const int64_t priceTicks,
+                              const int64_t quantityLots, const bool isLast, const Market market, const bool isSnapshot = false) {
+        DecodedEntry e;
+        e.timestampOfReceive = timestampOfReceive;
+        e.priceTicks = priceTicks;
+        e.quantityLots = quantityLots;
+        e.symbol = symbol;
+        e.kind = isSnapshot ? EntryKind::DEPTH_SNAPSHOT : EntryKind::DIFFERENCE_DEPTH;
+        e.flags = (isAsk ? IS_ASK : 0) | (isLast ? IS_LAST : 0);
+        e.market = market;
+        return e;
+    }
+
+    static DecodedEntry trade(const int64_t timestampOfReceive, const Symbol symbol, const double price, const double quantity,
+                              const bool isBuyerMarketMaker, const bool isLast, const Market market) {
+        DecodedEntry e;
+        e.timestampOfReceive = timestampOfReceive;
+        e.price = price;
+        e.quantity = quantity;
+        e.symbol = symbol;
+        e.kind = EntryKind::TRADE;
+        e.flags = (isBuyerMarketMaker ? IS_BUYER_MARKET_MAKER : 0) | (isLast ? IS_LAST : 0);
+        e.market = market;
+        return e;
+    }
+
+    DecodedEntry(const DifferenceDepthEntry& d)
+        : DecodedEntry(depth(d.timestampOfReceive, d.symbol, d.isAsk, d.priceTicks, d.quantityLots, d.isLast, d.market, d.isSnapshot)) {}
+
+    DecodedEntry(const TradeEntry& t)
+        : DecodedEntry(trade(t.timestampOfReceive, t.symbol, t.price, t.quantity, t.isBuyerMarketMaker, t.isLast, t.market)) {}
+
+    bool isTrade() const { return kind == EntryKind::TRADE; }
+    bool isSnapshot() const { return kind == EntryKind::DEPTH_SNAPSHOT; }
+    bool isAsk() const { return flags & IS_ASK; }
+    bool isLast() const { return flags & IS_LAST; }
+    bool isBuyerMarketMaker() const { return flags & IS_BUYER_MARKET_MAKER; }
+
+    DifferenceDepthEntry toDifferenceDepthEntry() const {
+        return {timestampOfReceive, symbol, isAsk(), priceTicks, quantityLots, isLast(), market, isSnapshot()};
+    }
+
+    TradeEntry toTradeEntry() const {
+        return {timestampOfReceive, symbol, price, quantity, isBuyerMarketMaker(), isLast(), market};
+    }
+};
+
+static_assert(sizeof(DecodedEntry) == 32, "DecodedEntry is meant to pack two per cache line");
+
+inline std::ostream& operator<<(std::ostream& os, DecodedEntry const& e) {
+    if (e.isTrade()) return os << e.toTradeEntry();
+    return os << e.toDifferenceDepthEntry();
+}
@@ -9,10 +9,11 @@ struct DifferenceDepthEntry {
     int64_t timestampOfReceive;
     Symbol symbol;
     bool isAsk;
-    double price;
-    double quantity;
+    int64_t priceTicks;
+    int64_t quantityLots;
     bool isLast;
     Market market;
+    bool isSnapshot{false};
     DifferenceDepthEntry* prev_;
     DifferenceDepthEntry* next_;
 
@@ -20,20 +21,22 @@ struct DifferenceDepthEntry {
         int64_t timestampOfReceive,
         Symbol symbol,
         bool isAsk,
-        double price,
-        double quantity,
+        int64_t priceTicks,
+        int64_t quantityLots,
         bool isLast,
         Market market,
+        bool isSnapshot = false,
         DifferenceDepthEntry* prev_ = nullptr,
         DifferenceDepthEntry* next_ = nullptr
     )
     : timestampOfReceive(timestampOfReceive)
     , symbol(symbol)
     , isAsk(isAsk)
-    , price(price)
-    , quantity(quantity)
+    , priceTicks(priceTicks)
+    , quantityLots(quantityLots)
     , isLast(isLast)
     , market(market)
+    , isSnapshot(isSnapshot)
     , prev_(prev_)
     , next_(next_)
     {}
@@ -48,9 +51,10 @@ inline std::ostream& operator<<(std::ostream& os, DifferenceDepthEntry const& e)
        << ", sym=" << int(e.symbol)
        << ", mkt=" << int(e.market)
        << ", isAsk=" << (e.isAsk?1:0)
-       << ", px=" << e.price
-       << ", qty=" << e.quantity
+       << ", pxTicks=" << e.priceTicks
+       << ", qtyLots=" << e.quantityLots
        << ", isLast=" << (e.isLast?1:0)
+       << ", isSnapshot=" << (e.isSnapshot?1:0)
        << "}";
     return os;
 }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <ostream>
+#include <cstdint>
+
+#include "StreamType.h"
+
+enum class EntryKind : uint8_t {
+    DIFFERENCE_DEPTH,
+    DEPTH_SNAPSHOT,
+    TRADE
+};
+
+inline std::ostream& operator<<(std::ostream& os, EntryKind k) {
+    switch(k) {
+    case EntryKind::DIFFERENCE_DEPTH: return os << "DIFFERENCE_DEPTH";
+    case EntryKind::DEPTH_SNAPSHOT:   return os << "DEPTH_SNAPSHOT";
+    case EntryKind::TRADE:            return os << "TRADE";
+    }
+    return os << int(k);
+}
+
+inline StreamType streamTypeOf(const EntryKind k) {
+    switch (k) {
+    case EntryKind::DIFFERENCE_DEPTH: return StreamType::DIFFERENCE_DEPTH_STREAM;
+    case EntryKind::DEPTH_SNAPSHOT:   return StreamType::DEPTH_SNAPSHOT;
+    case EntryKind::TRADE:            return StreamType::TRADE_STREAM;
+    }
+    return StreamType::UNKNOWN;
+}
+
+// FINAL_DEPTH_SNAPSHOT rows replay like any other snapshot.
+inline EntryKind entryKindOf(const StreamType s) {
+    switch (s) {
+    case StreamType::TRADE_STREAM:            return EntryKind::TRADE;
+    case StreamType::DIFFERENCE_DEPTH_STREAM: return EntryKind::DIFFERENCE_DEPTH;
+    default:                                  return EntryKind::DEPTH_SNAPSHOT;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ostream>
+#include <cstdint>
+
+enum class ParseStatus : uint8_t {
+    OK,
+    EMPTY_FIELD,
+    INVALID_CHARACTER,
+    OUT_OF_RANGE,
+    OFF_GRID,
+    MISSING_FIELD,
+    UNKNOWN_STREAM_TYPE,
+    UNKNOWN_MARKET
+};
+
+inline std::ostream& operator<<(std::ostream& os, ParseStatus s) {
+    switch(s) {
+    case ParseStatus::OK:                  return os << "OK";
+    case ParseStatus::EMPTY_FIELD:         return os << "EMPTY_FIELD";
+    case ParseStatus::INVALID_CHARACTER:   return os << "INVALID_CHARACTER";
+    case ParseStatus::OUT_OF_RANGE:        return os << "OUT_OF_RANGE";
+    case ParseStatus::OFF_GRID:            return os << "OFF_GRID";
+    case ParseStatus::MISSING_FIELD:       return os << "MISSING_FIELD";
+    case ParseStatus::UNKNOWN_STREAM_TYPE: return os << "UNKNOWN_STREAM_TYPE";
+    case ParseStatus::UNKNOWN_MARKET:      return os << "UNKNOWN_MARKET";
+    }
+    return os << int(s);
+}
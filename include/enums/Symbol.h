@@ -45,6 +45,58 @@ static constexpr std::array<const char*, SymbolEnCount> symbolEnNames = {{
     "SUIUSDT"
 }};
 
+// decimal places of the price tick, smallest tick across SPOT / USD-M / COIN-M
+static constexpr std::array<uint8_t, SymbolEnCount> symbolPricePrecisions = {{
+    8,  // UNKNOWN
+    2,  // BTCUSDT
+    2,  // ETHUSDT
+    2,  // BNBUSDT
+    2,  // SOLUSDT
+    4,  // XRPUSDT
+    5,  // DOGEUSDT
+    4,  // ADAUSDT
+    8,  // SHIBUSDT
+    2,  // LTCUSDT
+    3,  // AVAXUSDT
+    5,  // TRXUSDT
+    3,  // DOTUSDT
+    2,  // BCHUSDT
+    4   // SUIUSDT
+}};
+
+inline uint8_t pricePrecisionOf(Symbol s) {
+    auto idx = static_cast<size_t>(s);
+    if (idx < SymbolEnCount)
+        return symbolPricePrecisions[idx];
+    return symbolPricePrecisions[0];
+}
+
+// decimal places of the quantity step, smallest step across SPOT / USD-M / COIN-M
+static constexpr std::array<uint8_t, SymbolEnCount> symbolQuantityPrecisions = {{
+    8,  // UNKNOWN
+    5,  // BTCUSDT
+    4,  // ETHUSDT
+    3,  // BNBUSDT
+    3,  // SOLUSDT
+    1,  // XRPUSDT
+    0,  // DOGEUSDT
+    1,  // ADAUSDT
+    0,  // SHIBUSDT
+    3,  // LTCUSDT
+    2,  // AVAXUSDT
+    1,  // TRXUSDT
+    2,  // DOTUSDT
+    3,  // BCHUSDT
+    1   // SUIUSDT
+}};
+
+inline uint8_t quantityPrecisionOf(Symbol s) {
+    auto idx = static_cast<size_t>(s);
+    if (idx < SymbolEnCount)
+        return symbolQuantityPrecisions[idx];
+    return symbolQuantityPrecisions[0];
+}
+
 inline std::string to_string(Symbol s) {
     auto idx = static_cast<size_t>(s);
     if (idx < SymbolEnCount)
@@ -79,3 +79,22 @@ class TestDifferenceDepthEntry:
 
         for attr in expected_names:
             assert hasattr(e, attr), f"DifferenceDepthEntry is missing attribute '{attr}'"
+
+    def test_given_symbol_with_known_tick_size_when_price_set_then_integer_ticks_and_lots_are_exact(self):
+        e = DifferenceDepthEntry(
+            0,
+            Symbol.TRXUSDT,
+            1,
+            0.24589,
+            1250.3,
+            0,
+            Market.USD_M_FUTURES
+        )
+        assert e.price_ticks == 24589
+        assert e.quantity_lots == 12503
+        assert e.price == 0.24589
+        assert e.quantity == 1250.3
+
+        e.symbol = Symbol.UNKNOWN
+        assert e.price_ticks == 24589000
+        assert e.price == 0.24589
@@ -1,3 +1,4 @@
+import pickle
 from types import NoneType
 
 import cpp_binance_orderbook
@@ -1575,3 +1576,79 @@ class TestGlobalMarketState:
             assert x4.volumeImbalance == 0.04504504504504504
             assert x4.gap == -0.30000000000000426
             assert x4.isAggressorAsk == 0
+
+    class TestCheckpoint:
+
+        def test_given_two_assets_with_pending_snapshot_when_pickled_mid_replay_then_restored_metrics_match_uninterrupted_replay(self):
+            variables = [
+                "timestampOfReceive",
+                "bestAskPrice",
+                "bestBidPrice",
+                "midPrice",
+                "gap",
+                "priceDifference60Seconds",
+                "rsi5Seconds",
+                "stochRsi5Seconds",
+                "macd2Seconds"
+            ]
+            start = 1750489120_000_000
+            assets = [(Symbol.BTCUSDT, 100.0), (Symbol.TRXUSDT, 0.25)]
+
+            def depth(i, symbol, is_ask, price, quantity, is_last=True, is_snapshot=False):
+                e = DifferenceDepthEntry(
+                    timestamp_of_receive=start + i * 500_000,
+                    symbol=symbol,
+                    is_ask=is_ask,
+                    price=price,
+                    quantity=quantity,
+                    is_last=is_last,
+                    market=Market.USD_M_FUTURES
+                )
+                e.is_snapshot = is_snapshot
+                return e
+
+            entries = []
+            for i in range(400):
+                symbol, base = assets[i % 2]
+                step = base / 1000
+                if i == 200:
+                    # BTCUSDT snapshot; the checkpoint falls between its first and second row
+                    entries += [
+                        depth(i, symbol, True, base + 2 * step, 1.0, is_last=False, is_snapshot=True),
+                        depth(i, symbol, False, base - 2 * step, 2.0, is_last=False, is_snapshot=True),
+                        depth(i, symbol, False, base - 3 * step, 3.0, is_last=True, is_snapshot=True),
+                    ]
+                    continue
+                is_ask = i % 4 < 2
+                entries.append(depth(i, symbol, is_ask, base + (1 if is_ask else -1) * (1 + i % 5) * step, 1.0 + i % 3))
+                entries.append(
+                    TradeEntry(
+                        timestamp_of_receive=start + i * 500_000 + 1,
+                        symbol=symbol,
+                        price=base + (i * 37 % 11 - 5) * step / 10,
+                        quantity=1.0,
+                        is_buyer_market_maker=i % 3 == 0,
+                        is_last=True,
+                        market=Market.USD_M_FUTURES
+                    )
+                )
+
+            def replay(checkpoint_at):
+                gms = GlobalMarketState(variables)
+                rows = []
+                for n, entry in enumerate(entries):
+                    if n == checkpoint_at:
+                        gms = pickle.loads(pickle.dumps(gms))
+                    gms.update(entry)
+                    row = gms.count_market_state_metrics_by_entry(entry)
+                    rows.append(None if row is None else [getattr(row, variable) for variable in variables])
+                return gms, rows
+
+            uninterrupted, expected_rows = replay(checkpoint_at=None)
+            restored, rows = replay(checkpoint_at=401)
+
+            assert rows == expected_rows
+            assert len(restored) == len(uninterrupted) == 2
+            for symbol, _ in assets:
+                assert [(lvl.price, lvl.quantity) for lvl in restored.get_market_state(symbol, Market.USD_M_FUTURES).order_book.bids()] \
+                    == [(lvl.price, lvl.quantity) for lvl in uninterrupted.get_market_state(symbol, Market.USD_M_FUTURES).order_book.bids()]
@@ -1,8 +1,13 @@
+import pickle
+
 from cpp_binance_orderbook import (
     MarketState,
     DifferenceDepthEntry,
     TradeEntry,
-    OrderBookMetricsCalculator
+    OrderBookMetricsCalculator,
+    Market,
+    Symbol,
+    single_variable_counter as svc
 )
 
 
@@ -969,3 +974,112 @@ class TestMarketState:
             assert entry.gap == 0.0
             assert entry.isAggressorAsk is True
             assert entry.timestampOfReceive == trade_ts
+
+    class TestCheckpoint:
+
+        @staticmethod
+        def depth_entry(timestamp_of_receive, is_ask, price, quantity, is_last=True, is_snapshot=False):
+            e = DifferenceDepthEntry(
+                timestamp_of_receive=timestamp_of_receive,
+                symbol=Symbol.BTCUSDT,
+                is_ask=is_ask,
+                price=price,
+                quantity=quantity,
+                is_last=is_last,
+                market=Market.USD_M_FUTURES
+            )
+            e.is_snapshot = is_snapshot
+            return e
+
+        @staticmethod
+        def levels(ms):
+            return (
+                [(lvl.price, lvl.quantity) for lvl in ms.order_book.asks()],
+                [(lvl.price, lvl.quantity) for lvl in ms.order_book.bids()]
+            )
+
+        def test_given_unflushed_snapshot_when_pickled_and_restored_then_snapshot_completes_like_uninterrupted(self):
+            ms = MarketState(Market.USD_M_FUTURES, Symbol.BTCUSDT)
+            ms.update(self.depth_entry(1, True, 150.0, 1.0))
+            ms.update(self.depth_entry(2, False, 50.0, 1.0))
+
+            snapshot = [
+                self.depth_entry(3, True, 101.0, 1.0, is_last=False, is_snapshot=True),
+                self.depth_entry(3, True, 102.0, 2.0, is_last=False, is_snapshot=True),
+                self.depth_entry(3, False, 100.0, 3.0, is_last=False, is_snapshot=True),
+                self.depth_entry(3, False, 99.0, 4.0, is_last=True, is_snapshot=True),
+            ]
+            for e in snapshot[:-1]:
+                ms.update(e)
+
+            # the snapshot is still pending: the book holds the rows from before it
+            restored = pickle.loads(pickle.dumps(ms))
+            assert self.levels(restored) == ([(150.0, 1.0)], [(50.0, 1.0)])
+
+            ms.update(snapshot[-1])
+            restored.update(snapshot[-1])
+
+            expected = ([(101.0, 1.0), (102.0, 2.0)], [(100.0, 3.0), (99.0, 4.0)])
+            assert self.levels(ms) == expected
+            assert self.levels(restored) == expected
+            assert restored.symbol == Symbol.BTCUSDT
+            assert restored.market == Market.USD_M_FUTURES
+
+        def test_given_bounded_depth_book_with_overflow_when_pickled_and_restored_then_overflow_levels_are_promoted_like_uninterrupted(self):
+            ms = MarketState(Market.USD_M_FUTURES, Symbol.BTCUSDT, 2)
+            for i, price in enumerate([100.0, 99.0, 98.0, 97.0, 96.0]):
+                ms.update(self.depth_entry(i + 1, False, price, i + 1.0))
+            for i, price in enumerate([101.0, 102.0, 103.0]):
+                ms.update(self.depth_entry(i + 6, True, price, 1.0))
+
+            restored = pickle.loads(pickle.dumps(ms))
+            assert restored.order_book.depth_limit() == 2
+            assert self.levels(restored) == ([(101.0, 1.0), (102.0, 1.0)], [(100.0, 1.0), (99.0, 2.0)])
+
+            # removing the tracked bids brings the overflow levels into the book
+            for book in (ms, restored):
+                book.update(self.depth_entry(9, False, 100.0, 0.0))
+                book.update(self.depth_entry(10, False, 99.0, 0.0))
+                book.update(self.depth_entry(11, True, 101.0, 0.0))
+
+            expected = ([(102.0, 1.0), (103.0, 1.0)], [(98.0, 3.0), (97.0, 4.0)])
+            assert self.levels(ms) == expected
+            assert self.levels(restored) == expected
+            assert restored.order_book.sum_bid_quantity() == ms.order_book.sum_bid_quantity()
+
+        def test_given_rolling_and_indicator_state_when_pickled_mid_replay_then_restored_state_matches_uninterrupted_replay(self):
+            start = 1750489120_000_000
+            trades = [
+                TradeEntry(
+                    timestamp_of_receive=start + i * 700_000,
+                    symbol=Symbol.BTCUSDT,
+                    price=100.0 + (i * 37 % 11) * 0.1,
+                    quantity=1.0 + i % 5,
+                    is_buyer_market_maker=i % 3 == 0,
+                    is_last=True,
+                    market=Market.USD_M_FUTURES
+                )
+                for i in range(600)
+            ]
+            depth = [self.depth_entry(trade.timestamp_of_receive + 1, i % 2 == 0, 100.0 + i % 7, 1.0) for i, trade in enumerate(trades)]
+
+            ms = MarketState(Market.USD_M_FUTURES, Symbol.BTCUSDT)
+            restored = None
+            for i, (trade, level) in enumerate(zip(trades, depth)):
+                if i == 300:
+                    restored = pickle.loads(pickle.dumps(ms))
+                for book in (ms,) if restored is None else (ms, restored):
+                    book.update(trade)
+                    book.update(level)
+
+            for candle_seconds in (2, 5):
+                assert svc.calculate_rsi(restored.rolling_trade_statistics, candle_seconds) == svc.calculate_rsi(ms.rolling_trade_statistics, candle_seconds)
+                assert svc.calculate_stoch_rsi(restored.rolling_trade_statistics, candle_seconds) == svc.calculate_stoch_rsi(ms.rolling_trade_statistics, candle_seconds)
+                assert svc.calculate_macd(restored.rolling_trade_statistics, candle_seconds) == svc.calculate_macd(ms.rolling_trade_statistics, candle_seconds)
+            for window in (1, 5, 60, 200, 3600):
+                for statistic in ("buy_trade_count", "sell_trade_volume", "price_difference", "oldest_price", "simple_moving_average"):
+                    assert getattr(restored.rolling_trade_statistics, statistic)(window) == getattr(ms.rolling_trade_statistics, statistic)(window)
+                assert restored.rolling_difference_depth_statistics.bid_difference_depth_entry_count(window) == ms.rolling_difference_depth_statistics.bid_difference_depth_entry_count(window)
+                assert restored.rolling_difference_depth_statistics.ask_difference_depth_entry_count(window) == ms.rolling_difference_depth_statistics.ask_difference_depth_entry_count(window)
+            assert restored.last_trade.price == ms.last_trade.price
+            assert restored.last_timestamp_of_receive == ms.last_timestamp_of_receive
@@ -644,3 +644,147 @@ class TestOrderBook:
             ob.update(e)
             assert ob.delta_sum_bid_quantity() == pytest.approx(6.0, abs=1e-12)
             assert ob.delta_sum_ask_quantity() == pytest.approx(0.0, abs=1e-12)
+
+    class TestBoundedDepthOrderBook:
+
+        @staticmethod
+        def _entry(price, quantity, is_ask):
+            return DifferenceDepthEntry(
+                timestamp_of_receive=1,
+                symbol=Symbol.ADAUSDT,
+                is_ask=is_ask,
+                price=price,
+                quantity=quantity,
+                is_last=0,
+                market=Market.USD_M_FUTURES
+            )
+
+        def test_given_depth_limit_when_levels_overflow_then_only_top_levels_are_kept_and_sums_stay_exact(self):
+            ob = OrderBook(Symbol.ADAUSDT, depth_limit=3)
+            for price, qty in [(1.5, 1.0), (1.1, 2.0), (1.4, 3.0), (1.2, 4.0), (1.3, 5.0)]:
+                ob.update(self._entry(price, qty, 1))
+
+            assert [lvl.price for lvl in ob.asks()] == [1.1, 1.2, 1.3]
+            assert ob.ask_count() == 5
+            assert ob.sum_ask_quantity() == 15.0
+            assert ob.sum_of_price_times_quantity() == pytest.approx(1.5 + 2.2 + 4.2 + 4.8 + 6.5, abs=1e-12)
+
+        def test_given_depth_limit_when_tracked_level_removed_then_best_overflow_level_is_promoted(self):
+            ob = OrderBook(Symbol.ADAUSDT, depth_limit=2)
+            for price, qty in [(1.1, 1.0), (1.2, 2.0), (1.4, 3.0), (1.3, 4.0)]:
+                ob.update(self._entry(price, qty, 1))
+
+            ob.update(self._entry(1.1, 0.0, 1))
+
+            assert [(lvl.price, lvl.quantity) for lvl in ob.asks()] == [(1.2, 2.0), (1.3, 4.0)]
+            assert ob.ask_count() == 3
+            assert ob.sum_ask_quantity() == 9.0
+
+    class TestApplyBatch:
+
+        def test_given_unsorted_depth_message_when_apply_batch_then_book_and_deltas_match_row_by_row_updates(self):
+            rows = [
+                (1, 1.3, 2.0), (1, 1.1, 1.0), (0, 0.9, 4.0), (1, 1.2, 3.0),
+                (0, 1.0, 5.0), (1, 1.1, 0.0), (0, 0.8, 6.0),
+            ]
+
+            def make_group():
+                return [
+                    DifferenceDepthEntry(
+                        timestamp_of_receive=10,
+                        symbol=Symbol.ADAUSDT,
+                        is_ask=is_ask,
+                        price=price,
+                        quantity=qty,
+                        is_last=1 if i == len(rows) - 1 else 0,
+                        market=Market.USD_M_FUTURES
+                    )
+                    for i, (is_ask, price, qty) in enumerate(rows)
+                ]
+
+            row_by_row = OrderBook()
+            for e in make_group():
+                row_by_row.update(e)
+
+            batched = OrderBook()
+            batched.apply_batch(make_group())
+
+            assert [(l.price, l.quantity) for l in batched.asks()] == [(l.price, l.quantity) for l in row_by_row.asks()]
+            assert [(l.price, l.quantity) for l in batched.bids()] == [(l.price, l.quantity) for l in row_by_row.bids()]
+            assert batched.delta_best_ask_price() == row_by_row.delta_best_ask_price()
+            assert batched.delta_sum_bid_quantity() == row_by_row.delta_sum_bid_quantity()
+
+    class TestLoadSnapshot:
+
+        def test_given_existing_book_when_load_snapshot_then_book_is_replaced_by_sorted_snapshot_levels(self):
+            ob = OrderBook()
+            stale = DifferenceDepthEntry()
+            stale.price = 20.0
+            stale.quantity = 1.0
+            stale.is_ask = True
+            ob.update(stale)
+
+            levels = []
+            for is_ask, price, qty in [(0, 9.0, 1.0), (0, 8.5, 2.0), (0, 8.0, 3.0), (1, 10.0, 4.0), (1, 10.5, 5.0)]:
+                e = DifferenceDepthEntry()
+                e.price = price
+                e.quantity = qty
+                e.is_ask = is_ask
+                e.is_snapshot = True
+                levels.append(e)
+            levels[-1].is_last = True
+
+            ob.load_snapshot(levels)
+
+            assert [(l.price, l.quantity) for l in ob.asks()] == [(10.0, 4.0), (10.5, 5.0)]
+            assert [(l.price, l.quantity) for l in ob.bids()] == [(9.0, 1.0), (8.5, 2.0), (8.0, 3.0)]
+            assert ob.ask_count() == 2
+            assert ob.sum_ask_quantity() == 9.0
+            assert ob.sum_bid_quantity() == 6.0
+
+        def test_given_repeated_price_in_snapshot_when_load_snapshot_in_either_order_then_later_row_wins(self):
+            def snapshot(rows):
+                levels = []
+                for is_ask, price, qty in rows:
+                    e = DifferenceDepthEntry()
+                    e.price = price
+                    e.quantity = qty
+                    e.is_ask = is_ask
+                    e.is_snapshot = True
+                    levels.append(e)
+                levels[-1].is_last = True
+                return levels
+
+            worst_first = OrderBook()
+            worst_first.load_snapshot(snapshot([(0, 99.0, 1.0), (0, 100.0, 1.0), (0, 100.0, 2.0),
+                                                (1, 102.0, 1.0), (1, 101.0, 1.0), (1, 101.0, 2.0)]))
+            best_first = OrderBook()
+            best_first.load_snapshot(snapshot([(0, 100.0, 1.0), (0, 100.0, 2.0), (0, 99.0, 1.0),
+                                               (1, 101.0, 1.0), (1, 101.0, 2.0), (1, 102.0, 1.0)]))
+
+            for ob in (worst_first, best_first):
+                assert [(l.price, l.quantity) for l in ob.bids()] == [(100.0, 2.0), (99.0, 1.0)]
+                assert [(l.price, l.quantity) for l in ob.asks()] == [(101.0, 2.0), (102.0, 1.0)]
+                assert ob.sum_bid_quantity() == 3.0
+                assert ob.sum_ask_quantity() == 3.0
+
+    class TestCheckpoint:
+
+        def test_given_order_book_when_pickled_and_restored_then_levels_sums_and_deltas_are_preserved(self):
+            import pickle
+
+            ob = OrderBook()
+            for is_ask, price, qty in [(1, 10.0, 1.0), (1, 10.5, 2.0), (0, 9.5, 3.0), (0, 9.0, 4.0)]:
+                e = DifferenceDepthEntry()
+                e.price = price
+                e.quantity = qty
+                e.is_ask = is_ask
+                e.is_last = 1
+                ob.update(e)
+
+            restored = pickle.loads(pickle.dumps(ob))
+
+            assert [(l.price, l.quantity) for l in restored.asks()] == [(l.price, l.quantity) for l in ob.asks()]
+            assert [(l.price, l.quantity) for l in restored.bids()] == [(l.price, l.quantity) for l in ob.bids()]
+            assert restored.sum_of_price_times_quantity() == ob.sum_of_price_times_quantity()
+            assert restored.delta_sum_bid_quantity() == ob.delta_sum_bid_quantity()
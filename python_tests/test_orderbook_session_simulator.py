@@ -489,6 +489,183 @@ class TestOrderBookSessionSimulator:
             for col in df.columns:
                 assert not df[col].isnull().all(), f"Column `{col}` contains only NaN values"
 
+    class TestOrderBookSessionSimulatorEventFile:
+
+        def test_given_merged_csv_converted_to_event_file_when_compute_variables_then_result_equals_csv_result(self, tmp_path):
+            import cpp_binance_orderbook
+
+            csv_path = "csv/test_positive_binance_merged_depth_snapshot_difference_depth_stream_trade_stream_usd_m_futures_trxusdt_14-04-2025.csv"
+            event_path = str(tmp_path / "merged.obev")
+
+            cpp_binance_orderbook.convert_csv_to_event_file(csv_path, event_path)
+            assert cpp_binance_orderbook.is_event_file(event_path)
+            assert not cpp_binance_orderbook.is_event_file(csv_path)
+
+            oss = cpp_binance_orderbook.OrderBookSessionSimulator()
+            from_csv = pd.DataFrame(oss.compute_variables(csv_path=csv_path, variables=ALL_ORDERBOOK_VARIABLES))
+            from_event_file = pd.DataFrame(oss.compute_variables(csv_path=event_path, variables=ALL_ORDERBOOK_VARIABLES))
+
+            pd.testing.assert_frame_equal(from_csv, from_event_file)
+
+    class TestOrderBookSessionSimulatorEventArchive:
+
+        def test_given_merged_csv_converted_to_event_archive_when_compute_variables_then_result_equals_csv_result(self, tmp_path):
+            import cpp_binance_orderbook
+
+            csv_path = "csv/test_positive_binance_merged_depth_snapshot_difference_depth_stream_trade_stream_usd_m_futures_trxusdt_14-04-2025.csv"
+            archive_path = str(tmp_path / "merged.obea")
+
+            cpp_binance_orderbook.convert_csv_to_event_archive(csv_path, archive_path)
+            assert cpp_binance_orderbook.is_event_archive(archive_path)
+            assert not cpp_binance_orderbook.is_event_archive(csv_path)
+
+            oss = cpp_binance_orderbook.OrderBookSessionSimulator()
+            from_csv = pd.DataFrame(oss.compute_variables(csv_path=csv_path, variables=ALL_ORDERBOOK_VARIABLES))
+            from_event_archive = pd.DataFrame(oss.compute_variables(csv_path=archive_path, variables=ALL_ORDERBOOK_VARIABLES))
+
+            pd.testing.assert_frame_equal(from_csv, from_event_archive)
+
+    class TestOrderBookSessionSimulatorComputeVariablesOverDays:
+
+        @staticmethod
+        def _shifted_lines(lines, shift):
+            return [f"{int(line.split(',', 1)[0]) + shift},{line.split(',', 1)[1]}" if line.split(",", 1)[0].isdigit() else line for line in lines]
+
+        def test_given_two_day_files_when_compute_variables_over_days_then_state_carries_over_the_boundary(self, tmp_path):
+            import cpp_binance_orderbook
+
+            csv_path = "csv/test_positive_binance_merged_depth_snapshot_difference_depth_stream_trade_stream_usd_m_futures_trxusdt_14-04-2025.csv"
+            lines = Path(csv_path).read_text().splitlines()
+            timestamps = [int(line.split(",", 1)[0]) for line in lines if line.split(",", 1)[0].isdigit()]
+            header = [line for line in lines if not line.split(",", 1)[0].isdigit()]
+
+            # day 2 is the fixture one day later; day 1 is the same rows moved to end just before day 2 starts
+            day_two_shift = 86_400_000_000
+            day_one_shift = day_two_shift - (timestamps[-1] - timestamps[0]) - 1
+            day_one = self._shifted_lines(lines, day_one_shift)
+            day_two = self._shifted_lines(lines, day_two_shift)
+            day_paths = [tmp_path / "day_1.csv", tmp_path / "day_2.csv"]
+            day_paths[0].write_text("\n".join(day_one) + "\n")
+            day_paths[1].write_text("\n".join(day_two) + "\n")
+            concatenated_path = tmp_path / "days_1_2.csv"
+            concatenated_path.write_text("\n".join(day_one + [line for line in day_two if line not in header]) + "\n")
+
+            oss = cpp_binance_orderbook.OrderBookSessionSimulator()
+            two_days = pd.DataFrame(oss.compute_variables_over_days(day_paths=[str(p) for p in day_paths], variables=ALL_ORDERBOOK_VARIABLES))
+            concatenated = pd.DataFrame(oss.compute_variables(csv_path=str(concatenated_path), variables=ALL_ORDERBOOK_VARIABLES))
+            day_two_alone = pd.DataFrame(oss.compute_variables(csv_path=str(day_paths[1]), variables=ALL_ORDERBOOK_VARIABLES))
+
+            pd.testing.assert_frame_equal(two_days, concatenated)
+
+            day_two_start = timestamps[0] + day_two_shift
+            first_day_two_row = two_days[two_days["timestampOfReceive"] >= day_two_start].iloc[0]
+            assert first_day_two_row["bestBidPrice"] > 0 and first_day_two_row["bestAskPrice"] > 0
+            # the rolling windows already hold the end of day 1, and the book and last trade let
+            # day 2 emit rows before its own first trade
+            assert first_day_two_row["tradeCount60Seconds"] > 0
+            assert first_day_two_row["differenceDepthCount60Seconds"] > 0
+            assert first_day_two_row["timestampOfReceive"] < day_two_alone["timestampOfReceive"].iloc[0]
+
+    class TestOrderBookSessionSimulatorComputeVariablesTimeRange:
+
+        def test_given_start_and_end_when_compute_variables_then_result_equals_full_day_rows_in_range(self, tmp_path):
+            import cpp_binance_orderbook
+
+            csv_path = tmp_path / "merged.csv"
+            csv_path.write_bytes(Path("csv/test_positive_binance_merged_depth_snapshot_difference_depth_stream_trade_stream_usd_m_futures_trxusdt_14-04-2025.csv").read_bytes())
+
+            oss = cpp_binance_orderbook.OrderBookSessionSimulator()
+            full_day = pd.DataFrame(oss.compute_variables(csv_path=str(csv_path), variables=ALL_ORDERBOOK_VARIABLES))
+            start = int(full_day["timestampOfReceive"].quantile(0.4))
+            end = int(full_day["timestampOfReceive"].quantile(0.6))
+
+            sliced = pd.DataFrame(oss.compute_variables(csv_path=str(csv_path), variables=ALL_ORDERBOOK_VARIABLES, start_timestamp=start, end_timestamp=end))
+            expected = full_day[(full_day["timestampOfReceive"] >= start) & (full_day["timestampOfReceive"] < end)].reset_index(drop=True)
+
+            assert len(sliced) > 0
+            assert (tmp_path / "merged.csv.tsidx").exists()
+            pd.testing.assert_frame_equal(sliced, expected)
+
+        def test_given_asset_whose_last_trade_is_before_its_snapshot_when_compute_variables_then_slice_keeps_its_last_trade(self, tmp_path):
+            import cpp_binance_orderbook
+
+            # TRXUSDT trades once, gets a fresh snapshot and then only depth updates; BTCUSDT
+            # fills several index strides and is snapshotted again well before start
+            ts0 = 1744588800000000
+            second = 1_000_000
+
+            def snapshot(ts, symbol, mid, tick):
+                levels = [(is_ask, f"{mid + (i if is_ask else -i) * tick:.5f}", f"{10 + i}.0") for i in range(1, 21) for is_ask in (1, 0)]
+                return [f"{ts},{symbol},{a},{p},{q},,3,2,{int(i == len(levels) - 1)}" for i, (a, p, q) in enumerate(levels)]
+
+            rows = snapshot(ts0, 1, 60000.0, 0.1) + snapshot(ts0, 11, 0.25, 1e-5)
+            rows += [f"{ts0 + second},11,,0.25001,5.0,0,2,2,1", f"{ts0 + second},1,,60000.1,0.5,1,2,2,1"]
+            rows += snapshot(ts0 + 2 * second, 11, 0.25, 1e-5)
+            for k in range(3 * 20, 4000 * 20):
+                ts = ts0 + k * second // 20
+                if k == 2500 * 20:
+                    rows += snapshot(ts, 1, 60000.0, 0.1)
+                rows.append(f"{ts},1,{k % 2},{60000.0 + ((k % 7) + 1) * (0.1 if k % 2 else -0.1):.1f},{k % 5}.0,,1,2,1")
+                if k % 4 == 0:
+                    rows.append(f"{ts + 1},1,,{60000.0 + (k % 3 - 1) * 0.1:.1f},{1 + k % 4}.0,{k % 2},2,2,1")
+                if k % 200 == 0:
+                    rows.append(f"{ts + 2},11,{k // 200 % 2},{0.25 + ((k % 7) + 1) * (1 if k // 200 % 2 else -1) * 1e-5:.5f},{k % 5}.0,,1,2,1")
+
+            csv_path = tmp_path / "merged.csv"
+            csv_path.write_text("TimestampOfReceiveUS,Symbol,IsAsk,Price,Quantity,IsBuyerMarketMaker,StreamType,Market,IsLast\n" + "\n".join(rows) + "\n")
+
+            oss = cpp_binance_orderbook.OrderBookSessionSimulator()
+            full_day = pd.DataFrame(oss.compute_variables(csv_path=str(csv_path), variables=ALL_ORDERBOOK_VARIABLES))
+            start = ts0 + 3500 * second
+            end = ts0 + 3900 * second
+
+            sliced = pd.DataFrame(oss.compute_variables(csv_path=str(csv_path), variables=ALL_ORDERBOOK_VARIABLES, start_timestamp=start, end_timestamp=end))
+            expected = full_day[(full_day["timestampOfReceive"] >= start) & (full_day["timestampOfReceive"] < end)].reset_index(drop=True)
+
+            assert expected["symbol"].nunique() == 2
+            pd.testing.assert_frame_equal(sliced, expected)
+
+    class TestOrderBookSessionSimulatorRawFilesMerge:
+
+        @staticmethod
+        def _write_raw_files_and_merged_csv(directory):
+            ts0 = 1744588800000000
+            snapshot = [(ts0, is_ask, f"{0.25 + (i if is_ask else -i) * 1e-5:.5f}", f"{10 + i}.0") for i in range(1, 30) for is_ask in (1, 0)]
+            diff = [(ts0 + k * 3000, k % 2, f"{0.25 + ((k % 7) + 1) * (1 if k % 2 else -1) * 1e-5:.5f}", f"{k % 5}.0") for k in range(1, 400) for _ in range(1 + k % 3)]
+            trades = [(ts0 + k * 7000 + 1, f"{0.25 + (k % 3 - 1) * 1e-5:.5f}", f"{1 + k % 4}.0", k % 2) for k in range(1, 150)]
+
+            paths = [
+                directory / "binance_depth_snapshot_usd_m_futures_trxusdt_14-04-2025.csv",
+                directory / "binance_difference_depth_stream_usd_m_futures_trxusdt_14-04-2025.csv",
+                directory / "binance_trade_stream_usd_m_futures_trxusdt_14-04-2025.csv",
+            ]
+            paths[0].write_text("TimestampOfRequest,TimestampOfReceive,MessageOutputTime,TransactionTime,LastUpdateId,IsAsk,Price,Quantity\n"
+                                + "".join(f"{ts},{ts},0,0,1,{a},{p},{q}\n" for ts, a, p, q in snapshot))
+            paths[1].write_text("TimestampOfReceive,Stream,EventType,EventTime,TransactionTime,Symbol,FirstUpdateId,FinalUpdateId,FinalUpdateIdInLastStream,IsAsk,Price,Quantity,PSUnknownField\n"
+                                + "".join(f"{ts},s,depthUpdate,0,0,TRXUSDT,1,1,1,{a},{p},{q},\n" for ts, a, p, q in diff))
+            paths[2].write_text("TimestampOfReceive,Stream,EventType,EventTime,TransactionTime,Symbol,TradeId,Price,Quantity,IsBuyerMarketMaker,MUnknownParameter\n"
+                                + "".join(f"{ts},s,trade,0,0,TRXUSDT,1,{p},{q},{m},MARKET\n" for ts, p, q, m in trades))
+
+            rows = ([(ts, 0, i, f"{ts},11,{a},{p},{q},,3,2", i == len(snapshot) - 1) for i, (ts, a, p, q) in enumerate(snapshot)]
+                    + [(ts, 1, i, f"{ts},11,{a},{p},{q},,1,2", i == len(diff) - 1 or diff[i + 1][0] != ts) for i, (ts, a, p, q) in enumerate(diff)]
+                    + [(ts, 2, i, f"{ts},11,,{p},{q},{m},2,2", True) for i, (ts, p, q, m) in enumerate(trades)])
+            merged_path = directory / "merged.csv"
+            merged_path.write_text("TimestampOfReceiveUS,Symbol,IsAsk,Price,Quantity,IsBuyerMarketMaker,StreamType,Market,IsLast\n"
+                                   + "".join(f"{row},{int(is_last)}\n" for _, _, _, row, is_last in sorted(rows, key=lambda r: r[:3])))
+            return [str(p) for p in paths], str(merged_path)
+
+        def test_given_raw_snapshot_diff_and_trade_files_when_compute_variables_then_result_equals_merged_csv_result(self, tmp_path):
+            import cpp_binance_orderbook
+
+            raw_paths, merged_path = self._write_raw_files_and_merged_csv(tmp_path)
+
+            oss = cpp_binance_orderbook.OrderBookSessionSimulator()
+            from_merged = pd.DataFrame(oss.compute_variables(csv_path=merged_path, variables=ALL_ORDERBOOK_VARIABLES))
+            from_raw = pd.DataFrame(oss.compute_variables(csv_paths=raw_paths, variables=ALL_ORDERBOOK_VARIABLES))
+
+            assert len(from_raw) > 0
+            pd.testing.assert_frame_equal(from_merged, from_raw)
+
     class TestParseMask:
 
         def test_given_variables_list_when_parse_mask_then_accurate_bytes_are_returned(self):
@@ -1,3 +1,4 @@
+import pytest
 import cpp_binance_orderbook
 
 from cpp_binance_orderbook import (
@@ -258,6 +259,61 @@ class TestSingleVariableCounter:
         assert svc.calculate_cumulative_delta(market_state.rolling_trade_statistics, 30) == 16.5397
         assert svc.calculate_cumulative_delta(market_state.rolling_trade_statistics, 60) == 26.8995
 
+    def test_rolling_trade_statistics_window_snapshot_equals_single_window_queries(self):
+        market_state = self.get_sample_order_book(
+            symbol=Symbol.ADAUSDT,
+            market=Market.USD_M_FUTURES,
+            price_hash=3,
+            quantity_hash=2.1799
+        )
+        statistics = market_state.rolling_trade_statistics
+        windows = [0, 1, 3, 5, 10, 15, 30, 60, 136, 500]
+
+        snapshot = statistics.window_snapshot(windows)
+
+        assert len(snapshot) == len(windows)
+        for window, totals in zip(windows, snapshot):
+            assert totals.buy_trade_count == statistics.buy_trade_count(window)
+            assert totals.sell_trade_count == statistics.sell_trade_count(window)
+            assert totals.buy_trade_volume == statistics.buy_trade_volume(window)
+            assert totals.sell_trade_volume == statistics.sell_trade_volume(window)
+        assert len(statistics.window_snapshot()) == 7
+
+    def test_rolling_trade_statistics_sub_second_and_long_windows(self):
+        market_state = self.get_sample_order_book(
+            symbol=Symbol.ADAUSDT,
+            market=Market.USD_M_FUTURES,
+            price_hash=3,
+            quantity_hash=2.1799
+        )
+        statistics = market_state.rolling_trade_statistics
+
+        # 100 ms slots: only the trade at t, the one at t-1.000001s is in the 258.9 slot
+        assert statistics.buy_trade_count(0.5) == 0
+        assert statistics.sell_trade_count(0.5) == 1
+        assert statistics.buy_trade_count(2) == 1
+        assert statistics.sell_trade_count(2) == 1
+        # 1 min slots: every trade of the sample
+        assert statistics.buy_trade_count(1800) == 9
+        assert statistics.sell_trade_count(1800) == 18
+
+    def test_price_difference_when_last_price_is_older_than_price_lookback_then_returns_zero(self):
+        market_state = cpp_binance_orderbook.MarketState()
+        start = 1750489120_000_000
+        for seconds, price in [(0, 10.0), (100, 11.0), (200, 12.0)]:
+            market_state.update(TradeEntry(start + seconds * 1_000_000, Symbol.ADAUSDT, price, 1.0, False, True, Market.USD_M_FUTURES))
+        statistics = market_state.rolling_trade_statistics
+
+        # a 100 s gap: the price at t-60s is the one from t-100s
+        assert statistics.oldest_price(60) == 11.0
+        assert statistics.price_difference(60) == 1.0
+
+        # a 200 s gap is past RollingTradeStatistics::PRICE_LOOKBACK_MICROS (136 s): no price
+        market_state.update(TradeEntry(start + 400 * 1_000_000, Symbol.ADAUSDT, 13.0, 1.0, False, True, Market.USD_M_FUTURES))
+        assert statistics.oldest_price(60) == 0.0
+        assert statistics.price_difference(60) == 0.0
+        assert statistics.price_difference(1) == 0.0
+
     def test_calculate_price_difference_n_seconds(self):
         market_state = self.get_sample_order_book(
             symbol=Symbol.ADAUSDT,
@@ -324,52 +380,18 @@ class TestSingleVariableCounter:
         )
 
         '''
-            rsi 5s, 14 periods:
-            
-            diff_i: (gainSum += diff_i): 5 1.1
-            diff_i: (gainSum += diff_i): 10 0.2
-            diff_i: (gainSum += diff_i): 15 0.1
-            diff_i: (lossSum += -diff_i): 20 -0.2
-            diff_i: (lossSum += -diff_i): 25 0
-            diff_i: (lossSum += -diff_i): 30 0
-            diff_i: (lossSum += -diff_i): 35 -4.2
-            diff_i: (lossSum += -diff_i): 40 0
-            diff_i: (lossSum += -diff_i): 45 0
-            diff_i: (lossSum += -diff_i): 50 0
-            diff_i: (lossSum += -diff_i): 55 0
-            diff_i: (lossSum += -diff_i): 60 0
-            diff_i: (lossSum += -diff_i): 65 -3.1
-            diff_i: (gainSum += diff_i): 70 9
+            Candles close at the last trade price before their end, a candle without trades
+            at the previous close; the candle holding the last trade (t = ...260 s) is still open.
             
-            avgGain = 0.742857
-            avgLoss = 0.535714
-            periods = 14
+            5s candles ...120 - ...255: 28 closes, 27 changes
+            first 14 changes seed avgGain / avgLoss with their mean,
+            then avg = (avg * 13 + change) / 14 (Wilder)
             
-            rs = 1.38667
-            rsi = 100-(100/1+rs) = 58.10061...
-        '''
-        assert svc.calculate_rsi(market_state.rolling_trade_statistics, 0, 5) == 58.100558659217874
+            rsi = 100 - 100 / (1 + avgGain / avgLoss) = 49.83
         '''
-            diff_i: (gainSum += diff_i): 4 0.1
-            diff_i: (gainSum += diff_i): 6 0.2
-            diff_i: (gainSum += diff_i): 8 0.1
-            diff_i: (lossSum += -diff_i): 10 0
-            diff_i: (gainSum += diff_i): 12 0.1
-            diff_i: (lossSum += -diff_i): 14 0
-            diff_i: (lossSum += -diff_i): 16 0
-            diff_i: (lossSum += -diff_i): 18 -0.2
-            diff_i: (lossSum += -diff_i): 20 0
-            diff_i: (lossSum += -diff_i): 22 0
-            diff_i: (lossSum += -diff_i): 24 0
-            diff_i: (lossSum += -diff_i): 26 0
-            diff_i: (lossSum += -diff_i): 28 0
-            avgGain = 0.1
-            avgLoss = 0.0142857
-            periods = 14
-            rs = 7
-            rsi = 100-(100/1+rs) = 87.5
-        '''
-        assert svc.calculate_rsi(market_state.rolling_trade_statistics, 0, 2) == 87.49999999999999
+        assert svc.calculate_rsi(market_state.rolling_trade_statistics, 5) == 49.826259656132514
+        # 2s candles ...120 - ...258: 70 closes
+        assert svc.calculate_rsi(market_state.rolling_trade_statistics, 2) == 39.73909009031738
 
     def test_calculate_stoch_rsi_5_seconds(self):
         market_state = self.get_sample_order_book(
@@ -379,387 +401,10 @@ class TestSingleVariableCounter:
             quantity_hash=2.1799
         )
         '''
-            offset0
-            windowTimeSeconds5
-            diff_i: (gainSum += diff_i): 5 1.1
-            diff_i: (gainSum += diff_i): 10 0.2
-            diff_i: (gainSum += diff_i): 15 0.1
-            diff_i: (lossSum += -diff_i): 20 -0.2
-            diff_i: (lossSum += -diff_i): 25 0
-            diff_i: (lossSum += -diff_i): 30 0
-            diff_i: (lossSum += -diff_i): 35 -4.2
-            diff_i: (lossSum += -diff_i): 40 0
-            diff_i: (lossSum += -diff_i): 45 0
-            diff_i: (lossSum += -diff_i): 50 0
-            diff_i: (lossSum += -diff_i): 55 0
-            diff_i: (lossSum += -diff_i): 60 0
-            diff_i: (lossSum += -diff_i): 65 -3.1
-            diff_i: (gainSum += diff_i): 70 9
-            avgGain = 0.742857
-            avgLoss = 0.535714
-            periods = 14
-            rs = 1.38667
-            rsi = 58.1
-            XXXXXX
-            
-            offset5
-            windowTimeSeconds5
-            diff_i: (gainSum += diff_i): 5 0.2
-            diff_i: (gainSum += diff_i): 10 0.1
-            diff_i: (lossSum += -diff_i): 15 -0.2
-            diff_i: (lossSum += -diff_i): 20 0
-            diff_i: (lossSum += -diff_i): 25 0
-            diff_i: (lossSum += -diff_i): 30 -4.2
-            diff_i: (lossSum += -diff_i): 35 0
-            diff_i: (lossSum += -diff_i): 40 0
-            diff_i: (lossSum += -diff_i): 45 0
-            diff_i: (lossSum += -diff_i): 50 0
-            diff_i: (lossSum += -diff_i): 55 0
-            diff_i: (lossSum += -diff_i): 60 -3.1
-            diff_i: (gainSum += diff_i): 65 9
-            diff_i: (lossSum += -diff_i): 70 -2
-            avgGain = 0.664286
-            avgLoss = 0.678571
-            periods = 14
-            rs = 0.978947
-            rsi = 49.47
-            XXXXXX
-            
-            offset10
-            windowTimeSeconds5
-            diff_i: (gainSum += diff_i): 5 0.1
-            diff_i: (lossSum += -diff_i): 10 -0.2
-            diff_i: (lossSum += -diff_i): 15 0
-            diff_i: (lossSum += -diff_i): 20 0
-            diff_i: (lossSum += -diff_i): 25 -4.2
-            diff_i: (lossSum += -diff_i): 30 0
-            diff_i: (lossSum += -diff_i): 35 0
-            diff_i: (lossSum += -diff_i): 40 0
-            diff_i: (lossSum += -diff_i): 45 0
-            diff_i: (lossSum += -diff_i): 50 0
-            diff_i: (lossSum += -diff_i): 55 -3.1
-            diff_i: (gainSum += diff_i): 60 9
-            diff_i: (lossSum += -diff_i): 65 -2
-            diff_i: (lossSum += -diff_i): 70 -0.6
-            avgGain = 0.65
-            avgLoss = 0.721429
-            periods = 14
-            rs = 0.90099
-            rsi = 47.4
-            XXXXXX
-            
-            offset15
-            windowTimeSeconds5
-            diff_i: (lossSum += -diff_i): 5 -0.2
-            diff_i: (lossSum += -diff_i): 10 0
-            diff_i: (lossSum += -diff_i): 15 0
-            diff_i: (lossSum += -diff_i): 20 -4.2
-            diff_i: (lossSum += -diff_i): 25 0
-            diff_i: (lossSum += -diff_i): 30 0
-            diff_i: (lossSum += -diff_i): 35 0
-            diff_i: (lossSum += -diff_i): 40 0
-            diff_i: (lossSum += -diff_i): 45 0
-            diff_i: (lossSum += -diff_i): 50 -3.1
-            diff_i: (gainSum += diff_i): 55 9
-            diff_i: (lossSum += -diff_i): 60 -2
-            diff_i: (lossSum += -diff_i): 65 -0.6
-            diff_i: (gainSum += diff_i): 70 0.1
-            avgGain = 0.65
-            avgLoss = 0.721429
-            periods = 14
-            rs = 0.90099
-            rsi = 47.4
-            XXXXXX
-            
-            offset20
-            windowTimeSeconds5
-            diff_i: (lossSum += -diff_i): 5 0
-            diff_i: (lossSum += -diff_i): 10 0
-            diff_i: (lossSum += -diff_i): 15 -4.2
-            diff_i: (lossSum += -diff_i): 20 0
-            diff_i: (lossSum += -diff_i): 25 0
-            diff_i: (lossSum += -diff_i): 30 0
-            diff_i: (lossSum += -diff_i): 35 0
-            diff_i: (lossSum += -diff_i): 40 0
-            diff_i: (lossSum += -diff_i): 45 -3.1
-            diff_i: (gainSum += diff_i): 50 9
-            diff_i: (lossSum += -diff_i): 55 -2
-            diff_i: (lossSum += -diff_i): 60 -0.6
-            diff_i: (gainSum += diff_i): 65 0.1
-            diff_i: (gainSum += diff_i): 70 0.1
-            avgGain = 0.657143
-            avgLoss = 0.707143
-            periods = 14
-            rs = 0.929293
-            rsi = 48.17
-            XXXXXX
-            
-            offset25
-            windowTimeSeconds5
-            diff_i: (lossSum += -diff_i): 5 0
-            diff_i: (lossSum += -diff_i): 10 -4.2
-            diff_i: (lossSum += -diff_i): 15 0
-            diff_i: (lossSum += -diff_i): 20 0
-            diff_i: (lossSum += -diff_i): 25 0
-            diff_i: (lossSum += -diff_i): 30 0
-            diff_i: (lossSum += -diff_i): 35 0
-            diff_i: (lossSum += -diff_i): 40 -3.1
-            diff_i: (gainSum += diff_i): 45 9
-            diff_i: (lossSum += -diff_i): 50 -2
-            diff_i: (lossSum += -diff_i): 55 -0.6
-            diff_i: (gainSum += diff_i): 60 0.1
-            diff_i: (gainSum += diff_i): 65 0.1
-            diff_i: (gainSum += diff_i): 70 0.1
-            avgGain = 0.664286
-            avgLoss = 0.707143
-            periods = 14
-            rs = 0.939394
-            rsi = 48.44
-            XXXXXX
-            
-            offset30
-            windowTimeSeconds5
-            diff_i: (lossSum += -diff_i): 5 -4.2
-            diff_i: (lossSum += -diff_i): 10 0
-            diff_i: (lossSum += -diff_i): 15 0
-            diff_i: (lossSum += -diff_i): 20 0
-            diff_i: (lossSum += -diff_i): 25 0
-            diff_i: (lossSum += -diff_i): 30 0
-            diff_i: (lossSum += -diff_i): 35 -3.1
-            diff_i: (gainSum += diff_i): 40 9
-            diff_i: (lossSum += -diff_i): 45 -2
-            diff_i: (lossSum += -diff_i): 50 -0.6
-            diff_i: (gainSum += diff_i): 55 0.1
-            diff_i: (gainSum += diff_i): 60 0.1
-            diff_i: (gainSum += diff_i): 65 0.1
-            diff_i: (gainSum += diff_i): 70 0.1
-            avgGain = 0.671429
-            avgLoss = 0.707143
-            periods = 14
-            rs = 0.949495
-            rsi = 48.7
-            XXXXXX
-            
-            offset35
-            windowTimeSeconds5
-            diff_i: (lossSum += -diff_i): 5 0
-            diff_i: (lossSum += -diff_i): 10 0
-            diff_i: (lossSum += -diff_i): 15 0
-            diff_i: (lossSum += -diff_i): 20 0
-            diff_i: (lossSum += -diff_i): 25 0
-            diff_i: (lossSum += -diff_i): 30 -3.1
-            diff_i: (gainSum += diff_i): 35 9
-            diff_i: (lossSum += -diff_i): 40 -2
-            diff_i: (lossSum += -diff_i): 45 -0.6
-            diff_i: (gainSum += diff_i): 50 0.1
-            diff_i: (gainSum += diff_i): 55 0.1
-            diff_i: (gainSum += diff_i): 60 0.1
-            diff_i: (gainSum += diff_i): 65 0.1
-            diff_i: (gainSum += diff_i): 70 0.1
-            avgGain = 0.678571
-            avgLoss = 0.407143
-            periods = 14
-            rs = 1.66667
-            rsi = 62.5
-            XXXXXX
-            
-            offset40
-            windowTimeSeconds5
-            diff_i: (lossSum += -diff_i): 5 0
-            diff_i: (lossSum += -diff_i): 10 0
-            diff_i: (lossSum += -diff_i): 15 0
-            diff_i: (lossSum += -diff_i): 20 0
-            diff_i: (lossSum += -diff_i): 25 -3.1
-            diff_i: (gainSum += diff_i): 30 9
-            diff_i: (lossSum += -diff_i): 35 -2
-            diff_i: (lossSum += -diff_i): 40 -0.6
-            diff_i: (gainSum += diff_i): 45 0.1
-            diff_i: (gainSum += diff_i): 50 0.1
-            diff_i: (gainSum += diff_i): 55 0.1
-            diff_i: (gainSum += diff_i): 60 0.1
-            diff_i: (gainSum += diff_i): 65 0.1
-            diff_i: (gainSum += diff_i): 70 0.6
-            avgGain = 0.721429
-            avgLoss = 0.407143
-            periods = 14
-            rs = 1.77193
-            rsi = 63.92
-            XXXXXX
-            
-            offset45
-            windowTimeSeconds5
-            diff_i: (lossSum += -diff_i): 5 0
-            diff_i: (lossSum += -diff_i): 10 0
-            diff_i: (lossSum += -diff_i): 15 0
-            diff_i: (lossSum += -diff_i): 20 -3.1
-            diff_i: (gainSum += diff_i): 25 9
-            diff_i: (lossSum += -diff_i): 30 -2
-            diff_i: (lossSum += -diff_i): 35 -0.6
-            diff_i: (gainSum += diff_i): 40 0.1
-            diff_i: (gainSum += diff_i): 45 0.1
-            diff_i: (gainSum += diff_i): 50 0.1
-            diff_i: (gainSum += diff_i): 55 0.1
-            diff_i: (gainSum += diff_i): 60 0.1
-            diff_i: (gainSum += diff_i): 65 0.6
-            diff_i: (gainSum += diff_i): 70 0.1
-            avgGain = 0.728571
-            avgLoss = 0.407143
-            periods = 14
-            rs = 1.78947
-            rsi = 64.15
-            XXXXXX
-            
-            offset50
-            windowTimeSeconds5
-            diff_i: (lossSum += -diff_i): 5 0
-            diff_i: (lossSum += -diff_i): 10 0
-            diff_i: (lossSum += -diff_i): 15 -3.1
-            diff_i: (gainSum += diff_i): 20 9
-            diff_i: (lossSum += -diff_i): 25 -2
-            diff_i: (lossSum += -diff_i): 30 -0.6
-            diff_i: (gainSum += diff_i): 35 0.1
-            diff_i: (gainSum += diff_i): 40 0.1
-            diff_i: (gainSum += diff_i): 45 0.1
-            diff_i: (gainSum += diff_i): 50 0.1
-            diff_i: (gainSum += diff_i): 55 0.1
-            diff_i: (gainSum += diff_i): 60 0.6
-            diff_i: (gainSum += diff_i): 65 0.1
-            diff_i: (gainSum += diff_i): 70 0.1
-            avgGain = 0.735714
-            avgLoss = 0.407143
-            periods = 14
-            rs = 1.80702
-            rsi = 64.38
-            XXXXXX
-            
-            offset55
-            windowTimeSeconds5
-            diff_i: (lossSum += -diff_i): 5 0
-            diff_i: (lossSum += -diff_i): 10 -3.1
-            diff_i: (gainSum += diff_i): 15 9
-            diff_i: (lossSum += -diff_i): 20 -2
-            diff_i: (lossSum += -diff_i): 25 -0.6
-            diff_i: (gainSum += diff_i): 30 0.1
-            diff_i: (gainSum += diff_i): 35 0.1
-            diff_i: (gainSum += diff_i): 40 0.1
-            diff_i: (gainSum += diff_i): 45 0.1
-            diff_i: (gainSum += diff_i): 50 0.1
-            diff_i: (gainSum += diff_i): 55 0.6
-            diff_i: (gainSum += diff_i): 60 0.1
-            diff_i: (gainSum += diff_i): 65 0.1
-            diff_i: (gainSum += diff_i): 70 0.1
-            avgGain = 0.742857
-            avgLoss = 0.407143
-            periods = 14
-            rs = 1.82456
-            rsi = 64.6
-            XXXXXX
-            
-            offset60
-            windowTimeSeconds5
-            diff_i: (lossSum += -diff_i): 5 -3.1
-            diff_i: (gainSum += diff_i): 10 9
-            diff_i: (lossSum += -diff_i): 15 -2
-            diff_i: (lossSum += -diff_i): 20 -0.6
-            diff_i: (gainSum += diff_i): 25 0.1
-            diff_i: (gainSum += diff_i): 30 0.1
-            diff_i: (gainSum += diff_i): 35 0.1
-            diff_i: (gainSum += diff_i): 40 0.1
-            diff_i: (gainSum += diff_i): 45 0.1
-            diff_i: (gainSum += diff_i): 50 0.6
-            diff_i: (gainSum += diff_i): 55 0.1
-            diff_i: (gainSum += diff_i): 60 0.1
-            diff_i: (gainSum += diff_i): 65 0.1
-            diff_i: (gainSum += diff_i): 70 0.1
-            avgGain = 0.75
-            avgLoss = 0.407143
-            periods = 14
-            rs = 1.84211
-            rsi = 64.81
-            XXXXXX
-            
-            offset65
-            windowTimeSeconds5
-            diff_i: (gainSum += diff_i): 5 9
-            diff_i: (lossSum += -diff_i): 10 -2
-            diff_i: (lossSum += -diff_i): 15 -0.6
-            diff_i: (gainSum += diff_i): 20 0.1
-            diff_i: (gainSum += diff_i): 25 0.1
-            diff_i: (gainSum += diff_i): 30 0.1
-            diff_i: (gainSum += diff_i): 35 0.1
-            diff_i: (gainSum += diff_i): 40 0.1
-            diff_i: (gainSum += diff_i): 45 0.6
-            diff_i: (gainSum += diff_i): 50 0.1
-            diff_i: (gainSum += diff_i): 55 0.1
-            diff_i: (gainSum += diff_i): 60 0.1
-            diff_i: (gainSum += diff_i): 65 0.1
-            diff_i: (gainSum += diff_i): 70 0.1
-            avgGain = 0.757143
-            avgLoss = 0.185714
-            periods = 14
-            rs = 4.07692
-            rsi = 80.3
-            XXXXXX
-        '''
-
-        '''
-            price_hash = 3
-            quantity_hash = 5
-            
-            expected_trade_entries_data_list = [
-                (1750489120_000_000, round((price_hash + 1.0), 5),  quantity_hash + 3, True),  # price 4.0 @quantity: - 5.1799 # < t-60s
-                (1750489125_000_000, round((price_hash + 2.0), 5),  quantity_hash + 3, True),  # price 5.0 @quantity: - 5.1799 # < t-60s
-                (1750489130_000_000, round((price_hash + 2.1), 5),  quantity_hash + 3, True),  # price 5.1 @quantity: - 5.1799 # < t-60s
-                (1750489135_000_000, round((price_hash + 2.2), 5),  quantity_hash + 3, True),  # price 5.2 @quantity: - 5.1799 # < t-60s
-                (1750489140_000_000, round((price_hash + 2.3), 5),  quantity_hash + 3, True),  # price 5.3 @quantity: - 5.1799 # < t-60s
-                (1750489145_000_000, round((price_hash + 2.4), 5),  quantity_hash + 3, True),  # price 5.4 @quantity: - 5.1799 # < t-60s
-                (1750489150_000_000, round((price_hash + 2.5), 5),  quantity_hash + 3, True),  # price 5.5 @quantity: - 5.1799 # < t-60s
-                (1750489155_000_000, round((price_hash + 3.1), 5),  quantity_hash + 3, True),  # price 6.1 @quantity: - 5.1799 # < t-60s
-                (1750489160_000_000, round((price_hash + 3.2), 5),  quantity_hash + 3, True),  # price 6.2 @quantity: - 5.1799 # < t-60s
-                (1750489165_000_000, round((price_hash + 3.3), 5),  quantity_hash + 3, True),  # price 6.3 @quantity: - 5.1799 # < t-60s
-                (1750489170_000_000, round((price_hash + 3.4), 5),  quantity_hash + 3, True),  # price 6.4 @quantity: - 5.1799 # < t-60s
-                (1750489175_000_000, round((price_hash + 3.5), 5),  quantity_hash + 3, True),  # price 6.5 @quantity: - 5.1799 # < t-60s
-                (1750489180_000_000, round((price_hash + 3.6), 5),  quantity_hash + 3, True),  # price 6.6 @quantity: - 5.1799 # < t-60s
-                (1750489185_000_000, round((price_hash + 3.0), 5),  quantity_hash + 3, True),  # price 6.0 @quantity: - 5.1799 # < t-60s
-                (1750489190_000_000, round((price_hash + 1.0), 5),  quantity_hash + 3, True),  # price 4.0 @quantity: - 5.1799 # < t-60s
-                (1750489195_000_000, round((price_hash +10.0), 5),  quantity_hash + 1, False), # price13.0 @quantity: - 5.1799 # < t-60s
-            
-                (1750489200_000_000, round((price_hash + 6.9), 5), quantity_hash + 4, False),  # price 9.9 @quantity: + 6.1799
-                (1750489210_000_000, round((price_hash + 6.9), 5), quantity_hash + 4, False),  # price 9.9 @quantity: + 6.1799
-                (1750489215_000_000, round((price_hash + 6.9), 5), quantity_hash + 4, False),  # price 9.9 @quantity: + 6.1799
-                (1750489220_000_000, round((price_hash + 6.9), 5), quantity_hash + 4, False),  # price 9.9 @quantity: + 6.1799
-                (1750489225_000_000, round((price_hash + 6.9), 5), quantity_hash + 4, False),  # price 9.9 @quantity: + 6.1799
-                (1750489230_000_000, round((price_hash + 2.7), 5), quantity_hash + 4, False),  # price 5.7 @quantity: + 6.1799
-                (1750489235_000_000, round((price_hash + 2.7), 5), quantity_hash + 4, False),  # price 5.7 @quantity: + 6.1799
-                (1750489240_000_000, round((price_hash + 2.7), 5), quantity_hash + 4, False),  # price 5.7 @quantity: + 6.1799
-                (1750489244_999_999, round((price_hash + 2.5), 5), quantity_hash + 3, False),  # price 5.5 @quantity: + 5.1799
-                (1750489249_999_999, round((price_hash + 2.6), 5), quantity_hash + 4, True),   # price 5.6 @quantity: - 6.1799
-                (1750489255_000_000, round((price_hash + 2.8), 5), quantity_hash + 2, False),  # price 5.8 @quantity: + 4.1799
-                (1750489260_000_000, round((price_hash + 3.9), 5), quantity_hash + 2, True),   # price 6.9 @quantity: - 4.1799
-            ]
-            
-            import pandas as pd
-            ONE_SEC_US = 1_000_000
-            
-            # rozwinąć każde oryginalne wejście 5 razy
-            expanded_trade_entries = []
-            for ts, price, qty, is_buyer_maker in expected_trade_entries_data_list:
-                for i in range(5):
-                    new_ts = ts + i * ONE_SEC_US
-                    expanded_trade_entries.append((new_ts, price, qty, is_buyer_maker))
-            
-            # teraz tworzysz DataFrame z expanded_trade_entries
-            import pandas as pd
-            
-            df = pd.DataFrame(expected_trade_entries_data_list, columns=['timestamp', 'price', 'quantity', 'is_ask'])
-            
-            from ta.momentum import RSIIndicator, StochRSIIndicator
-            df['rsi'] = RSIIndicator(df['price'], window=14).rsi()
-            stoch = StochRSIIndicator(df['price'], window=14, smooth1=1, smooth2=1)
-            df['stoch_rsi_raw'] = stoch.stochrsi()
-            df
+            (rsi - min(rsi of the last 14 candles)) / (max - min) on the RSI of
+            test_calculate_rsi_5_seconds
         '''
-        assert svc.calculate_stoch_rsi(market_state.rolling_trade_statistics, 5) == 0.32530043004702375
+        assert svc.calculate_stoch_rsi(market_state.rolling_trade_statistics, 5) == 0.06735688571800799
 
     def test_calculate_macd_2_seconds(self):
         market_state = self.get_sample_order_book(
@@ -768,7 +413,16 @@ class TestSingleVariableCounter:
             price_hash=3,
             quantity_hash=2.1799
         )
-        # SMA(24s) = (5.5+5.6+5.7+5.8+5.9+6.0+6.9)/7 ≈ 5.91428571
-        # SMA(52s) = (5.5+5.7+5.5+5.6+5.7+5.8+5.9+6.0+6.9)/9 ≈ 5.84444444
-        # MACD = 5.91428571 - 5.84444444 ≈ 0.06984127
-        assert svc.calculate_macd(market_state.rolling_trade_statistics, 2) == 0.06984127
+        # EMA(12) - EMA(26) of the closes of 2s candles, alpha = 2 / (n + 1), both seeded with the first close
+        assert svc.calculate_macd(market_state.rolling_trade_statistics, candle_seconds=2) == -0.64150267
+
+    def test_calculate_rsi_when_candle_length_has_no_indicator_state_then_raises(self):
+        market_state = self.get_sample_order_book(
+            symbol=Symbol.ADAUSDT,
+            market=Market.USD_M_FUTURES,
+            price_hash=3,
+            quantity_hash=2.1799
+        )
+
+        with pytest.raises(RuntimeError):
+            svc.calculate_rsi(market_state.rolling_trade_statistics, 3)
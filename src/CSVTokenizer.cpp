@@ -0,0 +1,56 @@
+#include <bit>
+
+#include "CSVTokenizer.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CSV_TOKENIZER_SSE2
+#endif
+
+namespace {
+    inline void emitMask(uint64_t mask, const uint32_t offset, std::vector<uint32_t>& out) {
+        while (mask) {
+            out.push_back(offset + static_cast<uint32_t>(std::countr_zero(mask)));
+            mask &= mask - 1;
+        }
+    }
+}
+
+void scanStructural(const std::string_view text, const char delimiter, std::vector<uint32_t>& out) {
+    const char* const data = text.data();
+    const size_t n = text.size();
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i delim = _mm256_set1_epi8(delimiter);
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (; i + 64 <= n; i += 64) {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        const uint32_t mLo = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(lo, delim), _mm256_cmpeq_epi8(lo, newline))));
+        const uint32_t mHi = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(hi, delim), _mm256_cmpeq_epi8(hi, newline))));
+        emitMask(uint64_t{mHi} << 32 | mLo, static_cast<uint32_t>(i), out);
+    }
+#elif defined(CSV_TOKENIZER_SSE2)
+    const __m128i delim = _mm_set1_epi8(delimiter);
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 64 <= n; i += 64) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 4; ++k) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16 * k));
+            const uint32_t m = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(v, delim), _mm_cmpeq_epi8(v, newline))));
+            mask |= uint64_t{m} << (16 * k);
+        }
+        emitMask(mask, static_cast<uint32_t>(i), out);
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if (data[i] == delimiter || data[i] == '\n') out.push_back(static_cast<uint32_t>(i));
+    }
+}
@@ -0,0 +1,111 @@
+#include "CandleIndicators.h"
+#include <algorithm>
+#include <stdexcept>
+
+CandleIndicators::CandleIndicators(const int candleSeconds)
+    : candleMicros_(static_cast<int64_t>(candleSeconds) * 1'000'000)
+{
+    if (candleSeconds <= 0) throw std::runtime_error("CandleIndicators candle length must be positive");
+}
+
+void CandleIndicators::advanceTo(const int64_t timestamp, const double closePrice) {
+    const int64_t candle = timestamp / candleMicros_;
+    if (openCandle_ < 0) {
+        openCandle_ = candle;
+        return;
+    }
+    const int64_t closed = candle - openCandle_;
+    if (closed <= 0) return;
+
+    if (closed > WARMUP_CANDLES) {
+        reset();
+    } else {
+        for (int64_t i = 0; i < closed; ++i) closeCandle(closePrice);
+    }
+    openCandle_ = candle;
+}
+
+void CandleIndicators::closeCandle(const double closePrice) {
+    if (!hasClose_) {
+        lastClose_ = closePrice;
+        emaShort_ = closePrice;
+        emaLong_ = closePrice;
+        hasClose_ = true;
+        return;
+    }
+
+    constexpr double shortAlpha = 2.0 / (MACD_SHORT_PERIODS + 1);
+    constexpr double longAlpha = 2.0 / (MACD_LONG_PERIODS + 1);
+    emaShort_ += shortAlpha * (closePrice - emaShort_);
+    emaLong_ += longAlpha * (closePrice - emaLong_);
+
+    const double change = closePrice - lastClose_;
+    lastClose_ = closePrice;
+    const double gain = std::max(change, 0.0);
+    const double loss = std::max(-change, 0.0);
+
+    // the first RSI_PERIODS changes seed the averages with their mean
+    if (rsiSamples_ < RSI_PERIODS) {
+        averageGain_ += gain;
+        averageLoss_ += loss;
+        if (++rsiSamples_ < RSI_PERIODS) return;
+        averageGain_ /= RSI_PERIODS;
+        averageLoss_ /= RSI_PERIODS;
+    } else {
+        averageGain_ = (averageGain_ * (RSI_PERIODS - 1) + gain) / RSI_PERIODS;
+        averageLoss_ = (averageLoss_ * (RSI_PERIODS - 1) + loss) / RSI_PERIODS;
+    }
+
+    if (averageGain_ + averageLoss_ == 0.0) rsi_ = 50.0;
+    else if (averageLoss_ == 0.0)           rsi_ = 100.0;
+    else                                    rsi_ = 100.0 - 100.0 / (1.0 + averageGain_ / averageLoss_);
+
+    rsiHistory_[rsiHistoryNext_] = rsi_;
+    rsiHistoryNext_ = (rsiHistoryNext_ + 1) % STOCH_RSI_PERIODS;
+    if (rsiHistoryNext_ == 0) rsiHistoryFull_ = true;
+    if (!rsiHistoryFull_) return;
+
+    const auto [minRsi, maxRsi] = std::ranges::minmax(rsiHistory_);
+    stochRsi_ = maxRsi == minRsi ? 0.0 : (rsi_ - minRsi) / (maxRsi - minRsi);
+}
+
+void CandleIndicators::saveState(Checkpoint::Writer& w) const {
+    w.write(candleMicros_);
+    w.write(openCandle_);
+    w.write(lastClose_);
+    w.writeBool(hasClose_);
+    w.write<int32_t>(rsiSamples_);
+    w.write(averageGain_);
+    w.write(averageLoss_);
+    w.write(rsi_);
+    for (const double value : rsiHistory_) w.write(value);
+    w.write<int32_t>(rsiHistoryNext_);
+    w.writeBool(rsiHistoryFull_);
+    w.write(stochRsi_);
+    w.write(emaShort_);
+    w.write(emaLong_);
+}
+
+void CandleIndicators::loadState(Checkpoint::Reader& r) {
+    if (r.read<int64_t>() != candleMicros_) throw std::runtime_error("CandleIndicators checkpoint holds a different candle length");
+    openCandle_ = r.read<int64_t>();
+    lastClose_ = r.read<double>();
+    hasClose_ = r.readBool();
+    rsiSamples_ = r.read<int32_t>();
+    averageGain_ = r.read<double>();
+    averageLoss_ = r.read<double>();
+    rsi_ = r.read<double>();
+    for (double& value : rsiHistory_) value = r.read<double>();
+    rsiHistoryNext_ = r.read<int32_t>();
+    if (rsiHistoryNext_ < 0 || rsiHistoryNext_ >= STOCH_RSI_PERIODS) throw std::runtime_error("CandleIndicators checkpoint is corrupt");
+    rsiHistoryFull_ = r.readBool();
+    stochRsi_ = r.read<double>();
+    emaShort_ = r.read<double>();
+    emaLong_ = r.read<double>();
+}
+
+void CandleIndicators::reset() {
+    const int64_t candleMicros = candleMicros_;
+    *this = CandleIndicators();
+    candleMicros_ = candleMicros;
+}
@@ -10,23 +10,8 @@
 #include "DataVectorLoader.h"
 #include "enums/AssetParameters.h"
 #include "EntryDecoder.h"
-#include "mmap_win.h"
-
-inline std::vector<std::string_view> split_sv_by_newline(std::string_view sv) {
-    std::vector<std::string_view> out;
-    size_t start = 0;
-
-    while (start < sv.size()) {
-        size_t end = sv.find('\n', start);
-        if (end == std::string_view::npos) {
-            out.emplace_back(sv.substr(start));
-            break;
-        }
-        out.emplace_back(sv.substr(start, end - start));
-        start = end + 1;
-    }
-    return out;
-}
+#include "EntryStream.h"
+#include "MergedEntryStream.h"
 
 std::vector<std::string> DataVectorLoader::splitLine(const std::string &line, char delimiter) {
     std::vector<std::string> tokens;
@@ -38,75 +23,26 @@ std::vector<std::string> DataVectorLoader::splitLine(const std::string &line, ch
     return tokens;
 }
 
-std::vector<DecodedEntry> DataVectorLoader::getEntriesFromSingleAssetParametersCSV(const std::string &csvPath) {
-    AssetParameters assetParameters = AssetParameters::decodeAssetParametersFromSingleCSVName(csvPath);
-
-    MMapData mm = mmap_file(csvPath);
-    std::string_view file_view(mm.data, mm.size);
-
-    auto lines = split_sv_by_newline(file_view);
-
-    std::vector<DecodedEntry> entries;
-    entries.reserve(lines.size());
-
-    bool headerSkipped = false;
-    for (auto&& line_sv : lines) {
-        if (line_sv.empty() || line_sv[0] == '#') continue;
-        if (!headerSkipped) {
-            headerSkipped = true;
-            continue; // skip header
-        }
-        try {
-            DecodedEntry entry = EntryDecoder::decodeSingleAssetParameterEntry(assetParameters, line_sv);
-            entries.push_back(std::move(entry));
-        } catch (const std::exception &e) {
-            std::cerr << "Error processing the line: " << std::string(line_sv) << " - " << e.what() << std::endl;
+namespace {
+    template <typename Stream>
+    std::vector<DecodedEntry> drain(Stream stream) {
+        std::vector<DecodedEntry> entries;
+        std::vector<DecodedEntry> chunk;
+        while (stream.next(chunk)) {
+            entries.insert(entries.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
         }
+        return entries;
     }
+}
 
-    munmap_file(mm);
-    return entries;
+std::vector<DecodedEntry> DataVectorLoader::getEntriesFromSingleAssetParametersCSV(const std::string &csvPath) {
+    return drain(EntryStream::openSingleAssetParametersCSV(csvPath));
 }
 
 std::vector<DecodedEntry> DataVectorLoader::getEntriesFromMultiAssetParametersCSV(const std::string &csvPath) {
-    // const auto start = std::chrono::steady_clock::now();
-
-    MMapData mm = mmap_file(csvPath);
-    const std::string_view file_view(mm.data, mm.size);
-
-    const auto lines = split_sv_by_newline(file_view);
-
-    std::string_view headerLine;
-    size_t headerIdx = 0;
-    for (; headerIdx < lines.size(); ++headerIdx) {
-        if (!lines[headerIdx].empty() && lines[headerIdx][0] != '#') {
-            headerLine = lines[headerIdx];
-            break;
-        }
-    }
-
-    if (headerLine.empty()) throw std::runtime_error("Header not found in file: " + csvPath);
-
-    const std::vector<std::string_view> headerTokens = splitLineSV(headerLine, ',');
-    const ColMap colMap = buildColMap(headerTokens);
-
-    std::vector<DecodedEntry> entries;
-    entries.reserve(lines.size());
-
-    for (size_t i = headerIdx + 1; i < lines.size(); ++i) {
-        auto& line_sv = lines[i];
-        if (line_sv.empty() || line_sv[0] == '#') continue;
-        try {
-            DecodedEntry entry = EntryDecoder::decodeMultiAssetParameterEntry(line_sv, colMap);
-            entries.push_back(std::move(entry));
-        }
-        catch (const std::exception &e) {
-            std::cerr << "Error processing line: " << std::string(line_sv) << " - " << e.what() << std::endl;
-        }
-    }
+    return drain(EntryStream::openMultiAssetParametersCSV(csvPath));
+}
 
-    munmap_file(mm);
-    // const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
-    // std::cout << "getEntriesFromMultiAssetParametersCSV elapsed: " << elapsed << " ms" << std::endl;
-    return entries;
+std::vector<DecodedEntry> DataVectorLoader::getEntriesFromSingleAssetParametersCSVs(const std::vector<std::string> &csvPaths) {
+    return drain(MergedEntryStream::openSingleAssetParametersCSVs(csvPaths));
 }
@@ -0,0 +1,55 @@
+#include <memory>
+#include <stdexcept>
+
+#include "DaySequenceStream.h"
+#include "EventArchive.h"
+#include "EventFile.h"
+
+DaySequenceStream::DaySequenceStream(std::vector<std::string> dayPaths, const size_t decodeThreads)
+    : dayPaths_(std::move(dayPaths))
+    , decodeThreads_(decodeThreads)
+{
+    if (dayPaths_.empty()) throw std::runtime_error("DaySequenceStream: no day files given");
+    prefetch();
+}
+
+DaySequenceStream::OpenedDay DaySequenceStream::openDay(const std::string& path, const size_t decodeThreads) {
+    // the sources are move-only; shared_ptr makes them fit a std::function
+    OpenedDay day;
+    if (EventFile::isEventFile(path)) {
+        auto file = std::make_shared<EventFile>(path);
+        day.source = [file](std::vector<DecodedEntry>& chunk) { return file->next(chunk); };
+    } else if (EventArchive::isEventArchive(path)) {
+        auto archive = std::make_shared<EventArchive>(path);
+        day.source = [archive](std::vector<DecodedEntry>& chunk) { return archive->next(chunk); };
+    } else {
+        auto stream = std::make_shared<EntryStream>(EntryStream::openMultiAssetParametersCSV(path, decodeThreads));
+        day.source = [stream](std::vector<DecodedEntry>& chunk) { return stream->next(chunk); };
+    }
+    day.hasFirstChunk = day.source(day.firstChunk);
+    return day;
+}
+
+void DaySequenceStream::prefetch() {
+    if (nextDay_ == dayPaths_.size()) return;
+    prefetched_ = std::async(decodeThreads_ ? std::launch::async : std::launch::deferred,
+                             &DaySequenceStream::openDay, dayPaths_[nextDay_++], decodeThreads_);
+}
+
+bool DaySequenceStream::next(std::vector<DecodedEntry>& chunk) {
+    while (true) {
+        if (current_.hasFirstChunk) {
+            current_.hasFirstChunk = false;
+            chunk.swap(current_.firstChunk);
+            return true;
+        }
+        if (current_.source && current_.source(chunk)) return true;
+
+        if (!prefetched_.valid()) {
+            chunk.clear();
+            return false;
+        }
+        current_ = prefetched_.get();
+        prefetch();
+    }
+}
@@ -1,250 +1,298 @@
+#include <algorithm>
+#include <cctype>
 #include <stdexcept>
-#include <charconv>
+#include <sstream>
 #include <vector>
 
 #include "EntryDecoder.h"
 #include "CSVHeader.h"
+#include "DecimalParser.h"
 
+namespace {
+    // Reads the fields of one line. The first failure is kept (with the offending
+    // field) and reads after it just return zeros, so decoding never throws.
+    class FieldReader {
+    public:
+        explicit FieldReader(const CSVFields& tokens) : tokens_(tokens) {}
 
-[[nodiscard]] inline int64_t parse_int(std::string_view sv) {
-    int64_t out = 0;
-    auto res = std::from_chars(sv.data(), sv.data() + sv.size(), out, 10);
-    if (res.ec == std::errc{}) return out;
-    throw std::runtime_error(std::string("parse_int failed for '") + std::string(sv) + "'");
+        // Unchecked: the row decoders compare tokens.size() against their plan first.
+        std::string_view text(const int i) const { return tokens_[i]; }
+
+        int64_t timestamp(const int i) {
+            const std::string_view sv = text(i);
+            int64_t value = 0;
+            check(parseInteger(sv, value), sv);
+            return value;
+        }
+
+        double real(const int i) {
+            const std::string_view sv = text(i);
+            Decimal d;
+            if (!check(parseDecimal(sv, d), sv)) return 0.0;
+            return decimalToDouble(d, sv);
+        }
+
+        // Reads a decimal straight into an integer count of 10^-decimals units, so that
+        // prices and quantities never pass through a binary double on the way to the book.
+        int64_t fixed(const int i, const uint8_t decimals) {
+            const std::string_view sv = text(i);
+            Decimal d;
+            int64_t value = 0;
+            if (check(parseDecimal(sv, d), sv)) check(decimalToFixed(d, decimals, value), sv);
+            return value;
+        }
+
+        bool flag(const int i) { return parseFlag(text(i)); }
+
+        Symbol symbol(const int i) { return parseSymbol(text(i)); }
+
+        Symbol symbolName(const int i) { return parseSymbolFromName(text(i)); }
+
+        StreamType streamType(const int i) {
+            const std::string_view sv = text(i);
+            if (sv.size() == 1 && sv[0] >= '1' && sv[0] <= '4') return parseStreamType(sv[0]);
+            fail(ParseStatus::UNKNOWN_STREAM_TYPE, sv);
+            return StreamType::UNKNOWN;
+        }
+
+        Market market(const int i) {
+            const std::string_view sv = text(i);
+            if (sv.size() == 1 && sv[0] >= '1' && sv[0] <= '3') return parseMarket(sv[0]);
+            fail(ParseStatus::UNKNOWN_MARKET, sv);
+            return Market::UNKNOWN;
+        }
+
+        void fail(const ParseStatus status, const std::string_view field) {
+            if (status_ != ParseStatus::OK) return;
+            status_ = status;
+            failedField_ = field;
+        }
+
+        bool ok() const { return status_ == ParseStatus::OK; }
+
+        ParseStatus finish(std::string_view* failedField) const {
+            if (failedField) *failedField = failedField_;
+            return status_;
+        }
+
+    private:
+        const CSVFields& tokens_;
+        ParseStatus status_{ParseStatus::OK};
+        std::string_view failedField_;
+
+        bool check(const ParseStatus status, const std::string_view field) {
+            if (status == ParseStatus::OK) return true;
+            fail(status, field);
+            return false;
+        }
+    };
 }
 
-[[nodiscard]] inline double parse_double(std::string_view sv) {
-    double out = 0.0;
-    auto res = std::from_chars(sv.data(), sv.data() + sv.size(), out);
-    if (res.ec == std::errc{}) return out;
-    throw std::runtime_error(std::string("parse_double failed for '") + std::string(sv) + "'");
+std::string EntryDecoder::describeFailure(const ParseStatus status, const std::string_view field) {
+    std::ostringstream os;
+    os << status << " for '" << field << "'";
+    return os.str();
 }
 
-DecodedEntry EntryDecoder::decodeSingleAssetParameterEntry(const AssetParameters &params, std::string_view line) {
-    auto tokens = splitLineSV(line, ',');
+namespace {
+    // Column positions of the single-asset layouts; symbol < 0 means the rows don't
+    // carry it and it comes from the file name.
+    struct SingleAssetColumns {
+        int symbol;
+        int isAsk;
+        int price;
+        int quantity;
+        int isBuyerMarketMaker;
 
-    switch (params.streamType) {
-        case StreamType::TRADE_STREAM: {
-            switch (params.market) {
-                case Market::SPOT: {
-                    return TradeEntry(
-                        parse_int(tokens.at(0)),
-                        parseSymbolFromName(tokens.at(5)),
-                        parse_double(tokens.at(7)),
-                        parse_double(tokens.at(8)),
-                        tokens.at(9) == "1",
-                        false,
-                        Market::SPOT
-                    );
-                }
-                case Market::USD_M_FUTURES:
-                case Market::COIN_M_FUTURES: {
-                    return TradeEntry(
-                        parse_int(tokens.at(0)),
-                        parseSymbolFromName(tokens.at(5)),
-                        parse_double(tokens.at(7)),
-                        parse_double(tokens.at(8)),
-                        tokens.at(9) == "1",
-                        false,
-                        params.market
-                    );
-                }
-                default:
-                    throw std::runtime_error("decodeSingleAssetParameterEntry/TRADE_STREAM: Unknown market");
-            }
+        constexpr size_t fieldCount() const {
+            return static_cast<size_t>(std::max({symbol, isAsk, price, quantity, isBuyerMarketMaker})) + 1;
         }
+    };
 
-        case StreamType::DEPTH_SNAPSHOT: {
-            switch (params.market) {
-                case Market::SPOT: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(0)),
-                        parseSymbolFromName(""),
-                        (tokens.at(3) == "1"),
-                        parse_double(tokens.at(4)),
-                        parse_double(tokens.at(5)),
-                        false,
-                        Market::SPOT
-                    );
-                }
-                case Market::USD_M_FUTURES: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(0)),
-                        parseSymbolFromName(""),
-                        (tokens.at(5) == "1"),
-                        parse_double(tokens.at(6)),
-                        parse_double(tokens.at(7)),
-                        false,
-                        Market::USD_M_FUTURES
-                    );
-                }
-                case Market::COIN_M_FUTURES: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(0)),
-                        parseSymbolFromName(tokens.at(5)),
-                        (tokens.at(7) == "1"),
-                        parse_double(tokens.at(8)),
-                        parse_double(tokens.at(9)),
-                        false,
-                        Market::COIN_M_FUTURES
-                    );
-                }
-                default:
-                    throw std::runtime_error("decodeSingleAssetParameterEntry/DEPTH_SNAPSHOT: Unknown market");
-            }
+    template <StreamType S, Market M>
+    constexpr SingleAssetColumns singleAssetColumns() {
+        if constexpr (S == StreamType::TRADE_STREAM) return {5, -1, 7, 8, 9};
+        else if constexpr (S == StreamType::DEPTH_SNAPSHOT && M == Market::SPOT) return {-1, 3, 4, 5, -1};
+        else if constexpr (S == StreamType::DEPTH_SNAPSHOT && M == Market::USD_M_FUTURES) return {-1, 5, 6, 7, -1};
+        else if constexpr (S == StreamType::DEPTH_SNAPSHOT) return {5, 7, 8, 9, -1};
+        else if constexpr (M == Market::SPOT) return {4, 7, 8, 9, -1};
+        else return {5, 9, 10, 11, -1};
+    }
+
+    Symbol fileSymbol(FieldReader& f, const DecodePlan& plan, const int i) {
+        const std::string_view name = f.text(i);
+        return name == plan.symbolName ? plan.symbol : parseSymbolFromName(name);
+    }
+
+    template <StreamType S, Market M>
+    ParseStatus decodeSingleAssetRow(const DecodePlan& plan, const CSVFields& tokens, DecodedEntry& out, std::string_view* failedField) {
+        constexpr SingleAssetColumns c = singleAssetColumns<S, M>();
+        FieldReader f(tokens);
+        if (tokens.size() < c.fieldCount()) {
+            f.fail(ParseStatus::MISSING_FIELD, {});
+            return f.finish(failedField);
         }
 
-        case StreamType::DIFFERENCE_DEPTH_STREAM: {
-            switch (params.market) {
-                case Market::SPOT: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(0)),
-                        parseSymbolFromName(tokens.at(4)),
-                        (tokens.at(7) == "1"),
-                        parse_double(tokens.at(8)),
-                        parse_double(tokens.at(9)),
-                        false,
-                        Market::SPOT
-                    );
-                }
-                case Market::USD_M_FUTURES: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(0)),
-                        parseSymbolFromName(tokens.at(5)),
-                        (tokens.at(9) == "1"),
-                        parse_double(tokens.at(10)),
-                        parse_double(tokens.at(11)),
-                        false,
-                        Market::USD_M_FUTURES
-                    );
-                }
-                case Market::COIN_M_FUTURES: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(0)),
-                        parseSymbolFromName(tokens.at(5)),
-                        (tokens.at(9) == "1"),
-                        parse_double(tokens.at(10)),
-                        parse_double(tokens.at(11)),
-                        false,
-                        Market::COIN_M_FUTURES
-                    );
-                }
-                default:
-                    throw std::runtime_error("decodeSingleAssetParameterEntry/DIFFERENCE_DEPTH_STREAM: Unknown market");
-            }
+        if constexpr (S == StreamType::TRADE_STREAM) {
+            out = DecodedEntry::trade(
+                f.timestamp(0),
+                fileSymbol(f, plan, c.symbol),
+                f.real(c.price),
+                f.real(c.quantity),
+                f.flag(c.isBuyerMarketMaker),
+                false,
+                M
+            );
+        } else {
+            const Symbol symbol = c.symbol < 0 ? plan.symbol : fileSymbol(f, plan, c.symbol);
+            out = DecodedEntry::depth(
+                f.timestamp(0),
+                symbol,
+                f.flag(c.isAsk),
+                f.fixed(c.price, pricePrecisionOf(symbol)),
+                f.fixed(c.quantity, quantityPrecisionOf(symbol)),
+                false,
+                M,
+                S == StreamType::DEPTH_SNAPSHOT
+            );
         }
+        return f.finish(failedField);
+    }
 
-        default:
-            throw std::runtime_error("decodeSingleAssetParameterEntry: Unknown StreamType");
+    template <ParseStatus Status>
+    ParseStatus rejectRow(const DecodePlan&, const CSVFields&, DecodedEntry&, std::string_view* failedField) {
+        if (failedField) *failedField = {};
+        return Status;
     }
-}
 
-DecodedEntry EntryDecoder::decodeMultiAssetParameterEntry(std::string_view line, const ColMap& h) {
-    auto tokens = splitLineSV(line, ',');
-
-    StreamType streamType = parseStreamType(tokens.at(h.at(COL_StreamType))[0]);
-    Market     market = parseMarket(tokens.at(h.at(COL_Market))[0]);
-
-    switch (streamType) {
-        case StreamType::TRADE_STREAM: {
-            switch (market) {
-                case Market::SPOT: {
-                    return TradeEntry(
-                        parse_int(tokens.at(h.at(COL_TimestampOfReceiveUS))),
-                        parseSymbol(tokens.at(h.at(COL_Symbol))),
-                        parse_double(tokens.at(h.at(COL_Price))),
-                        parse_double(tokens.at(h.at(COL_Quantity))),
-                        (tokens.at(h.at(COL_IsBuyerMarketMaker)) == "1"),
-                        (tokens.at(h.at(COL_IsLast)) == "1"),
-                        Market::SPOT
-                    );
-                }
-                case Market::USD_M_FUTURES:
-                case Market::COIN_M_FUTURES: {
-                    return TradeEntry(
-                        parse_int(tokens.at(h.at(COL_TimestampOfReceiveUS))),
-                        parseSymbol(tokens.at(h.at(COL_Symbol))),
-                        parse_double(tokens.at(h.at(COL_Price))),
-                        parse_double(tokens.at(h.at(COL_Quantity))),
-                        (tokens.at(h.at(COL_IsBuyerMarketMaker)) == "1"),
-                        (tokens.at(h.at(COL_IsLast)) == "1"),
-                        market
-                    );
-                }
-            default:
-                throw std::runtime_error("decodeMultiAssetParameterEntry/TRADE_STREAM: Unknown market");
-            }
+    ParseStatus decodeMultiAssetRow(const DecodePlan& plan, const CSVFields& tokens, DecodedEntry& out, std::string_view* failedField) {
+        const ColMap& h = plan.columns;
+        FieldReader f(tokens);
+        if (tokens.size() < plan.commonFields) {
+            f.fail(ParseStatus::MISSING_FIELD, {});
+            return f.finish(failedField);
         }
-        case StreamType::DEPTH_SNAPSHOT: {
-            switch (market) {
-                case Market::SPOT: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(h.at(COL_TimestampOfReceiveUS))),
-                        parseSymbol(tokens.at(h.at(COL_Symbol))),
-                        (tokens.at(h.at(COL_IsAsk)) == "1"),
-                        parse_double(tokens.at(h.at(COL_Price))),
-                        parse_double(tokens.at(h.at(COL_Quantity))),
-                        (tokens.at(h.at(COL_IsLast)) == "1"),
-                        Market::SPOT
-                    );
-                }
-                case Market::USD_M_FUTURES:
-                case Market::COIN_M_FUTURES: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(h.at(COL_TimestampOfReceiveUS))),
-                        parseSymbol(tokens.at(h.at(COL_Symbol))),
-                        (tokens.at(h.at(COL_IsAsk)) == "1"),
-                        parse_double(tokens.at(h.at(COL_Price))),
-                        parse_double(tokens.at(h.at(COL_Quantity))),
-                        (tokens.at(h.at(COL_IsLast)) == "1"),
-                        market
-                    );
-                }
-            default:
-                throw std::runtime_error("decodeMultiAssetParameterEntry/DEPTH_SNAPSHOT: Unknown market");
+
+        const StreamType streamType = f.streamType(h[COL_StreamType]);
+        const Market     market = f.market(h[COL_Market]);
+        if (!f.ok()) return f.finish(failedField);
+
+        if (streamType == StreamType::TRADE_STREAM) {
+            if (tokens.size() < plan.tradeFields) {
+                f.fail(ParseStatus::MISSING_FIELD, {});
+                return f.finish(failedField);
+            }
+            out = DecodedEntry::trade(
+                f.timestamp(h[COL_TimestampOfReceiveUS]),
+                f.symbol(h[COL_Symbol]),
+                f.real(h[COL_Price]),
+                f.real(h[COL_Quantity]),
+                f.flag(h[COL_IsBuyerMarketMaker]),
+                f.flag(h[COL_IsLast]),
+                market
+            );
+        } else {
+            if (tokens.size() < plan.depthFields) {
+                f.fail(ParseStatus::MISSING_FIELD, {});
+                return f.finish(failedField);
             }
+            const Symbol symbol = f.symbol(h[COL_Symbol]);
+            out = DecodedEntry::depth(
+                f.timestamp(h[COL_TimestampOfReceiveUS]),
+                symbol,
+                f.flag(h[COL_IsAsk]),
+                f.fixed(h[COL_Price], pricePrecisionOf(symbol)),
+                f.fixed(h[COL_Quantity], quantityPrecisionOf(symbol)),
+                f.flag(h[COL_IsLast]),
+                market,
+                streamType != StreamType::DIFFERENCE_DEPTH_STREAM
+            );
         }
-        case StreamType::FINAL_DEPTH_SNAPSHOT:
-        case StreamType::DIFFERENCE_DEPTH_STREAM: {
-            switch (market) {
-                case Market::SPOT: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(h.at(COL_TimestampOfReceiveUS))),
-                        parseSymbol(tokens.at(h.at(COL_Symbol))),
-                        (tokens.at(h.at(COL_IsAsk)) == "1"),
-                        parse_double(tokens.at(h.at(COL_Price))),
-                        parse_double(tokens.at(h.at(COL_Quantity))),
-                        (tokens.at(h.at(COL_IsLast)) == "1"),
-                        Market::SPOT
-                    );
-                }
-                case Market::USD_M_FUTURES: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(h.at(COL_TimestampOfReceiveUS))),
-                        parseSymbol(tokens.at(h.at(COL_Symbol))),
-                        (tokens.at(h.at(COL_IsAsk)) == "1"),
-                        parse_double(tokens.at(h.at(COL_Price))),
-                        parse_double(tokens.at(h.at(COL_Quantity))),
-                        (tokens.at(h.at(COL_IsLast)) == "1"),
-                        Market::USD_M_FUTURES
-                    );
-                }
-                case Market::COIN_M_FUTURES: {
-                    return DifferenceDepthEntry(
-                        parse_int(tokens.at(h.at(COL_TimestampOfReceiveUS))),
-                        parseSymbol(tokens.at(h.at(COL_Symbol))),
-                        (tokens.at(h.at(COL_IsAsk)) == "1"),
-                        parse_double(tokens.at(h.at(COL_Price))),
-                        parse_double(tokens.at(h.at(COL_Quantity))),
-                        (tokens.at(h.at(COL_IsLast)) == "1"),
-                        Market::COIN_M_FUTURES
-                    );
-                }
-            default:
-                throw std::runtime_error("decodeMultiAssetParameterEntry/DIFF|FINAL_SNAPSHOT: Unknown market");
+        return f.finish(failedField);
+    }
+
+    // The per-slice loop, instantiated once per row decoder so the row decode inlines.
+    template <auto DecodeRow>
+    void decodeLinesWith(const DecodePlan& plan, const CSVIndex& index, std::vector<DecodedEntry>& entries, std::vector<std::string>& errors) {
+        index.forEachLine([&](const CSVFields& tokens) {
+            const std::string_view line = tokens.line();
+            if (line.empty() || line[0] == '#') return;
+            DecodedEntry& entry = entries.emplace_back();
+            std::string_view failedField;
+            const ParseStatus status = DecodeRow(plan, tokens, entry, &failedField);
+            if (status != ParseStatus::OK) {
+                entries.pop_back();
+                errors.push_back("Error processing line: " + std::string(line) + " - " + EntryDecoder::describeFailure(status, failedField));
             }
+        });
+    }
+
+    template <auto DecodeRow>
+    void use(DecodePlan& plan) {
+        plan.decodeRow = DecodeRow;
+        plan.decodeLines = &decodeLinesWith<DecodeRow>;
+    }
+
+    template <StreamType S>
+    void useSingleAssetMarket(DecodePlan& plan) {
+        switch (plan.market) {
+            case Market::SPOT:           use<&decodeSingleAssetRow<S, Market::SPOT>>(plan); break;
+            case Market::USD_M_FUTURES:  use<&decodeSingleAssetRow<S, Market::USD_M_FUTURES>>(plan); break;
+            case Market::COIN_M_FUTURES: use<&decodeSingleAssetRow<S, Market::COIN_M_FUTURES>>(plan); break;
+            default:                     use<&rejectRow<ParseStatus::UNKNOWN_MARKET>>(plan);
+        }
+    }
+
+    size_t fieldsNeeded(const ColMap& h, const std::initializer_list<CSVHeader> columns) {
+        size_t n = 0;
+        for (const CSVHeader c : columns) {
+            if (h[c] < 0) return SIZE_MAX;
+            n = std::max(n, static_cast<size_t>(h[c]) + 1);
         }
-    default:
-        throw std::runtime_error("decodeMultiAssetParameterEntry: Unknown StreamType");
+        return n;
     }
 }
+
+DecodePlan EntryDecoder::planSingleAssetParameters(const AssetParameters &params) {
+    DecodePlan plan;
+    plan.streamType = params.streamType;
+    plan.market = params.market;
+    plan.symbolName = params.symbol;
+    std::ranges::transform(plan.symbolName, plan.symbolName.begin(), [](unsigned char c){ return static_cast<char>(std::toupper(c)); });
+    plan.symbol = parseSymbolFromName(plan.symbolName);
+
+    switch (params.streamType) {
+        case StreamType::TRADE_STREAM:            useSingleAssetMarket<StreamType::TRADE_STREAM>(plan); break;
+        case StreamType::DEPTH_SNAPSHOT:          useSingleAssetMarket<StreamType::DEPTH_SNAPSHOT>(plan); break;
+        case StreamType::DIFFERENCE_DEPTH_STREAM: useSingleAssetMarket<StreamType::DIFFERENCE_DEPTH_STREAM>(plan); break;
+        default:                                  use<&rejectRow<ParseStatus::UNKNOWN_STREAM_TYPE>>(plan);
+    }
+    return plan;
+}
+
+DecodePlan EntryDecoder::planMultiAssetParameters(const ColMap &colMap) {
+    DecodePlan plan;
+    plan.columns = colMap;
+    plan.commonFields = fieldsNeeded(colMap, {COL_TimestampOfReceiveUS, COL_Symbol, COL_Price, COL_Quantity, COL_StreamType, COL_Market, COL_IsLast});
+    plan.tradeFields = std::max(plan.commonFields, fieldsNeeded(colMap, {COL_IsBuyerMarketMaker}));
+    plan.depthFields = std::max(plan.commonFields, fieldsNeeded(colMap, {COL_IsAsk}));
+    use<&decodeMultiAssetRow>(plan);
+    return plan;
+}
+
+void EntryDecoder::decodeLines(const DecodePlan &plan, const CSVIndex &index, std::vector<DecodedEntry> &entries, std::vector<std::string> &errors) {
+    plan.decodeLines(plan, index, entries, errors);
+}
+
+ParseStatus EntryDecoder::tryDecodeEntry(const DecodePlan &plan, const CSVFields& tokens, DecodedEntry& out, std::string_view* failedField) {
+    return plan.decodeRow(plan, tokens, out, failedField);
+}
+
+DecodedEntry EntryDecoder::decodeEntry(const DecodePlan &plan, std::string_view line) {
+    thread_local std::vector<uint32_t> ends;
+    DecodedEntry out;
+    std::string_view failedField;
+    const ParseStatus status = tryDecodeEntry(plan, splitFields(line, ends), out, &failedField);
+    if (status != ParseStatus::OK) throw std::runtime_error("decodeEntry: " + describeFailure(status, failedField));
+    return out;
+}
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "EntryStream.h"
+
+size_t EntryStream::defaultDecodeThreads() {
+    // one core stays with the replay that consumes the slices
+    const unsigned cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+EntryStream::EntryStream(const std::string& csvPath, const size_t decodeThreads, const size_t chunkBytes)
+    : file_(csvPath)
+    , end_(file_.size())
+    , chunkBytes_(std::max<size_t>(chunkBytes, 1))
+    , decodeThreads_(decodeThreads)
+{}
+
+EntryStream EntryStream::openMultiAssetParametersCSV(const std::string& csvPath, const size_t decodeThreads, const size_t chunkBytes) {
+    EntryStream stream(csvPath, decodeThreads, chunkBytes);
+
+    std::string_view headerLine;
+    while (stream.pos_ < stream.file_.size()) {
+        const std::string_view line = stream.nextLine();
+        if (!line.empty() && line[0] != '#') {
+            headerLine = line;
+            break;
+        }
+    }
+    if (headerLine.empty()) throw std::runtime_error("Header not found in file: " + csvPath);
+
+    std::vector<uint32_t> ends;
+    stream.plan_ = EntryDecoder::planMultiAssetParameters(buildColMap(splitFields(headerLine, ends)));
+    return stream;
+}
+
+EntryStream EntryStream::openSingleAssetParametersCSV(const std::string& csvPath, const size_t decodeThreads, const size_t chunkBytes) {
+    EntryStream stream(csvPath, decodeThreads, chunkBytes);
+    stream.plan_ = EntryDecoder::planSingleAssetParameters(AssetParameters::decodeAssetParametersFromSingleCSVName(csvPath));
+
+    while (stream.pos_ < stream.file_.size()) {
+        const std::string_view line = stream.nextLine();
+        if (!line.empty() && line[0] != '#') break; // skip header
+    }
+    return stream;
+}
+
+std::string_view EntryStream::nextLine() {
+    const std::string_view view = file_.view();
+    const size_t end = view.find('\n', pos_);
+    const size_t stop = end == std::string_view::npos ? view.size() : end;
+    const std::string_view line = view.substr(pos_, stop - pos_);
+    pos_ = end == std::string_view::npos ? view.size() : end + 1;
+    return line;
+}
+
+void EntryStream::launch() {
+    const std::string_view view = file_.view();
+    size_t end = end_;
+    if (end_ - pos_ > chunkBytes_) {
+        const size_t nl = view.find('\n', pos_ + chunkBytes_);
+        if (nl < end_) end = nl + 1;
+    }
+    const std::string_view slice = view.substr(pos_, end - pos_);
+    pos_ = end;
+
+    std::vector<DecodedEntry> buffer;
+    if (!spare_.empty()) {
+        buffer = std::move(spare_.back());
+        spare_.pop_back();
+        buffer.clear();
+    }
+    CSVIndex index;
+    if (!spareIndexes_.empty()) {
+        index = std::move(spareIndexes_.back());
+        spareIndexes_.pop_back();
+    }
+
+    auto decode = [slice, end, buffer = std::move(buffer), index = std::move(index), plan = plan_]() mutable {
+        DecodedSlice out{std::move(buffer), {}, end, std::move(index)};
+        out.index.build(slice);
+        EntryDecoder::decodeLines(plan, out.index, out.entries, out.errors);
+        return out;
+    };
+
+    inFlight_.push_back(std::async(decodeThreads_ ? std::launch::async : std::launch::deferred, std::move(decode)));
+}
+
+void EntryStream::restrictToByteRange(const size_t begin, const size_t end) {
+    if (!inFlight_.empty()) throw std::runtime_error("EntryStream: byte range set after decoding started");
+    pos_ = std::max(pos_, begin);
+    end_ = std::min(end, file_.size());
+}
+
+bool EntryStream::next(std::vector<DecodedEntry>& chunk) {
+    spare_.push_back(std::move(chunk));
+    chunk.clear();
+
+    const size_t depth = std::max<size_t>(decodeThreads_, 1);
+    while (true) {
+        while (inFlight_.size() < depth && pos_ < end_) launch();
+        if (inFlight_.empty()) return false;
+
+        DecodedSlice slice = inFlight_.front().get();
+        inFlight_.pop_front();
+
+        // reported here rather than on the workers so messages keep file order
+        for (const std::string& error : slice.errors) std::cerr << error << std::endl;
+        file_.discardBefore(slice.end);
+        spareIndexes_.push_back(std::move(slice.index));
+
+        chunk = std::move(slice.entries);
+        if (!chunk.empty()) return true;
+        spare_.push_back(std::move(chunk));
+        chunk.clear();
+    }
+}
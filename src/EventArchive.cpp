@@ -0,0 +1,412 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+
+#include "EntryStream.h"
+#include "EventArchive.h"
+#include "FixedPoint.h"
+
+static_assert(std::endian::native == std::endian::little, "EventArchive is stored little-endian");
+static_assert(sizeof(EventArchive::Header) == 32 && sizeof(EventArchive::BlockInfo) == 32);
+
+namespace {
+    constexpr size_t STREAM_COUNT = 5; // timestamps, keys, flags, prices, quantities
+    constexpr uint8_t SIDE_BID = 0, SIDE_ASK = 1, SIDE_TRADE = 2;
+
+    [[noreturn]] void corrupt() {
+        throw std::runtime_error("Event archive block is corrupt");
+    }
+
+    uint64_t zigzag(const int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+    int64_t unzigzag(const uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+    // deltas wrap in unsigned arithmetic, so any pair of int64 values round-trips
+    int64_t delta(const int64_t value, const int64_t previous) {
+        return static_cast<int64_t>(static_cast<uint64_t>(value) - static_cast<uint64_t>(previous));
+    }
+    int64_t undelta(const int64_t d, const int64_t previous) {
+        return static_cast<int64_t>(static_cast<uint64_t>(previous) + static_cast<uint64_t>(d));
+    }
+
+    void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<uint8_t>(v) | 0x80);
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    template <typename T>
+    void putRaw(std::vector<uint8_t>& out, const T value) {
+        const size_t at = out.size();
+        out.resize(at + sizeof(T));
+        std::memcpy(out.data() + at, &value, sizeof(T));
+    }
+
+    struct ByteReader {
+        const uint8_t* p;
+        const uint8_t* end;
+
+        uint64_t varint() {
+            uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (p == end) corrupt();
+                const uint8_t b = *p++;
+                v |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80)) return v;
+            }
+            corrupt();
+        }
+
+        template <typename T>
+        T raw() {
+            if (static_cast<size_t>(end - p) < sizeof(T)) corrupt();
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+            return value;
+        }
+    };
+
+    // Previous price per (symbol, market, side) within one block; a block only ever
+    // sees a handful of keys, so a linear scan beats hashing.
+    class PreviousPrices {
+    public:
+        int64_t& operator[](const Symbol symbol, const Market market, const uint8_t side) {
+            const uint32_t key = static_cast<uint32_t>(symbol) << 16 | static_cast<uint32_t>(market) << 8 | side;
+            for (auto& [k, v] : slots_) if (k == key) return v;
+            return slots_.emplace_back(key, 0).second;
+        }
+    private:
+        std::vector<std::pair<uint32_t, int64_t>> slots_;
+    };
+
+    // Trade values: (zig-zag fixed-point delta << 1) when the double round-trips
+    // through the symbol grid, else 1 followed by the raw double.
+    void putTradeValue(std::vector<uint8_t>& out, const double value, const int64_t fixed, const bool onGrid, int64_t& previous) {
+        const uint64_t z = zigzag(delta(fixed, previous));
+        if (onGrid && z < (uint64_t{1} << 63)) {
+            putVarint(out, z << 1);
+            previous = fixed;
+        } else {
+            putVarint(out, 1);
+            putRaw(out, value);
+        }
+    }
+
+    double readTradeValue(ByteReader& in, int64_t& previous, double (*toDouble)(int64_t, Symbol), const Symbol symbol) {
+        const uint64_t v = in.varint();
+        if (v & 1) return in.raw<double>();
+        previous = undelta(unzigzag(v >> 1), previous);
+        return toDouble(previous, symbol);
+    }
+
+    // One flag column of a block: a mode byte, then either the plain bitmap or the
+    // varint lengths of alternating runs starting with a run of zeros (possibly empty),
+    // whichever is shorter.
+    constexpr uint8_t FLAGS_BITMAP = 0, FLAGS_RUNS = 1;
+
+    void putFlagColumn(std::vector<uint8_t>& out, const std::span<const uint8_t> bitmap, const size_t rows) {
+        const auto bit = [&](const size_t row) { return (bitmap[row / 8] >> (row % 8) & 1) != 0; };
+        std::vector<uint8_t> runs;
+        bool value = false;
+        uint64_t runLength = 0;
+        for (size_t row = 0; row < rows; ++row) {
+            if (bit(row) != value) {
+                putVarint(runs, runLength);
+                value = !value;
+                runLength = 0;
+            }
+            ++runLength;
+        }
+        putVarint(runs, runLength);
+
+        if (runs.size() < bitmap.size()) {
+            out.push_back(FLAGS_RUNS);
+            out.insert(out.end(), runs.begin(), runs.end());
+        } else {
+            out.push_back(FLAGS_BITMAP);
+            out.insert(out.end(), bitmap.begin(), bitmap.end());
+        }
+    }
+
+    void readFlagColumn(ByteReader& in, const std::span<uint8_t> bitmap, const size_t rows) {
+        const auto mode = in.raw<uint8_t>();
+        if (mode == FLAGS_BITMAP) {
+            if (static_cast<size_t>(in.end - in.p) < bitmap.size()) corrupt();
+            std::memcpy(bitmap.data(), in.p, bitmap.size());
+            in.p += bitmap.size();
+            return;
+        }
+        if (mode != FLAGS_RUNS) corrupt();
+
+        std::ranges::fill(bitmap, uint8_t{0});
+        bool value = false;
+        size_t row = 0;
+        do {
+            const uint64_t runLength = in.varint();
+            if (runLength > rows - row) corrupt();
+            if (value) {
+                for (size_t r = row; r < row + runLength; ++r) bitmap[r / 8] |= static_cast<uint8_t>(1u << (r % 8));
+            }
+            row += runLength;
+            value = !value;
+        } while (row < rows);
+    }
+
+    struct RowKey {
+        Symbol symbol;
+        Market market;
+        StreamType streamType;
+        bool operator==(const RowKey&) const = default;
+    };
+
+    RowKey keyOf(const DecodedEntry& entry) {
+        return {entry.symbol, entry.market, streamTypeOf(entry.kind)};
+    }
+
+    void encodeBlock(const std::span<const DecodedEntry> rows, std::vector<uint8_t>& out) {
+        std::vector<uint8_t> streams[STREAM_COUNT];
+        auto& timestamps = streams[0];
+        auto& keys = streams[1];
+        auto& prices = streams[3];
+        auto& quantities = streams[4];
+
+        const size_t bitmapBytes = (rows.size() + 7) / 8;
+        std::vector<uint8_t> bitmaps(3 * bitmapBytes, 0);
+        const auto setBit = [&](const size_t bitmap, const size_t row) {
+            bitmaps[bitmap * bitmapBytes + row / 8] |= static_cast<uint8_t>(1u << (row % 8));
+        };
+
+        int64_t previousTimestamp = 0;
+        RowKey runKey{};
+        uint64_t runLength = 0;
+        const auto flushRun = [&] {
+            if (!runLength) return;
+            putVarint(keys, runLength);
+            putVarint(keys, static_cast<uint64_t>(runKey.symbol));
+            keys.push_back(static_cast<uint8_t>(runKey.market));
+            keys.push_back(static_cast<uint8_t>(runKey.streamType));
+        };
+
+        PreviousPrices previousPrices;
+        PreviousPrices previousQuantities;
+
+        for (size_t row = 0; row < rows.size(); ++row) {
+            const DecodedEntry& entry = rows[row];
+
+            const RowKey key = keyOf(entry);
+            if (runLength && key == runKey) {
+                ++runLength;
+            } else {
+                flushRun();
+                runKey = key;
+                runLength = 1;
+            }
+
+            putVarint(timestamps, zigzag(delta(entry.timestampOfReceive, previousTimestamp)));
+            previousTimestamp = entry.timestampOfReceive;
+            if (entry.isLast()) setBit(1, row);
+
+            if (!entry.isTrade()) {
+                if (entry.isAsk()) setBit(0, row);
+                int64_t& previous = previousPrices[entry.symbol, entry.market, entry.isAsk() ? SIDE_ASK : SIDE_BID];
+                putVarint(prices, zigzag(delta(entry.priceTicks, previous)));
+                previous = entry.priceTicks;
+                putVarint(quantities, zigzag(entry.quantityLots));
+            } else {
+                if (entry.isBuyerMarketMaker()) setBit(2, row);
+                const Symbol s = entry.symbol;
+                const int64_t ticks = std::isfinite(entry.price) && std::abs(entry.price) < 9e15 / priceScaleOf(s) ? priceToTicks(entry.price, s) : 0;
+                putTradeValue(prices, entry.price, ticks, ticksToPrice(ticks, s) == entry.price,
+                              previousPrices[s, entry.market, SIDE_TRADE]);
+                const int64_t lots = std::isfinite(entry.quantity) && std::abs(entry.quantity) < 9e15 / quantityScaleOf(s) ? quantityToLots(entry.quantity, s) : 0;
+                putTradeValue(quantities, entry.quantity, lots, lotsToQuantity(lots, s) == entry.quantity,
+                              previousQuantities[s, entry.market, SIDE_TRADE]);
+            }
+        }
+        flushRun();
+        for (size_t bitmap = 0; bitmap < 3; ++bitmap) {
+            putFlagColumn(streams[2], std::span(bitmaps).subspan(bitmap * bitmapBytes, bitmapBytes), rows.size());
+        }
+
+        out.clear();
+        putRaw(out, static_cast<uint32_t>(rows.size()));
+        for (const auto& stream : streams) putRaw(out, static_cast<uint32_t>(stream.size()));
+        for (const auto& stream : streams) out.insert(out.end(), stream.begin(), stream.end());
+    }
+}
+
+void EventArchive::write(const ChunkSource& source, const std::string& outPath, const uint32_t blockRows) {
+    if (blockRows == 0) throw std::runtime_error("EventArchive: blockRows must be positive");
+
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot open event archive for writing: " + outPath);
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.blockRows = blockRows;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<BlockInfo> index;
+    std::vector<DecodedEntry> chunk;
+    std::vector<DecodedEntry> pending;
+    std::vector<uint8_t> encoded;
+    uint64_t offset = sizeof(header);
+
+    const auto flushBlock = [&](const std::span<const DecodedEntry> rows) {
+        encodeBlock(rows, encoded);
+        index.push_back({offset, static_cast<uint32_t>(encoded.size()), static_cast<uint32_t>(rows.size()),
+                         rows.front().timestampOfReceive, rows.back().timestampOfReceive});
+        out.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+        offset += encoded.size();
+        header.rowCount += rows.size();
+    };
+
+    while (source(chunk)) {
+        for (const DecodedEntry& entry : chunk) {
+            pending.push_back(entry);
+            if (pending.size() == blockRows) {
+                flushBlock(pending);
+                pending.clear();
+            }
+        }
+    }
+    if (!pending.empty()) flushBlock(pending);
+
+    header.blockCount = static_cast<uint32_t>(index.size());
+    header.indexOffset = offset;
+    out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(BlockInfo)));
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) throw std::runtime_error("Cannot write event archive: " + outPath);
+}
+
+void EventArchive::convertMultiAssetParametersCSV(const std::string& csvPath, const std::string& outPath) {
+    EntryStream stream = EntryStream::openMultiAssetParametersCSV(csvPath);
+    write([&](std::vector<DecodedEntry>& chunk) { return stream.next(chunk); }, outPath);
+}
+
+void EventArchive::convertSingleAssetParametersCSV(const std::string& csvPath, const std::string& outPath) {
+    EntryStream stream = EntryStream::openSingleAssetParametersCSV(csvPath);
+    write([&](std::vector<DecodedEntry>& chunk) { return stream.next(chunk); }, outPath);
+}
+
+bool EventArchive::isEventArchive(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(MAGIC)]{};
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+EventArchive::EventArchive(const std::string& path)
+    : file_(path)
+{
+    Header header{};
+    if (file_.size() < sizeof(header)) throw std::runtime_error("Event archive is truncated: " + path);
+    std::memcpy(&header, file_.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) throw std::runtime_error("Not an event archive: " + path);
+    if (header.version != VERSION) throw std::runtime_error("Unsupported event archive version " + std::to_string(header.version) + ": " + path);
+    if (header.indexOffset < sizeof(header) || header.indexOffset > file_.size()
+        || header.blockCount != (file_.size() - header.indexOffset) / sizeof(BlockInfo))
+        throw std::runtime_error("Event archive index is corrupt: " + path);
+
+    blocks_.resize(header.blockCount);
+    std::memcpy(blocks_.data(), file_.data() + header.indexOffset, blocks_.size() * sizeof(BlockInfo));
+
+    uint64_t expectedOffset = sizeof(header);
+    for (const BlockInfo& block : blocks_) {
+        if (block.offset != expectedOffset || block.size > header.indexOffset - block.offset)
+            throw std::runtime_error("Event archive index is corrupt: " + path);
+        expectedOffset += block.size;
+        rowCount_ += block.rowCount;
+    }
+    if (rowCount_ != header.rowCount) throw std::runtime_error("Event archive index is corrupt: " + path);
+}
+
+size_t EventArchive::findBlock(const int64_t timestampOfReceive) const {
+    const auto it = std::ranges::lower_bound(blocks_, timestampOfReceive, {}, &BlockInfo::lastTimestampOfReceive);
+    return static_cast<size_t>(it - blocks_.begin());
+}
+
+void EventArchive::decodeBlock(const size_t block, std::vector<DecodedEntry>& out) const {
+    out.clear();
+    const BlockInfo& info = blocks_.at(block);
+    const auto* base = reinterpret_cast<const uint8_t*>(file_.data()) + info.offset;
+    ByteReader header{base, base + info.size};
+
+    const uint32_t rows = header.raw<uint32_t>();
+    if (rows != info.rowCount) corrupt();
+
+    ByteReader streams[STREAM_COUNT];
+    const uint8_t* p = base + sizeof(uint32_t) * (1 + STREAM_COUNT);
+    uint32_t sizes[STREAM_COUNT];
+    for (uint32_t& size : sizes) size = header.raw<uint32_t>();
+    for (size_t s = 0; s < STREAM_COUNT; ++s) {
+        if (sizes[s] > static_cast<size_t>(base + info.size - p)) corrupt();
+        streams[s] = {p, p + sizes[s]};
+        p += sizes[s];
+    }
+    ByteReader& timestamps = streams[0];
+    ByteReader& keys = streams[1];
+    ByteReader& prices = streams[3];
+    ByteReader& quantities = streams[4];
+
+    const size_t bitmapBytes = (rows + 7) / 8;
+    std::vector<uint8_t> flags(3 * bitmapBytes);
+    for (size_t bitmap = 0; bitmap < 3; ++bitmap) {
+        readFlagColumn(streams[2], std::span(flags).subspan(bitmap * bitmapBytes, bitmapBytes), rows);
+    }
+    if (streams[2].p != streams[2].end) corrupt();
+    const auto bit = [&](const size_t bitmap, const size_t row) {
+        return (flags[bitmap * bitmapBytes + row / 8] >> (row % 8) & 1) != 0;
+    };
+
+    out.reserve(rows);
+    int64_t timestamp = 0;
+    uint64_t runLeft = 0;
+    RowKey key{};
+    PreviousPrices previousPrices;
+    PreviousPrices previousQuantities;
+
+    for (size_t row = 0; row < rows; ++row) {
+        if (runLeft == 0) {
+            runLeft = keys.varint();
+            const uint64_t symbol = keys.varint();
+            const auto market = keys.raw<uint8_t>();
+            const auto streamType = keys.raw<uint8_t>();
+            if (runLeft == 0 || symbol > UINT16_MAX) corrupt();
+            key = {static_cast<Symbol>(symbol), static_cast<Market>(market), static_cast<StreamType>(streamType)};
+        }
+        --runLeft;
+
+        timestamp = undelta(unzigzag(timestamps.varint()), timestamp);
+        const bool isLast = bit(1, row);
+
+        if (key.streamType == StreamType::TRADE_STREAM) {
+            const double price = readTradeValue(prices, previousPrices[key.symbol, key.market, SIDE_TRADE], ticksToPrice, key.symbol);
+            const double quantity = readTradeValue(quantities, previousQuantities[key.symbol, key.market, SIDE_TRADE], lotsToQuantity, key.symbol);
+            out.push_back(DecodedEntry::trade(timestamp, key.symbol, price, quantity, bit(2, row), isLast, key.market));
+        } else {
+            const bool isAsk = bit(0, row);
+            int64_t& previous = previousPrices[key.symbol, key.market, isAsk ? SIDE_ASK : SIDE_BID];
+            previous = undelta(unzigzag(prices.varint()), previous);
+            const int64_t lots = unzigzag(quantities.varint());
+            out.push_back(DecodedEntry::depth(timestamp, key.symbol, isAsk, previous, lots, isLast,
+                                              key.market, key.streamType != StreamType::DIFFERENCE_DEPTH_STREAM));
+        }
+    }
+}
+
+bool EventArchive::next(std::vector<DecodedEntry>& chunk) {
+    chunk.clear();
+    if (nextBlock_ >= blocks_.size()) return false;
+    decodeBlock(nextBlock_++, chunk);
+    return true;
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "EntryStream.h"
+#include "EventFile.h"
+
+static_assert(std::endian::native == std::endian::little, "EventFile columns are stored little-endian");
+static_assert(sizeof(EventFile::Header) == 24 + 16 * static_cast<size_t>(EventFile::Column::COUNT));
+
+namespace {
+    constexpr size_t COLUMN_COUNT = static_cast<size_t>(EventFile::Column::COUNT);
+    constexpr uint16_t COLUMN_WIDTHS[COLUMN_COUNT] = {8, 8, 8, 2, 1, 1, 1};
+    constexpr uint64_t ALIGNMENT = 64;
+
+    uint64_t alignUp(const uint64_t n) { return (n + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+    // Streams decoded chunks straight into their columns; the header is rewritten with
+    // the final row count once the source is exhausted.
+    void writeEventFile(EntryStream stream, const uint64_t capacity, const std::string& outPath) {
+        EventFile::Header header{};
+        std::memcpy(header.magic, EventFile::MAGIC, sizeof(header.magic));
+        header.version = EventFile::VERSION;
+        header.columnCount = static_cast<uint16_t>(COLUMN_COUNT);
+        header.capacity = capacity;
+        uint64_t offset = alignUp(sizeof(EventFile::Header));
+        for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+            header.columns[c] = {static_cast<uint16_t>(c), COLUMN_WIDTHS[c], 0, offset};
+            offset = alignUp(offset + COLUMN_WIDTHS[c] * capacity);
+        }
+
+        std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Cannot open event file for writing: " + outPath);
+        out.seekp(static_cast<std::streamoff>(offset - 1));
+        out.put('\0');
+
+        std::vector<DecodedEntry> chunk;
+        std::vector<int64_t> timestamps, prices, quantities;
+        std::vector<uint16_t> symbols;
+        std::vector<uint8_t> markets, streamTypes, flags;
+
+        const auto writeColumn = [&](const EventFile::Column c, const auto& values) {
+            const EventFile::ColumnInfo& info = header.columns[static_cast<size_t>(c)];
+            out.seekp(static_cast<std::streamoff>(info.offset + info.width * header.rowCount));
+            out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * info.width));
+        };
+
+        while (stream.next(chunk)) {
+            if (header.rowCount + chunk.size() > capacity) throw std::runtime_error("Event file capacity exceeded: " + outPath);
+            timestamps.clear(); prices.clear(); quantities.clear();
+            symbols.clear(); markets.clear(); streamTypes.clear(); flags.clear();
+
+            // the price / quantity slots already hold ticks / lots or the raw double bits
+            for (const DecodedEntry& entry : chunk) {
+                timestamps.push_back(entry.timestampOfReceive);
+                prices.push_back(entry.priceTicks);
+                quantities.push_back(entry.quantityLots);
+                symbols.push_back(static_cast<uint16_t>(entry.symbol));
+                markets.push_back(static_cast<uint8_t>(entry.market));
+                streamTypes.push_back(static_cast<uint8_t>(streamTypeOf(entry.kind)));
+                flags.push_back(entry.flags);
+            }
+
+            writeColumn(EventFile::Column::TIMESTAMP_OF_RECEIVE, timestamps);
+            writeColumn(EventFile::Column::PRICE, prices);
+            writeColumn(EventFile::Column::QUANTITY, quantities);
+            writeColumn(EventFile::Column::SYMBOL, symbols);
+            writeColumn(EventFile::Column::MARKET, markets);
+            writeColumn(EventFile::Column::STREAM_TYPE, streamTypes);
+            writeColumn(EventFile::Column::FLAGS, flags);
+            header.rowCount += chunk.size();
+        }
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!out) throw std::runtime_error("Cannot write event file: " + outPath);
+    }
+
+    // Upper bound on the rows of a CSV: one per line.
+    uint64_t lineCountOf(const std::string& csvPath) {
+        const MMapData csv(csvPath);
+        return static_cast<uint64_t>(std::ranges::count(csv.view(), '\n')) + 1;
+    }
+}
+
+void EventFile::convertMultiAssetParametersCSV(const std::string& csvPath, const std::string& outPath) {
+    writeEventFile(EntryStream::openMultiAssetParametersCSV(csvPath), lineCountOf(csvPath), outPath);
+}
+
+void EventFile::convertSingleAssetParametersCSV(const std::string& csvPath, const std::string& outPath) {
+    writeEventFile(EntryStream::openSingleAssetParametersCSV(csvPath), lineCountOf(csvPath), outPath);
+}
+
+bool EventFile::isEventFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(MAGIC)]{};
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+EventFile::EventFile(const std::string& path, const size_t chunkRows)
+    : file_(path)
+    , chunkRows_(std::max<size_t>(chunkRows, 1))
+{
+    Header header{};
+    if (file_.size() < sizeof(header)) throw std::runtime_error("Event file is truncated: " + path);
+    std::memcpy(&header, file_.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) throw std::runtime_error("Not an event file: " + path);
+    if (header.version != VERSION) throw std::runtime_error("Unsupported event file version " + std::to_string(header.version) + ": " + path);
+    if (header.columnCount != COLUMN_COUNT || header.rowCount > header.capacity) throw std::runtime_error("Event file header is corrupt: " + path);
+
+    for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+        const ColumnInfo& info = header.columns[c];
+        if (info.column != c || info.width != COLUMN_WIDTHS[c] || info.offset % ALIGNMENT != 0
+            || info.offset > file_.size() || header.capacity > (file_.size() - info.offset) / info.width)
+            throw std::runtime_error("Event file column " + std::to_string(c) + " is corrupt: " + path);
+        columns_[c] = file_.data() + info.offset;
+    }
+    rowCount_ = header.rowCount;
+}
+
+DecodedEntry EventFile::entry(const size_t row) const {
+    DecodedEntry e;
+    e.timestampOfReceive = timestampsOfReceive()[row];
+    e.priceTicks = prices()[row];
+    e.quantityLots = quantities()[row];
+    e.symbol = static_cast<Symbol>(symbols()[row]);
+    e.kind = entryKindOf(static_cast<StreamType>(streamTypes()[row]));
+    e.flags = flags()[row] & (DecodedEntry::IS_ASK | DecodedEntry::IS_LAST | DecodedEntry::IS_BUYER_MARKET_MAKER);
+    e.market = static_cast<Market>(markets()[row]);
+    return e;
+}
+
+bool EventFile::next(std::vector<DecodedEntry>& chunk) {
+    chunk.clear();
+    const size_t end = std::min(rowCount_, position_ + chunkRows_);
+    for (; position_ < end; ++position_) chunk.push_back(entry(position_));
+    return !chunk.empty();
+}
@@ -2,23 +2,35 @@
 
 #include "GlobalMarketState.h"
 
-GlobalMarketState::GlobalMarketState(const MetricMask& mask)
-    : mask_(mask), calculator_(mask) {}
+GlobalMarketState::GlobalMarketState(const MetricMask& mask, const size_t depthLimit)
+    : mask_(mask), calculator_(mask), depthLimit_(depthLimit) {}
 
-GlobalMarketState::GlobalMarketState(const std::vector<std::string>& variables)
-    : GlobalMarketState(parseMask(variables)) {}
+GlobalMarketState::GlobalMarketState(const std::vector<std::string>& variables, const size_t depthLimit)
+    : GlobalMarketState(parseMask(variables), depthLimit) {}
 
 void GlobalMarketState::update(DecodedEntry* entry) {
     AssetKey key{*entry};
-    auto [it, inserted] = marketStates_.try_emplace(key, key.market, key.symbol);
+    auto [it, inserted] = marketStates_.try_emplace(key, key.market, key.symbol, depthLimit_);
     it->second.update(entry);
 }
 
+void GlobalMarketState::updateBatch(const std::span<const DifferenceDepthEntry> group) {
+    if (group.empty()) return;
+    const AssetKey key{group.front().market, group.front().symbol};
+    auto [it, inserted] = marketStates_.try_emplace(key, key.market, key.symbol, depthLimit_);
+    it->second.updateBatch(group);
+}
+
 std::optional<OrderBookMetricsEntry> GlobalMarketState::countMarketStateMetricsByEntry(DecodedEntry* entry) {
     const AssetKey key{*entry};
     return calculator_.countMarketStateMetrics(marketStates_[key]);
 }
 
+bool GlobalMarketState::countMarketStateMetricsByEntry(DecodedEntry* entry, OrderBookMetricsEntry& out) {
+    const AssetKey key{*entry};
+    return calculator_.countMarketStateMetrics(marketStates_[key], out);
+}
+
 std::optional<OrderBookMetricsEntry> GlobalMarketState::countMarketStateMetrics(Symbol symbol, const Market& market) {
     AssetKey key{ market, symbol };
     auto it = marketStates_.find(key);
@@ -49,3 +61,35 @@ std::vector<std::pair<Symbol, Market>> GlobalMarketState::getMarketStateList() c
     }
     return out;
 }
+
+void GlobalMarketState::saveState(Checkpoint::Writer& w) const {
+    const std::string maskBits = mask_.to_string();
+    w.writeArray(std::span<const char>(maskBits));
+    w.write<uint64_t>(depthLimit_);
+    w.write<uint64_t>(marketStates_.size());
+    for (const auto& [key, marketState] : marketStates_) {
+        w.write(key.market);
+        w.write(key.symbol);
+        marketState.saveState(w);
+    }
+}
+
+void GlobalMarketState::loadState(Checkpoint::Reader& r) {
+    const std::vector<char> maskBits = r.readArray<char>();
+    if (maskBits.size() != METRICS_COUNT) {
+        throw std::runtime_error("GlobalMarketState checkpoint was written with a different metric list");
+    }
+    mask_ = MetricMask(std::string(maskBits.begin(), maskBits.end()));
+    calculator_ = OrderBookMetricsCalculator(mask_);
+    depthLimit_ = r.read<uint64_t>();
+
+    marketStates_.clear();
+    const auto count = r.read<uint64_t>();
+    for (uint64_t i = 0; i < count; ++i) {
+        const auto market = r.read<Market>();
+        const auto symbol = r.read<Symbol>();
+        const AssetKey key{market, symbol};
+        auto [it, inserted] = marketStates_.try_emplace(key, market, symbol, depthLimit_);
+        it->second.loadState(r);
+    }
+}
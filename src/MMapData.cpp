@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "MMapData.h"
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MMapData::MMapData(const std::string& path) {
+    HANDLE hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Cannot open file: " + path);
+
+    LARGE_INTEGER filesize;
+    if (!GetFileSizeEx(hFile, &filesize)) {
+        CloseHandle(hFile);
+        throw std::runtime_error("Cannot get file size: " + path);
+    }
+    if (filesize.QuadPart == 0) {
+        CloseHandle(hFile);
+        throw std::runtime_error("File is empty: " + path);
+    }
+    size_ = static_cast<size_t>(filesize.QuadPart);
+
+    if (HANDLE hMap = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+        if (void* view = MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0)) {
+            data_ = static_cast<const char*>(view);
+            mapped_ = true;
+            hFile_ = hFile;
+            hMap_ = hMap;
+            return;
+        }
+        CloseHandle(hMap);
+    }
+
+    // mapping refused (network share, locked file...): read the whole file instead
+    buffer_.resize(size_);
+    size_t done = 0;
+    while (done < size_) {
+        DWORD chunk = 0;
+        const DWORD want = static_cast<DWORD>(std::min<size_t>(size_ - done, 1u << 30));
+        if (!ReadFile(hFile, buffer_.data() + done, want, &chunk, nullptr) || chunk == 0) {
+            CloseHandle(hFile);
+            throw std::runtime_error("Cannot read file: " + path);
+        }
+        done += chunk;
+    }
+    CloseHandle(hFile);
+    data_ = buffer_.data();
+}
+
+void MMapData::discardBefore(size_t) noexcept {}
+
+void MMapData::release() noexcept {
+    if (mapped_) UnmapViewOfFile(data_);
+    if (hMap_) CloseHandle(static_cast<HANDLE>(hMap_));
+    if (hFile_) CloseHandle(static_cast<HANDLE>(hFile_));
+    hMap_ = hFile_ = nullptr;
+}
+
+#else
+
+MMapData::MMapData(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open file: " + path);
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot get file size: " + path);
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error("File is empty: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+
+    void* view = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view != MAP_FAILED) {
+        ::madvise(view, size_, MADV_SEQUENTIAL);
+    #ifdef MADV_HUGEPAGE
+        ::madvise(view, size_, MADV_HUGEPAGE);
+    #endif
+        ::close(fd);
+        data_ = static_cast<const char*>(view);
+        mapped_ = true;
+        return;
+    }
+
+    // filesystem without mmap support (some FUSE / network mounts): read the whole file
+    buffer_.resize(size_);
+    size_t done = 0;
+    while (done < size_) {
+        const ssize_t chunk = ::read(fd, buffer_.data() + done, size_ - done);
+        if (chunk <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot read file: " + path);
+        }
+        done += static_cast<size_t>(chunk);
+    }
+    ::close(fd);
+    data_ = buffer_.data();
+}
+
+void MMapData::discardBefore(const size_t offset) noexcept {
+    if (!mapped_) return;
+    static const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t end = std::min(offset, size_) & ~(pageSize - 1);
+    if (end <= discarded_) return;
+    ::madvise(const_cast<char*>(data_) + discarded_, end - discarded_, MADV_DONTNEED);
+    discarded_ = end;
+}
+
+void MMapData::release() noexcept {
+    if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+}
+
+#endif
+
+MMapData::~MMapData() {
+    release();
+}
+
+MMapData::MMapData(MMapData&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mapped_(std::exchange(other.mapped_, false))
+    , discarded_(std::exchange(other.discarded_, 0))
+    , buffer_(std::move(other.buffer_))
+#ifdef _WIN32
+    , hFile_(std::exchange(other.hFile_, nullptr))
+    , hMap_(std::exchange(other.hMap_, nullptr))
+#endif
+{}
+
+MMapData& MMapData::operator=(MMapData&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+        discarded_ = std::exchange(other.discarded_, 0);
+        buffer_ = std::move(other.buffer_);
+#ifdef _WIN32
+        hFile_ = std::exchange(other.hFile_, nullptr);
+        hMap_ = std::exchange(other.hMap_, nullptr);
+#endif
+    }
+    return *this;
+}
@@ -1,34 +1,61 @@
-#include <variant>
-
 #include "MarketState.h"
 #include "enums/TradeEntry.h"
 #include "SingleVariableCounter.h"
 
 void MarketState::update(DecodedEntry* entry) {
+    lastTimestampOfReceive = entry->timestampOfReceive;
 
-    std::visit([this](auto const& e){
-        this->lastTimestampOfReceive = e.timestampOfReceive;
-    }, *entry);
-
-    if (auto* differenceDepthEntry = std::get_if<DifferenceDepthEntry>(entry)) {
-        orderBook.update(differenceDepthEntry);
-        rollingDifferenceDepthStatistics.update(*differenceDepthEntry);
+    switch (entry->kind) {
+        case EntryKind::DEPTH_SNAPSHOT: {
+            const DifferenceDepthEntry& level = pendingSnapshot_.emplace_back(entry->toDifferenceDepthEntry());
+            rollingDifferenceDepthStatistics.update(level);
+            if (entry->isLast()) flushPendingSnapshot();
+            break;
+        }
+        case EntryKind::DIFFERENCE_DEPTH: {
+            DifferenceDepthEntry level = entry->toDifferenceDepthEntry();
+            flushPendingSnapshot();
+            orderBook.update(&level);
+            rollingDifferenceDepthStatistics.update(level);
+            break;
+        }
+        case EntryKind::TRADE: {
+            lastTrade = entry->toTradeEntry();
+            hasLastTrade = true;
+            rollingTradeStatistics.update(lastTrade);
+            break;
+        }
     }
+}
 
-    if (auto* tradeEntry = std::get_if<TradeEntry>(entry)) {
-        lastTrade = *tradeEntry;
-        lastTradePtr = &lastTrade;
-        hasLastTrade = true;
-        rollingTradeStatistics.update(*tradeEntry);
+void MarketState::updateBatch(const std::span<const DifferenceDepthEntry> group) {
+    if (group.empty()) return;
+    lastTimestampOfReceive = group.back().timestampOfReceive;
+    if (group.front().isSnapshot) {
+        pendingSnapshot_.insert(pendingSnapshot_.end(), group.begin(), group.end());
+        if (group.back().isLast) flushPendingSnapshot();
+    } else {
+        flushPendingSnapshot();
+        orderBook.applyBatch(group);
     }
+    for (const DifferenceDepthEntry& e : group) {
+        rollingDifferenceDepthStatistics.update(e);
+    }
+}
+
+void MarketState::flushPendingSnapshot() {
+    if (pendingSnapshot_.empty()) return;
+    orderBook.loadSnapshot(pendingSnapshot_);
+    pendingSnapshot_.clear();
 }
 
 void MarketState::updateOrderBook(int64_t timestampOfReceive, double price, double quantity, bool isAsk){
     lastTimestampOfReceive = timestampOfReceive;
-    DifferenceDepthEntry e;
+    DifferenceDepthEntry e{};
     e.timestampOfReceive = timestampOfReceive;
-    e.price              = price;
-    e.quantity           = quantity;
+    e.symbol             = symbol;
+    e.priceTicks         = priceToTicks(price, symbol);
+    e.quantityLots       = quantityToLots(quantity, symbol);
     e.isAsk              = isAsk;
     orderBook.update(&e);
 }
@@ -39,6 +66,79 @@ void MarketState::updateTradeRegistry(int64_t timestampOfReceive, double price,
     lastTrade.price              = price;
     lastTrade.quantity           = quantity;
     lastTrade.isBuyerMarketMaker = isBuyerMM;
-    lastTradePtr = &lastTrade;
     hasLastTrade = true;
 }
+
+namespace {
+    // levels only, not arena pointers
+    void saveEntry(Checkpoint::Writer& w, const DifferenceDepthEntry& e) {
+        w.write(e.timestampOfReceive);
+        w.write(e.symbol);
+        w.writeBool(e.isAsk);
+        w.write(e.priceTicks);
+        w.write(e.quantityLots);
+        w.writeBool(e.isLast);
+        w.write(e.market);
+        w.writeBool(e.isSnapshot);
+    }
+
+    DifferenceDepthEntry loadEntry(Checkpoint::Reader& r) {
+        const auto timestampOfReceive = r.read<int64_t>();
+        const auto symbol = r.read<Symbol>();
+        const bool isAsk = r.readBool();
+        const auto priceTicks = r.read<int64_t>();
+        const auto quantityLots = r.read<int64_t>();
+        const bool isLast = r.readBool();
+        const auto market = r.read<Market>();
+        const bool isSnapshot = r.readBool();
+        return {timestampOfReceive, symbol, isAsk, priceTicks, quantityLots, isLast, market, isSnapshot};
+    }
+
+    void saveTrade(Checkpoint::Writer& w, const TradeEntry& t) {
+        w.write(t.timestampOfReceive);
+        w.write(t.symbol);
+        w.write(t.price);
+        w.write(t.quantity);
+        w.writeBool(t.isBuyerMarketMaker);
+        w.writeBool(t.isLast);
+        w.write(t.market);
+    }
+
+    TradeEntry loadTrade(Checkpoint::Reader& r) {
+        const auto timestampOfReceive = r.read<int64_t>();
+        const auto symbol = r.read<Symbol>();
+        const auto price = r.read<double>();
+        const auto quantity = r.read<double>();
+        const bool isBuyerMarketMaker = r.readBool();
+        const bool isLast = r.readBool();
+        const auto market = r.read<Market>();
+        return {timestampOfReceive, symbol, price, quantity, isBuyerMarketMaker, isLast, market};
+    }
+}
+
+void MarketState::saveState(Checkpoint::Writer& w) const {
+    w.write(market);
+    w.write(symbol);
+    w.write(lastTimestampOfReceive);
+    w.writeBool(hasLastTrade);
+    saveTrade(w, lastTrade);
+    w.write<uint64_t>(pendingSnapshot_.size());
+    for (const DifferenceDepthEntry& e : pendingSnapshot_) saveEntry(w, e);
+    orderBook.saveState(w);
+    rollingTradeStatistics.saveState(w);
+    rollingDifferenceDepthStatistics.saveState(w);
+}
+
+void MarketState::loadState(Checkpoint::Reader& r) {
+    market = r.read<Market>();
+    symbol = r.read<Symbol>();
+    lastTimestampOfReceive = r.read<uint64_t>();
+    hasLastTrade = r.readBool();
+    lastTrade = loadTrade(r);
+    pendingSnapshot_.clear();
+    const auto pendingCount = r.read<uint64_t>();
+    for (uint64_t i = 0; i < pendingCount; ++i) pendingSnapshot_.push_back(loadEntry(r));
+    orderBook.loadState(r);
+    rollingTradeStatistics.loadState(r);
+    rollingDifferenceDepthStatistics.loadState(r);
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "MergedEntryStream.h"
+
+namespace {
+    // std heap functions build a max-heap; this orders it so the earliest message is on
+    // top, with the lower source index first on equal timestamps.
+    struct LaterFirst {
+        template <typename P>
+        bool operator()(const P& a, const P& b) const {
+            return a.timestampOfReceive != b.timestampOfReceive ? a.timestampOfReceive > b.timestampOfReceive : a.source > b.source;
+        }
+    };
+}
+
+MergedEntryStream MergedEntryStream::openSingleAssetParametersCSVs(const std::vector<std::string>& csvPaths, const size_t decodeThreads, const size_t chunkRows) {
+    if (csvPaths.empty()) throw std::runtime_error("MergedEntryStream: no CSV files given");
+
+    MergedEntryStream merged(std::max<size_t>(chunkRows, 1));
+    const size_t threadsPerFile = decodeThreads ? std::max<size_t>(decodeThreads / csvPaths.size(), 1) : 0;
+
+    merged.sources_.reserve(csvPaths.size());
+    for (const std::string& path : csvPaths) {
+        merged.sources_.push_back({EntryStream::openSingleAssetParametersCSV(path, threadsPerFile), {}, 0});
+    }
+    merged.heap_.reserve(csvPaths.size());
+    for (uint32_t s = 0; s < merged.sources_.size(); ++s) merged.pushPending(s);
+    return merged;
+}
+
+bool MergedEntryStream::Source::fill() {
+    while (pos == rows.size()) {
+        pos = 0;
+        if (!stream.next(rows)) return false;
+    }
+    return true;
+}
+
+void MergedEntryStream::pushPending(const uint32_t source) {
+    Source& s = sources_[source];
+    if (!s.fill()) return;
+    heap_.push_back({s.rows[s.pos].timestampOfReceive, source});
+    std::ranges::push_heap(heap_, LaterFirst{});
+}
+
+void MergedEntryStream::appendMessage(Source& source, std::vector<DecodedEntry>& chunk) {
+    const DecodedEntry& first = source.rows[source.pos];
+    const int64_t timestampOfReceive = first.timestampOfReceive;
+    const EntryKind kind = first.kind;
+    const Symbol symbol = first.symbol;
+
+    chunk.push_back(first);
+    ++source.pos;
+    if (kind != EntryKind::TRADE) {
+        while (source.fill()) {
+            const DecodedEntry& e = source.rows[source.pos];
+            if (e.timestampOfReceive != timestampOfReceive || e.kind != kind || e.symbol != symbol) break;
+            chunk.back().flags &= ~DecodedEntry::IS_LAST;
+            chunk.push_back(e);
+            ++source.pos;
+        }
+    }
+    chunk.back().flags |= DecodedEntry::IS_LAST;
+}
+
+bool MergedEntryStream::next(std::vector<DecodedEntry>& chunk) {
+    chunk.clear();
+    while (!heap_.empty() && chunk.size() < chunkRows_) {
+        std::ranges::pop_heap(heap_, LaterFirst{});
+        const uint32_t source = heap_.back().source;
+        heap_.pop_back();
+
+        appendMessage(sources_[source], chunk);
+        pushPending(source);
+    }
+    return !chunk.empty();
+}
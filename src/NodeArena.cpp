@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "NodeArena.h"
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+#endif
+
+namespace {
+    size_t roundUp(const size_t bytes, const size_t granule) {
+        return (bytes + granule - 1) / granule * granule;
+    }
+
+    void* mapChunk(const size_t bytes, const bool wantHugePages) {
+#ifdef _WIN32
+        if (wantHugePages) {
+            const SIZE_T large = GetLargePageMinimum();
+            if (large && bytes % large == 0) {
+                void* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+                if (p) return p;
+            }
+        }
+        void* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!p) throw std::bad_alloc();
+        return p;
+#else
+    #ifdef MAP_HUGETLB
+        if (wantHugePages) {
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) return p;
+        }
+    #endif
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+    #ifdef MADV_HUGEPAGE
+        if (wantHugePages) madvise(p, bytes, MADV_HUGEPAGE);
+    #endif
+        return p;
+#endif
+    }
+
+    void unmapChunk(void* memory, const size_t bytes) {
+#ifdef _WIN32
+        (void)bytes;
+        VirtualFree(memory, 0, MEM_RELEASE);
+#else
+        munmap(memory, bytes);
+#endif
+    }
+}
+
+NodeArena::NodeArena(const size_t initialNodes, const bool hugePages)
+    : nextChunkBytes_(roundUp(std::max<size_t>(initialNodes, 1) * sizeof(DifferenceDepthEntry), PAGE_BYTES))
+    , hugePages_(hugePages)
+{
+    if (hugePages_) nextChunkBytes_ = roundUp(nextChunkBytes_, HUGE_PAGE_BYTES);
+    grow();
+}
+
+NodeArena::~NodeArena() {
+    release();
+}
+
+NodeArena::NodeArena(NodeArena&& other) noexcept
+    : chunks_(std::move(other.chunks_))
+    , freeListHead_(std::exchange(other.freeListHead_, nullptr))
+    , capacity_(std::exchange(other.capacity_, 0))
+    , nextChunkBytes_(other.nextChunkBytes_)
+    , hugePages_(other.hugePages_)
+{
+    other.chunks_.clear();
+}
+
+NodeArena& NodeArena::operator=(NodeArena&& other) noexcept {
+    if (this != &other) {
+        release();
+        chunks_ = std::move(other.chunks_);
+        other.chunks_.clear();
+        freeListHead_ = std::exchange(other.freeListHead_, nullptr);
+        capacity_ = std::exchange(other.capacity_, 0);
+        nextChunkBytes_ = other.nextChunkBytes_;
+        hugePages_ = other.hugePages_;
+    }
+    return *this;
+}
+
+void NodeArena::grow() {
+    addChunk(nextChunkBytes_);
+    // double until a chunk spans a huge page, then keep adding huge-page sized chunks
+    nextChunkBytes_ = std::min(nextChunkBytes_ * 2, std::max(nextChunkBytes_, HUGE_PAGE_BYTES));
+}
+
+void NodeArena::addChunk(const size_t bytes) {
+    void* memory = mapChunk(bytes, hugePages_);
+    chunks_.push_back(Chunk{memory, bytes});
+
+    const size_t count = bytes / sizeof(DifferenceDepthEntry);
+    auto *nodes = static_cast<DifferenceDepthEntry*>(memory);
+    std::uninitialized_default_construct_n(nodes, count);
+    for (size_t i = 0; i + 1 < count; ++i) {
+        nodes[i].next_ = &nodes[i + 1];
+    }
+    nodes[count - 1].next_ = freeListHead_;
+    freeListHead_ = nodes;
+    capacity_ += count;
+}
+
+void NodeArena::release() {
+    for (const Chunk& chunk : chunks_) {
+        unmapChunk(chunk.memory, chunk.bytes);
+    }
+    chunks_.clear();
+    freeListHead_ = nullptr;
+    capacity_ = 0;
+}
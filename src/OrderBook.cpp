@@ -1,249 +1,446 @@
 #include <algorithm>
+#include <array>
 #include <iostream>
 #include <limits>
+#include <numeric>
+#include <stdexcept>
 
 #include "OrderBook.h"
 
-OrderBook::OrderBook(const size_t maxLevels) {
-    arena.resize(maxLevels);
-    for (size_t i = 0; i + 1 < maxLevels; ++i) {
-        arena[i].next_ = &arena[i + 1];
+OrderBook::OrderBook(const size_t depthLimit, const size_t initialLevels, const size_t topLevels, const bool hugePages)
+    : arena(depthLimit ? std::min(initialLevels, 2 * depthLimit + 2) : initialLevels, hugePages)
+    , depthLimit_(depthLimit)
+    , topLevels_(std::max<size_t>(topLevels, 1))
+{
+    askTop_.priceTicks.resize(topLevels_);
+    askTop_.cumulativeLots.resize(topLevels_);
+    bidTop_.priceTicks.resize(topLevels_);
+    bidTop_.cumulativeLots.resize(topLevels_);
+}
+
+OrderBook::OrderBook(const Symbol symbol, const size_t depthLimit, const size_t initialLevels, const size_t topLevels, const bool hugePages)
+    : OrderBook(depthLimit, initialLevels, topLevels, hugePages)
+{
+    adoptSymbol(symbol);
+}
+
+void OrderBook::adoptSymbol(const Symbol symbol) {
+    if (askCount_ || bidCount_) {
+        throw std::runtime_error("Entry symbol does not match the order book");
     }
-    arena[maxLevels - 1].next_ = nullptr;
-    freeListHead_ = &arena[0];
+    symbol_ = symbol;
+    priceScale_ = priceScaleOf(symbol);
+    quantityScale_ = quantityScaleOf(symbol);
 }
 
-auto OrderBook::allocateNode(double price, bool isAsk, double quantity)
+auto OrderBook::allocateNode(int64_t priceTicks, bool isAsk, int64_t quantityLots)
     -> DifferenceDepthEntry*
 {
-    if (!freeListHead_) throw std::runtime_error("Pool exhausted");
-    auto *node = freeListHead_;
-    freeListHead_ = freeListHead_->next_;
-    node->price = price;
+    auto *node = arena.allocate();
+    node->priceTicks = priceTicks;
     node->isAsk = isAsk;
-    node->quantity = quantity;
+    node->quantityLots = quantityLots;
     node->prev_ = node->next_ = nullptr;
     return node;
 }
 
-void OrderBook::deallocateNode(DifferenceDepthEntry* node) {
-    node->next_ = freeListHead_;
-    freeListHead_ = node;
+void OrderBook::insertNodeBefore(DifferenceDepthEntry*& head, DifferenceDepthEntry*& tail, DifferenceDepthEntry* node, DifferenceDepthEntry* next) {
+    node->next_ = next;
+    node->prev_ = next ? next->prev_ : tail;
+
+    if (node->prev_) node->prev_->next_ = node;
+    else head = node;
+
+    if (next) next->prev_ = node;
+    else tail = node;
 }
 
-void OrderBook::addNode(DifferenceDepthEntry*& head, DifferenceDepthEntry*& tail, DifferenceDepthEntry* node, bool isAsk) {
-    if (!head) {
-        head = tail = node;
-        node->prev_ = node->next_ = nullptr;
-        return;
+void OrderBook::removeNode(DifferenceDepthEntry*& head, DifferenceDepthEntry*& tail, DifferenceDepthEntry* node) {
+    if (node->prev_) node->prev_->next_ = node->next_;
+    else head = node->next_;
+
+    if (node->next_) node->next_->prev_ = node->prev_;
+    else tail = node->prev_;
+
+    node->prev_ = node->next_ = nullptr;
+}
+
+void OrderBook::update(DifferenceDepthEntry* e) {
+    if (e->symbol != symbol_) adoptSymbol(e->symbol);
+
+    applyLevel(e);
+
+    if (e->isLast) computeDeltas();
+}
+
+void OrderBook::applyBatch(const std::span<const DifferenceDepthEntry> group) {
+    if (group.empty()) return;
+
+    if (group.front().symbol != symbol_) adoptSymbol(group.front().symbol);
+
+    // asks best-first, then bids best-first; stable so repeated prices keep message order
+    const auto levelOrder = [&group](const uint32_t a, const uint32_t b) {
+        const DifferenceDepthEntry& x = group[a];
+        const DifferenceDepthEntry& y = group[b];
+        if (x.isAsk != y.isAsk) return x.isAsk;
+        return ladderKey(x.priceTicks, x.isAsk) < ladderKey(y.priceTicks, y.isAsk);
+    };
+
+    batchOrder_.resize(group.size());
+    std::iota(batchOrder_.begin(), batchOrder_.end(), 0u);
+    if (!std::ranges::is_sorted(batchOrder_, levelOrder)) {
+        std::ranges::stable_sort(batchOrder_, levelOrder);
     }
 
-    if (isAsk) {
-        auto it = askMap_.find(node->price);
-        if (it == askMap_.end()) {
-            node->next_ = head;
-            head->prev_ = node;
-            node->prev_ = nullptr;
-            head = node;
-        }
-        else {
-            auto nextIt = std::next(it);
-            if (nextIt == askMap_.end()) {
-                tail->next_ = node;
-                node->prev_ = tail;
-                node->next_ = nullptr;
-                tail = node;
-            } else {
-                DifferenceDepthEntry* nextNode = nextIt->second;
-                DifferenceDepthEntry* prevNode = nextNode->prev_;
+    for (const uint32_t i : batchOrder_) {
+        applyLevel(&group[i]);
+    }
 
-                node->next_ = nextNode;
-                node->prev_ = prevNode;
+    if (group.back().isLast) computeDeltas();
+}
 
-                if (prevNode) prevNode->next_ = node;
-                else head = node;
+void OrderBook::clear() {
+    for (auto *node = askHead_; node; ) {
+        auto *next = node->next_;
+        arena.deallocate(node);
+        node = next;
+    }
+    for (auto *node = bidHead_; node; ) {
+        auto *next = node->next_;
+        arena.deallocate(node);
+        node = next;
+    }
+    askHead_ = askTail_ = bidHead_ = bidTail_ = nullptr;
+    askLadder_.clear();
+    bidLadder_.clear();
+    askOverflow_.clear();
+    bidOverflow_.clear();
+    askCount_ = bidCount_ = 0;
+    sumAskQuantity_ = sumBidQuantity_ = 0;
+    sumOfPriceTimesQuantity_ = NotionalSum{};
+    askTop_.dirty = bidTop_.dirty = true;
+}
+
+void OrderBook::loadSnapshot(const std::span<const DifferenceDepthEntry> levels) {
+    clear();
+    if (levels.empty()) return;
+    if (levels.front().symbol != symbol_) adoptSymbol(levels.front().symbol);
 
-                nextNode->prev_ = node;
+    batchOrder_.clear();
+    snapshotBidOrder_.clear();
+    for (uint32_t i = 0; i < levels.size(); ++i) {
+        (levels[i].isAsk ? batchOrder_ : snapshotBidOrder_).push_back(i);
+    }
+    orderBestFirst(levels, batchOrder_, true);
+    orderBestFirst(levels, snapshotBidOrder_, false);
+
+    for (const auto *order : {&batchOrder_, &snapshotBidOrder_}) {
+        bool first = true;
+        int64_t prevKey = 0;
+        for (const uint32_t i : *order) {
+            const DifferenceDepthEntry* e = &levels[i];
+            const int64_t key = ladderKey(e->priceTicks, e->isAsk);
+            if (!first && key == prevKey) {
+                // repeated price inside the snapshot: the later row wins
+                applyLevel(e);
+                continue;
             }
+            if (e->quantityLots == 0) continue;
+            appendSnapshotLevel(e, key);
+            first = false;
+            prevKey = key;
         }
-    } else {
-        auto it = bidMap_.find(node->price);
-        if (it == bidMap_.end()) {
-            node->next_ = head;
-            head->prev_ = node;
-            node->prev_ = nullptr;
-            head = node;
-        } else {
-            auto nextIt = std::next(it);
-            if (nextIt == bidMap_.end()) {
-                tail->next_ = node;
-                node->prev_ = tail;
-                node->next_ = nullptr;
-                tail = node;
-            } else {
-                DifferenceDepthEntry* nextNode = nextIt->second;
-                DifferenceDepthEntry* prevNode = nextNode->prev_;
+    }
 
-                node->next_ = nextNode;
-                node->prev_ = prevNode;
+    if (levels.back().isLast) computeDeltas();
+}
 
-                if (prevNode) prevNode->next_ = node;
-                else head = node;
+void OrderBook::orderBestFirst(const std::span<const DifferenceDepthEntry> levels, std::vector<uint32_t>& order, const bool isAsk) {
+    const auto keyOf = [&levels, isAsk](const uint32_t i) { return ladderKey(levels[i].priceTicks, isAsk); };
+    if (std::ranges::is_sorted(order, std::less<>{}, keyOf)) return;
+    // only a strictly worst-first side may be reversed: reversing equal keys would
+    // let the earlier of two rows with the same price win
+    if (std::ranges::adjacent_find(order, std::less_equal<>{}, keyOf) == order.end()) {
+        std::ranges::reverse(order);
+        return;
+    }
+    std::ranges::stable_sort(order, std::less<>{}, keyOf);
+}
 
-                nextNode->prev_ = node;
-            }
+void OrderBook::appendSnapshotLevel(const DifferenceDepthEntry* e, const int64_t key) {
+    size_t& count = e->isAsk ? askCount_ : bidCount_;
+    int64_t& sumQuantity = e->isAsk ? sumAskQuantity_ : sumBidQuantity_;
+    ++count;
+    sumQuantity += e->quantityLots;
+    sumOfPriceTimesQuantity_.add(e->priceTicks, e->quantityLots);
+
+    DepthOverflow& overflow = e->isAsk ? askOverflow_ : bidOverflow_;
+    if (depthLimit_ && count - 1 - overflow.size() >= depthLimit_) {
+        overflow.insert(key, {e->quantityLots, e->timestampOfReceive, e->market});
+        return;
+    }
+
+    auto *node = arena.allocate();
+    *node = *e;
+    (e->isAsk ? askLadder_ : bidLadder_).append(key, node);
+    if (e->isAsk) insertNodeBefore(askHead_, askTail_, node, nullptr);
+    else insertNodeBefore(bidHead_, bidTail_, node, nullptr);
+}
+
+namespace {
+    struct SavedLevel {
+        int64_t priceTicks;
+        int64_t quantityLots;
+        int64_t timestampOfReceive;
+        Market market;
+        bool isLast;
+    };
+
+    void saveLevels(Checkpoint::Writer& w, const std::span<const SavedLevel> levels) {
+        w.write<uint64_t>(levels.size());
+        for (const SavedLevel& level : levels) {
+            w.write(level.priceTicks);
+            w.write(level.quantityLots);
+            w.write(level.timestampOfReceive);
+            w.write(level.market);
+            w.writeBool(level.isLast);
         }
     }
+
+    SavedLevel loadLevel(Checkpoint::Reader& r) {
+        SavedLevel level{};
+        level.priceTicks = r.read<int64_t>();
+        level.quantityLots = r.read<int64_t>();
+        level.timestampOfReceive = r.read<int64_t>();
+        level.market = r.read<Market>();
+        level.isLast = r.readBool();
+        return level;
+    }
 }
 
-void OrderBook::removeNode(DifferenceDepthEntry*& head, DifferenceDepthEntry*& tail, DifferenceDepthEntry* node) {
-    if (node->prev_) node->prev_->next_ = node->next_;
-    else head = node->next_;
+void OrderBook::saveState(Checkpoint::Writer& w) const {
+    w.write(symbol_);
+    w.write<uint64_t>(depthLimit_);
+    w.write<uint64_t>(topLevels_);
+
+    const int64_t tracked[] = {
+        prevBestAskPrice_, prevBestBidPrice_, prevBestAskQuantity_, prevBestBidQuantity_,
+        prevSumAskQuantity_, prevSumBidQuantity_,
+        deltaBestAskPrice_, deltaBestBidPrice_, deltaBestAskQuantity_, deltaBestBidQuantity_,
+        deltaSumAskQuantity_, deltaSumBidQuantity_
+    };
+    w.write(tracked);
+    const uint64_t counts[] = {prevAskCount_, prevBidCount_, deltaAskCount_, deltaBidCount_};
+    w.write(counts);
+
+    // per side: tracked levels best-first, then overflow levels sorted best-first
+    std::vector<SavedLevel> levels;
+    std::vector<std::pair<int64_t, DepthOverflow::Level>> overflowLevels;
+    for (const bool isAsk : {true, false}) {
+        levels.clear();
+        for (auto *node = isAsk ? askHead_ : bidHead_; node; node = node->next_) {
+            levels.push_back({node->priceTicks, node->quantityLots, node->timestampOfReceive, node->market, node->isLast});
+        }
+        overflowLevels.clear();
+        (isAsk ? askOverflow_ : bidOverflow_).forEach([&](const int64_t key, const DepthOverflow::Level& level) {
+            overflowLevels.emplace_back(key, level);
+        });
+        std::ranges::sort(overflowLevels, {}, &std::pair<int64_t, DepthOverflow::Level>::first);
+        for (const auto& [key, level] : overflowLevels) {
+            levels.push_back({isAsk ? key : -key, level.quantityLots, level.timestampOfReceive, level.market, false});
+        }
+        saveLevels(w, levels);
+    }
+}
 
-    if (node->next_) node->next_->prev_ = node->prev_;
-    else tail = node->prev_;
+void OrderBook::loadState(Checkpoint::Reader& r) {
+    clear();
+    adoptSymbol(r.read<Symbol>());
+    depthLimit_ = r.read<uint64_t>();
+    topLevels_ = std::max<size_t>(r.read<uint64_t>(), 1);
+    for (TopLevelCache* cache : {&askTop_, &bidTop_}) {
+        cache->priceTicks.assign(topLevels_, 0);
+        cache->cumulativeLots.assign(topLevels_, 0);
+        cache->dirty = true;
+    }
 
-    node->prev_ = node->next_ = nullptr;
+    const auto tracked = r.read<std::array<int64_t, 12>>();
+    const auto counts = r.read<std::array<uint64_t, 4>>();
+
+    for (const bool isAsk : {true, false}) {
+        const auto count = r.read<uint64_t>();
+        for (uint64_t i = 0; i < count; ++i) {
+            const SavedLevel level = loadLevel(r);
+            const DifferenceDepthEntry e(level.timestampOfReceive, symbol_, isAsk, level.priceTicks, level.quantityLots, level.isLast, level.market);
+            appendSnapshotLevel(&e, ladderKey(level.priceTicks, isAsk));
+        }
+    }
+
+    prevBestAskPrice_ = tracked[0];
+    prevBestBidPrice_ = tracked[1];
+    prevBestAskQuantity_ = tracked[2];
+    prevBestBidQuantity_ = tracked[3];
+    prevSumAskQuantity_ = tracked[4];
+    prevSumBidQuantity_ = tracked[5];
+    deltaBestAskPrice_ = tracked[6];
+    deltaBestBidPrice_ = tracked[7];
+    deltaBestAskQuantity_ = tracked[8];
+    deltaBestBidQuantity_ = tracked[9];
+    deltaSumAskQuantity_ = tracked[10];
+    deltaSumBidQuantity_ = tracked[11];
+    prevAskCount_ = counts[0];
+    prevBidCount_ = counts[1];
+    deltaAskCount_ = counts[2];
+    deltaBidCount_ = counts[3];
 }
 
-void OrderBook::update(DifferenceDepthEntry* e) {
-    PriceSide key{ e->price, e->isAsk };
-    auto it = index_.find(key);
+void OrderBook::computeDeltas() {
+    if (!bidHead_ || !askHead_) return;
+    deltaBidCount_ = bidCount_ - prevBidCount_;
+    deltaAskCount_ = askCount_ - prevAskCount_;
+    prevBidCount_ = bidCount_;
+    prevAskCount_ = askCount_;
+
+    deltaBestAskQuantity_ = askHead_->quantityLots - prevBestAskQuantity_;
+    deltaBestBidQuantity_ = bidHead_->quantityLots - prevBestBidQuantity_;
+    prevBestAskQuantity_ = askHead_->quantityLots;
+    prevBestBidQuantity_ = bidHead_->quantityLots;
+
+    deltaBestAskPrice_ = askHead_->priceTicks - prevBestAskPrice_;
+    deltaBestBidPrice_ = bidHead_->priceTicks - prevBestBidPrice_;
+    prevBestAskPrice_ = askHead_->priceTicks;
+    prevBestBidPrice_ = bidHead_->priceTicks;
+
+    deltaSumAskQuantity_ = sumAskQuantity_ - prevSumAskQuantity_;
+    deltaSumBidQuantity_ = sumBidQuantity_ - prevSumBidQuantity_;
+    prevSumAskQuantity_ = sumAskQuantity_;
+    prevSumBidQuantity_ = sumBidQuantity_;
+}
+
+void OrderBook::applyLevel(const DifferenceDepthEntry* e) {
+    const int64_t key = ladderKey(e->priceTicks, e->isAsk);
+    PriceLadder& ladder = e->isAsk ? askLadder_ : bidLadder_;
+    auto *node = ladder.find(key);
 
-    if (e->quantity == 0.0) {
-        if (it != index_.end()) {
-            auto *node = it->second;
+    touchTopLevels(e->isAsk ? askTop_ : bidTop_, key);
+
+    if (!node && depthLimit_ && applyOverflowLevel(e, key)) return;
+
+    if (e->quantityLots == 0) {
+        if (node) {
+            ladder.erase(key);
             if (node->isAsk) {
                 --askCount_;
-                sumAskQuantity_ -= node->quantity;
-                askMap_.erase(node->price);
+                sumAskQuantity_ -= node->quantityLots;
+                const bool wasBest = node == askHead_;
                 removeNode(askHead_, askTail_, node);
+                if (wasBest && askHead_) ladder.recentreIfDrifted(ladderKey(askHead_->priceTicks, true));
             } else {
                 --bidCount_;
-                sumBidQuantity_ -= node->quantity;
-                bidMap_.erase(node->price);
+                sumBidQuantity_ -= node->quantityLots;
+                const bool wasBest = node == bidHead_;
                 removeNode(bidHead_, bidTail_, node);
+                if (wasBest && bidHead_) ladder.recentreIfDrifted(ladderKey(bidHead_->priceTicks, false));
+            }
+            sumOfPriceTimesQuantity_.subtract(node->priceTicks, node->quantityLots);
+            arena.deallocate(node);
+
+            if (depthLimit_) {
+                DepthOverflow& overflow = e->isAsk ? askOverflow_ : bidOverflow_;
+                if (!overflow.empty()) promoteBestOverflowLevel(e->isAsk);
             }
-            sumOfPriceTimesQuantity_  -= node->price * node->quantity;
-            index_.erase(it);
-            deallocateNode(node);
         }
     }
     else {
-        if (it != index_.end()) {
-            auto *node = it->second;
-
-            double oldQ = node->quantity;
-            double newQ = e->quantity;
+        if (node) {
+            const int64_t oldQ = node->quantityLots;
+            const int64_t newQ = e->quantityLots;
 
             if (node->isAsk) sumAskQuantity_ += newQ - oldQ;
             else sumBidQuantity_ += newQ - oldQ;
 
-            sumOfPriceTimesQuantity_ += node->price * (newQ - oldQ);
+            sumOfPriceTimesQuantity_.subtract(node->priceTicks, oldQ);
+            sumOfPriceTimesQuantity_.add(node->priceTicks, newQ);
 
             node->timestampOfReceive = e->timestampOfReceive;
-            node->quantity = e->quantity;
+            node->quantityLots = e->quantityLots;
             node->isLast = e->isLast;
         }
         else {
-            auto *node = allocateNode(e->price, e->isAsk, e->quantity);
+            node = allocateNode(e->priceTicks, e->isAsk, e->quantityLots);
 
             DifferenceDepthEntry temp = *e;
             *node = std::move(temp);
 
-            node->prev_ = nullptr;
-            node->next_ = nullptr;
+            DifferenceDepthEntry* next = ladder.insert(key, node);
 
             if (node->isAsk) {
                 ++askCount_;
-                sumAskQuantity_ += node->quantity;
-
-                auto [mapIt, inserted] = askMap_.insert({node->price, node});
-
-                if (askMap_.size() == 1) {
-                    askHead_ = askTail_ = node;
-                } else {
-                    auto it = mapIt;
-
-                    if (it != askMap_.begin()) {
-                        auto prevIt = std::prev(it);
-                        DifferenceDepthEntry* prevNode = prevIt->second;
-
-                        node->prev_ = prevNode;
-                        node->next_ = prevNode->next_;
-
-                        if (prevNode->next_) prevNode->next_->prev_ = node;
-                        else askTail_ = node;
-
-                        prevNode->next_ = node;
-                    } else {
-                        node->next_ = askHead_;
-                        askHead_->prev_ = node;
-                        node->prev_ = nullptr;
-                        askHead_ = node;
-                    }
-                }
+                sumAskQuantity_ += node->quantityLots;
+                insertNodeBefore(askHead_, askTail_, node, next);
             }
             else {
                 ++bidCount_;
-                sumBidQuantity_ += node->quantity;
-
-                auto [mapIt, inserted] = bidMap_.insert({node->price, node});
-
-                if (bidMap_.size() == 1) {
-                    bidHead_ = bidTail_ = node;
-                }
-                else {
-                    auto it = mapIt;
-
-                    if (it != bidMap_.begin()) {
-                        auto prevIt = std::prev(it);
-                        DifferenceDepthEntry* prevNode = prevIt->second;
-
-                        node->prev_ = prevNode;
-                        node->next_ = prevNode->next_;
-
-                        if (prevNode->next_) prevNode->next_->prev_ = node;
-                        else bidTail_ = node;
-
-                        prevNode->next_ = node;
-                    }
-                    else {
-                        node->next_ = bidHead_;
-                        bidHead_->prev_ = node;
-                        node->prev_ = nullptr;
-                        bidHead_ = node;
-                    }
-                }
+                sumBidQuantity_ += node->quantityLots;
+                insertNodeBefore(bidHead_, bidTail_, node, next);
             }
 
-            sumOfPriceTimesQuantity_ += node->price * node->quantity;
-            index_[key] = node;
+            sumOfPriceTimesQuantity_.add(node->priceTicks, node->quantityLots);
         }
     }
+}
 
-    if (e->isLast){
-        if (!bidHead_ || !askHead_) return;
-        deltaBidCount_ = bidCount_ - prevBidCount_;
-        deltaAskCount_ = askCount_ - prevAskCount_;
-        prevBidCount_ = bidCount_;
-        prevAskCount_ = askCount_;
-
-        deltaBestAskQuantity_ = askHead_->quantity - prevBestAskQuantity_;
-        deltaBestBidQuantity_ = bidHead_->quantity - prevBestBidQuantity_;
-        prevBestAskQuantity_ = askHead_->quantity;
-        prevBestBidQuantity_ = bidHead_->quantity;
-
-        deltaBestAskPrice_ = askHead_->price - prevBestAskPrice_;
-        deltaBestBidPrice_ = bidHead_->price - prevBestBidPrice_;
-        prevBestAskPrice_ = askHead_->price;
-        prevBestBidPrice_ = bidHead_->price;
-
-        deltaSumAskQuantity_ = sumAskQuantity_ - prevSumAskQuantity_;
-        deltaSumBidQuantity_ = sumBidQuantity_ - prevSumBidQuantity_;
-        prevSumAskQuantity_ = sumAskQuantity_;
-        prevSumBidQuantity_ = sumBidQuantity_;
+bool OrderBook::applyOverflowLevel(const DifferenceDepthEntry* e, const int64_t key) {
+    DepthOverflow& overflow = e->isAsk ? askOverflow_ : bidOverflow_;
+    int64_t& sumQuantity = e->isAsk ? sumAskQuantity_ : sumBidQuantity_;
+    size_t& count = e->isAsk ? askCount_ : bidCount_;
+
+    if (auto *level = overflow.find(key)) {
+        sumQuantity += e->quantityLots - level->quantityLots;
+        sumOfPriceTimesQuantity_.subtract(e->priceTicks, level->quantityLots);
+        sumOfPriceTimesQuantity_.add(e->priceTicks, e->quantityLots);
+        if (e->quantityLots == 0) {
+            overflow.erase(key);
+            --count;
+        } else {
+            level->quantityLots = e->quantityLots;
+            level->timestampOfReceive = e->timestampOfReceive;
+        }
+        return true;
+    }
+
+    if (e->quantityLots == 0 || count - overflow.size() < depthLimit_) return false;
+
+    DifferenceDepthEntry* tail = e->isAsk ? askTail_ : bidTail_;
+    const int64_t tailKey = ladderKey(tail->priceTicks, e->isAsk);
+    if (key < tailKey) {
+        // the new level displaces the current worst tracked level
+        (e->isAsk ? askLadder_ : bidLadder_).erase(tailKey);
+        if (e->isAsk) removeNode(askHead_, askTail_, tail);
+        else removeNode(bidHead_, bidTail_, tail);
+        overflow.insert(tailKey, {tail->quantityLots, tail->timestampOfReceive, tail->market});
+        arena.deallocate(tail);
+        return false;
     }
+
+    overflow.insert(key, {e->quantityLots, e->timestampOfReceive, e->market});
+    ++count;
+    sumQuantity += e->quantityLots;
+    sumOfPriceTimesQuantity_.add(e->priceTicks, e->quantityLots);
+    return true;
+}
+
+void OrderBook::promoteBestOverflowLevel(const bool isAsk) {
+    const auto [key, level] = (isAsk ? askOverflow_ : bidOverflow_).popBest();
+    auto *node = allocateNode(isAsk ? key : -key, isAsk, level.quantityLots);
+    node->timestampOfReceive = level.timestampOfReceive;
+    node->symbol = symbol_;
+    node->market = level.market;
+    node->isLast = false;
+
+    DifferenceDepthEntry* next = (isAsk ? askLadder_ : bidLadder_).insert(key, node);
+    if (isAsk) insertNodeBefore(askHead_, askTail_, node, next);
+    else insertNodeBefore(bidHead_, bidTail_, node, next);
 }
 
 void OrderBook::printOrderBook() const {
@@ -255,8 +452,8 @@ void OrderBook::printOrderBook() const {
         << n->timestampOfReceive << " "
         << n->symbol << " "
         << n->isAsk << " "
-        << n->price << " "
-        << n->quantity << " "
+        << toPrice(n->priceTicks) << " "
+        << toQuantity(n->quantityLots) << " "
         << n->market << " "
         << "\n";
     }
@@ -267,8 +464,8 @@ void OrderBook::printOrderBook() const {
         << n->timestampOfReceive << " "
         << n->symbol << " "
         << n->isAsk << " "
-        << n->price << " "
-        << n->quantity << " "
+        << toPrice(n->priceTicks) << " "
+        << toQuantity(n->quantityLots) << " "
         << n->market << " "
         << "\n";
     }
@@ -293,34 +490,63 @@ std::vector<DifferenceDepthEntry> OrderBook::getBids() const {
     return result;
 }
 
-double OrderBook::cumulativeQuantityOfTopNAsks(size_t n) const {
-    double sum = 0;
-    auto *node = askHead_;
-    for (size_t i = 0; i < n && node; ++i, node = node->next_) {
-        sum += node->quantity;
+auto OrderBook::topLevels(TopLevelCache& cache, const DifferenceDepthEntry* head, const bool isAsk) const
+    -> const TopLevelCache&
+{
+    if (cache.dirty) {
+        int64_t sum = 0;
+        size_t i = 0;
+        for (auto *node = head; node && i < topLevels_; ++i, node = node->next_) {
+            sum += node->quantityLots;
+            cache.priceTicks[i] = node->priceTicks;
+            cache.cumulativeLots[i] = sum;
+        }
+        cache.size = i;
+        cache.worstKey = i ? ladderKey(cache.priceTicks[i - 1], isAsk) : 0;
+        cache.dirty = false;
     }
-    return sum;
+    return cache;
 }
 
-double OrderBook::cumulativeQuantityOfTopNBids(size_t n) const {
-    double sum = 0;
-    auto *node = bidHead_;
-    for (size_t i = 0; i < n && node; ++i, node = node->next_) {
-        sum += node->quantity;
+double OrderBook::cumulativeQuantityOfTopN(TopLevelCache& cache, const DifferenceDepthEntry* head, const bool isAsk, const size_t n) const {
+    if (n == 0) return 0.0;
+    const TopLevelCache& top = topLevels(cache, head, isAsk);
+    if (n <= top.size) return toQuantity(top.cumulativeLots[n - 1]);
+    if (top.size < topLevels_) return toQuantity(top.size ? top.cumulativeLots[top.size - 1] : 0);
+
+    int64_t sum = top.cumulativeLots[top.size - 1];
+    auto *node = head;
+    for (size_t i = 0; i < top.size; ++i) node = node->next_;
+    for (size_t i = top.size; i < n && node; ++i, node = node->next_) {
+        sum += node->quantityLots;
     }
-    return sum;
+    return toQuantity(sum);
 }
 
-double OrderBook::bestNthAskPrice(const size_t K) const {
-    const DifferenceDepthEntry* node = askHead_;
-    for (size_t i = 1; i < K && node; ++i)
+double OrderBook::bestNthPrice(TopLevelCache& cache, const DifferenceDepthEntry* head, const bool isAsk, const size_t K) const {
+    const size_t idx = K ? K - 1 : 0;
+    const TopLevelCache& top = topLevels(cache, head, isAsk);
+    if (idx < top.size) return toPrice(top.priceTicks[idx]);
+    if (top.size < topLevels_) return std::numeric_limits<double>::quiet_NaN();
+
+    const DifferenceDepthEntry* node = head;
+    for (size_t i = 0; i < idx && node; ++i)
         node = node->next_;
-    return node ? node->price : std::numeric_limits<double>::quiet_NaN();
+    return node ? toPrice(node->priceTicks) : std::numeric_limits<double>::quiet_NaN();
+}
+
+double OrderBook::cumulativeQuantityOfTopNAsks(const size_t n) const {
+    return cumulativeQuantityOfTopN(askTop_, askHead_, true, n);
+}
+
+double OrderBook::cumulativeQuantityOfTopNBids(const size_t n) const {
+    return cumulativeQuantityOfTopN(bidTop_, bidHead_, false, n);
+}
+
+double OrderBook::bestNthAskPrice(const size_t K) const {
+    return bestNthPrice(askTop_, askHead_, true, K);
 }
 
 double OrderBook::bestNthBidPrice(const size_t K) const {
-    const DifferenceDepthEntry* node = bidHead_;
-    for (size_t i = 1; i < K && node; ++i)
-        node = node->next_;
-    return node ? node->price : std::numeric_limits<double>::quiet_NaN();
+    return bestNthPrice(bidTop_, bidHead_, false, K);
 }
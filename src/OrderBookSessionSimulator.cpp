@@ -1,93 +1,239 @@
+#include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <limits>
 #include <pybind11/pybind11.h>
 
 #include "GlobalMarketState.h"
-#include "DataVectorLoader.h"
+#include "DaySequenceStream.h"
+#include "EntryStream.h"
+#include "EventArchive.h"
+#include "EventFile.h"
 #include "MarketState.h"
+#include "MergedEntryStream.h"
 #include "OrderBookMetrics.h"
+#include "OrderBookMetricsCalculator.h"
 #include "OrderbookSessionSimulator.h"
+#include "TimestampIndex.h"
 
 OrderBookSessionSimulator::OrderBookSessionSimulator() = default;
 
-size_t OrderBookSessionSimulator::countOrderBookMetricsSize(const std::vector<DecodedEntry>& entries){
-    return std::ranges::count_if(
-        entries,
-        [](const DecodedEntry& e) {
-            return std::visit([](auto const& x) { return x.isLast; }, e);
-        });
-}
+namespace {
+    // Streams the file chunk by chunk into the market state, handing every depth message
+    // (the run of rows of one symbol up to isLast) over as a single batch, also when the
+    // message straddles a chunk boundary. onLast gets each isLast row.
+    template <typename Source, typename OnLast>
+    void replayStream(GlobalMarketState& globalMarketState, Source& stream, OnLast&& onLast) {
+        std::vector<DecodedEntry> chunk;
+        std::vector<DifferenceDepthEntry> group;
+        group.reserve(1024);
+        const auto flush = [&] {
+            if (group.empty()) return;
+            globalMarketState.updateBatch(group);
+            group.clear();
+        };
+
+        while (stream.next(chunk)) {
+            for (DecodedEntry& entry : chunk) {
+                if (entry.isTrade()) {
+                    flush();
+                    globalMarketState.update(&entry);
+                } else {
+                    if (!group.empty()
+                        && (group.front().symbol != entry.symbol || group.front().market != entry.market || group.front().isSnapshot != entry.isSnapshot())) flush();
+                    group.push_back(entry.toDifferenceDepthEntry());
+                    if (!entry.isLast()) continue;
+                    flush();
+                }
+                if (entry.isLast()) onLast(&entry);
+            }
+        }
+        flush();
+    }
 
-py::dict OrderBookSessionSimulator::computeVariables(const std::string &csvPath, const std::vector<std::string> &variables) {
-    std::vector<DecodedEntry> entries = DataVectorLoader::getEntriesFromMultiAssetParametersCSV(csvPath);
-    std::vector<DecodedEntry*> ptrEntries;
-    ptrEntries.reserve(entries.size());
-    for (DecodedEntry &entry: entries) { ptrEntries.push_back(&entry);}
+    // Hands f an EventFile when the path holds one, otherwise a CSV EntryStream.
+    template <typename F>
+    void withEntrySource(const std::string& path, const bool singleAsset, F&& f) {
+        if (EventFile::isEventFile(path)) {
+            EventFile file(path);
+            f(file);
+        } else if (EventArchive::isEventArchive(path)) {
+            EventArchive archive(path);
+            f(archive);
+        } else {
+            EntryStream stream = singleAsset
+                ? EntryStream::openSingleAssetParametersCSV(path)
+                : EntryStream::openMultiAssetParametersCSV(path);
+            f(stream);
+        }
+    }
 
-    GlobalMarketState globalMarketState(variables);
-    OrderBookMetrics orderBookMetrics(variables, countOrderBookMetricsSize(entries));
+    // A single path is a merged CSV / EventFile / EventArchive, a list is raw
+    // single-stream CSVs merged on the fly.
+    template <typename F>
+    void withEntrySource(const std::vector<std::string>& paths, F&& f) {
+        MergedEntryStream stream = MergedEntryStream::openSingleAssetParametersCSVs(paths);
+        f(stream);
+    }
 
-    // const auto loopStart = std::chrono::steady_clock::now();
+    // Consecutive day files replayed as one session.
+    struct DaySequence {
+        const std::vector<std::string>& paths;
+    };
+
+    template <typename F>
+    void withEntrySource(const DaySequence& days, F&& f) {
+        DaySequenceStream stream(days.paths);
+        f(stream);
+    }
 
-    for (DecodedEntry* p : ptrEntries) {
-        globalMarketState.update(p);
-        if (std::visit([](auto const& entry){return entry.isLast;}, *p)) {
-            if (std::optional<OrderBookMetricsEntry> e = globalMarketState.countMarketStateMetricsByEntry(p)){
-                orderBookMetrics.addOrderBookMetricsEntry(*e);
+    template <typename F>
+    void withEntrySource(const std::string& path, F&& f) {
+        withEntrySource(path, false, std::forward<F>(f));
+    }
+
+    // Rows in [start, end) of one day file. Rows before start are replayed only to
+    // warm the books and rolling windows up and yield no metrics.
+    struct TimeSlice {
+        const std::string& path;
+        int64_t start;
+        int64_t end;
+    };
+
+    // Ends the wrapped source at its first row at or after end.
+    template <typename Source>
+    class UntilTimestamp {
+    public:
+        UntilTimestamp(Source& source, const int64_t end) : source_(source), end_(end) {}
+
+        bool next(std::vector<DecodedEntry>& chunk) {
+            if (done_ || !source_.next(chunk)) return false;
+            const auto stop = std::ranges::find_if(chunk, [this](const DecodedEntry& e) { return e.timestampOfReceive >= end_; });
+            if (stop != chunk.end()) {
+                chunk.erase(stop, chunk.end());
+                done_ = true;
             }
+            return true;
         }
+
+    private:
+        Source& source_;
+        int64_t end_;
+        bool done_{false};
+    };
+
+    // A merged CSV is decoded only over the byte range its TimestampIndex sidecar gives
+    // for the slice; EventFiles / EventArchives are read from the top and cut at end.
+    template <typename F>
+    void withEntrySource(const TimeSlice& slice, F&& f) {
+        if (EventFile::isEventFile(slice.path) || EventArchive::isEventArchive(slice.path)) {
+            withEntrySource(slice.path, [&](auto& source) {
+                UntilTimestamp bounded(source, slice.end);
+                f(bounded);
+            });
+            return;
+        }
+
+        constexpr int64_t longestWindowMicros = OrderBookMetricsCalculator::longestWindowMicros();
+        constexpr int64_t warmupMicros = std::max(RollingTradeStatistics::historyMicros(longestWindowMicros),
+                                                  RollingDifferenceDepthStatistics::historyMicros(longestWindowMicros));
+        const auto [begin, end] = TimestampIndex::loadOrBuild(slice.path).replayRange(slice.start, slice.end, warmupMicros);
+
+        EntryStream stream = EntryStream::openMultiAssetParametersCSV(slice.path);
+        stream.restrictToByteRange(begin, end);
+        UntilTimestamp bounded(stream, slice.end);
+        f(bounded);
     }
 
-    // const auto loopElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - loopStart).count();
-    // std::cout << "loop elapsed: " << loopElapsed << " ms" << std::endl;
+    template <typename Paths>
+    int64_t firstEmittedTimestamp(const Paths&) { return std::numeric_limits<int64_t>::min(); }
 
-    std::vector<DecodedEntry>().swap(entries);
-    std::vector<DecodedEntry*>().swap(ptrEntries);
+    int64_t firstEmittedTimestamp(const TimeSlice& slice) { return slice.start; }
 
-    // orderBookMetrics.toCSV("C:/Users/daniel/Documents/orderBookMetrics/sample.csv");
-    return orderBookMetrics.convertToNumpyArrays();
-}
+    template <typename Paths>
+    py::dict computeVariablesFrom(const Paths& paths, const std::vector<std::string> &variables) {
+        GlobalMarketState globalMarketState(variables);
+        OrderBookMetrics orderBookMetrics(variables);
+        const int64_t emitFrom = firstEmittedTimestamp(paths);
+        // reused for every row: only the selected fields are ever written, the rest stay zero
+        OrderBookMetricsEntry row{};
 
-py::dict OrderBookSessionSimulator::computeBacktest(const std::string& csvPath, std::vector<std::string> &variables, const pybind11::object &python_callback) {
+        // const auto loopStart = std::chrono::steady_clock::now();
 
-    std::vector<DecodedEntry> entries = DataVectorLoader::getEntriesFromMultiAssetParametersCSV(csvPath);
-    std::vector<DecodedEntry*> ptrEntries;
+        withEntrySource(paths, [&](auto& source) {
+            replayStream(globalMarketState, source, [&](DecodedEntry* p) {
+                if (p->timestampOfReceive < emitFrom) return;
+                if (globalMarketState.countMarketStateMetricsByEntry(p, row)){
+                    orderBookMetrics.addOrderBookMetricsEntry(row);
+                }
+            });
+        });
 
-    ptrEntries.reserve(entries.size());
-    for (auto &entry : entries) { ptrEntries.push_back(&entry); }
-    const size_t orderBookMetricsEntrySize = countOrderBookMetricsSize(entries);
+        // const auto loopElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - loopStart).count();
+        // std::cout << "loop elapsed: " << loopElapsed << " ms" << std::endl;
 
-    GlobalMarketState globalMarketState(variables);
-    OrderBookMetrics orderBookMetrics(variables, orderBookMetricsEntrySize);
+        // orderBookMetrics.toCSV("C:/Users/daniel/Documents/orderBookMetrics/sample.csv");
+        return orderBookMetrics.convertToNumpyArrays();
+    }
 
-    for (auto* p : ptrEntries) {
-        globalMarketState.update(p);
+    template <typename Paths>
+    py::dict computeBacktestFrom(const Paths& paths, const std::vector<std::string> &variables, const py::object &python_callback) {
+        GlobalMarketState globalMarketState(variables);
+        OrderBookMetrics orderBookMetrics(variables);
+        OrderBookMetricsEntry row{};
+
+        withEntrySource(paths, [&](auto& source) {
+            replayStream(globalMarketState, source, [&](DecodedEntry* p) {
+                if (globalMarketState.countMarketStateMetricsByEntry(p, row)) {
+                    orderBookMetrics.addOrderBookMetricsEntry(row);
+                    python_callback(row);
+                }
+            });
+        });
 
-        if (std::visit([](auto const& entry){return entry.isLast;}, *p)) {
-            if (std::optional<OrderBookMetricsEntry> e = globalMarketState.countMarketStateMetricsByEntry(p)) {
-                orderBookMetrics.addOrderBookMetricsEntry(*e);
-                python_callback(*e );
-            }
-        }
+        return orderBookMetrics.convertToNumpyArrays();
     }
+}
 
-    std::vector<DecodedEntry>().swap(entries);
-    std::vector<DecodedEntry*>().swap(ptrEntries);
+py::dict OrderBookSessionSimulator::computeVariables(const std::string &csvPath, const std::vector<std::string> &variables,
+                                                     const std::optional<int64_t> startTimestampOfReceive, const std::optional<int64_t> endTimestampOfReceive) {
+    if (!startTimestampOfReceive && !endTimestampOfReceive) return computeVariablesFrom(csvPath, variables);
+    return computeVariablesFrom(TimeSlice{csvPath,
+                                          startTimestampOfReceive.value_or(std::numeric_limits<int64_t>::min()),
+                                          endTimestampOfReceive.value_or(std::numeric_limits<int64_t>::max())}, variables);
+}
 
-    return orderBookMetrics.convertToNumpyArrays();
+py::dict OrderBookSessionSimulator::computeVariables(const std::vector<std::string> &csvPaths, const std::vector<std::string> &variables) {
+    return computeVariablesFrom(csvPaths, variables);
 }
 
-OrderBook OrderBookSessionSimulator::computeFinalDepthSnapshot(const std::string &csvPath) {
-    try {
-        std::vector<DecodedEntry> entries = DataVectorLoader::getEntriesFromSingleAssetParametersCSV(csvPath);
-        std::vector<DecodedEntry*> ptrEntries;
-        ptrEntries.reserve(entries.size());
+py::dict OrderBookSessionSimulator::computeVariablesOverDays(const std::vector<std::string> &dayPaths, const std::vector<std::string> &variables) {
+    return computeVariablesFrom(DaySequence{dayPaths}, variables);
+}
 
-        for (auto &entry : entries) { ptrEntries.push_back(&entry); }
+py::dict OrderBookSessionSimulator::computeBacktest(const std::string& csvPath, std::vector<std::string> &variables, const pybind11::object &python_callback) {
+    return computeBacktestFrom(csvPath, variables, python_callback);
+}
+
+py::dict OrderBookSessionSimulator::computeBacktest(const std::vector<std::string>& csvPaths, std::vector<std::string> &variables, const pybind11::object &python_callback) {
+    return computeBacktestFrom(csvPaths, variables, python_callback);
+}
+
+py::dict OrderBookSessionSimulator::computeBacktestOverDays(const std::vector<std::string>& dayPaths, std::vector<std::string> &variables, const pybind11::object &python_callback) {
+    return computeBacktestFrom(DaySequence{dayPaths}, variables, python_callback);
+}
 
+OrderBook OrderBookSessionSimulator::computeFinalDepthSnapshot(const std::string &csvPath) {
+    try {
         MarketState marketState;
 
-        for (auto* entryPtr: ptrEntries) { marketState.update(entryPtr); }
+        withEntrySource(csvPath, true, [&](auto& source) {
+            std::vector<DecodedEntry> chunk;
+            while (source.next(chunk)) {
+                for (DecodedEntry& entry : chunk) { marketState.update(&entry); }
+            }
+        });
+        marketState.flushPendingSnapshot();
 
         return std::move(marketState.orderBook);
 
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <bit>
+
+#include "PriceLadder.h"
+
+PriceLadder::PriceLadder(const size_t capacity)
+    : capacity_(std::max<size_t>((capacity + 4095) & ~size_t{4095}, 4096))
+    , slots_(capacity_, nullptr)
+    , words_(capacity_ / 64, 0)
+    , summary_(capacity_ / 4096, 0)
+{}
+
+void PriceLadder::setBit(const size_t idx) {
+    const size_t w = idx >> 6;
+    words_[w] |= uint64_t{1} << (idx & 63);
+    summary_[w >> 6] |= uint64_t{1} << (w & 63);
+}
+
+void PriceLadder::clearBit(const size_t idx) {
+    const size_t w = idx >> 6;
+    words_[w] &= ~(uint64_t{1} << (idx & 63));
+    if (!words_[w]) summary_[w >> 6] &= ~(uint64_t{1} << (w & 63));
+}
+
+size_t PriceLadder::nextSetAfter(const size_t idx) const {
+    size_t w = idx >> 6;
+    const size_t b = idx & 63;
+    if (b != 63) {
+        const uint64_t rest = words_[w] & (~uint64_t{0} << (b + 1));
+        if (rest) return (w << 6) + std::countr_zero(rest);
+    }
+    ++w;
+    size_t s = w >> 6;
+    if (s >= summary_.size()) return capacity_;
+    uint64_t sw = summary_[s] & (~uint64_t{0} << (w & 63));
+    while (!sw) {
+        if (++s == summary_.size()) return capacity_;
+        sw = summary_[s];
+    }
+    const size_t word = (s << 6) + std::countr_zero(sw);
+    return (word << 6) + std::countr_zero(words_[word]);
+}
+
+DifferenceDepthEntry* PriceLadder::find(const int64_t key) const {
+    const auto idx = static_cast<uint64_t>(key - anchor_);
+    if (idx < capacity_) {
+        return (words_[idx >> 6] >> (idx & 63) & 1) ? slots_[idx] : nullptr;
+    }
+    const auto it = far_.find(key);
+    return it == far_.end() ? nullptr : it->second;
+}
+
+void PriceLadder::place(const int64_t key, DifferenceDepthEntry* node) {
+    const auto idx = static_cast<uint64_t>(key - anchor_);
+    if (idx < capacity_) {
+        slots_[idx] = node;
+        setBit(idx);
+        ++windowCount_;
+    } else {
+        far_.emplace(key, node);
+    }
+}
+
+DifferenceDepthEntry* PriceLadder::insert(const int64_t key, DifferenceDepthEntry* node) {
+    if (windowCount_ == 0 && far_.empty()) {
+        anchor_ = key - static_cast<int64_t>(capacity_ / 4);
+    } else if (key < anchor_) {
+        recentre(key);
+    }
+
+    const auto idx = static_cast<uint64_t>(key - anchor_);
+    if (idx < capacity_) {
+        slots_[idx] = node;
+        setBit(idx);
+        ++windowCount_;
+        const size_t next = nextSetAfter(idx);
+        if (next < capacity_) return slots_[next];
+        return far_.empty() ? nullptr : far_.begin()->second;
+    }
+
+    const auto it = far_.emplace(key, node).first;
+    const auto nextIt = std::next(it);
+    return nextIt == far_.end() ? nullptr : nextIt->second;
+}
+
+void PriceLadder::append(const int64_t key, DifferenceDepthEntry* node) {
+    if (windowCount_ == 0 && far_.empty()) {
+        anchor_ = key - static_cast<int64_t>(capacity_ / 4);
+    }
+    place(key, node);
+}
+
+void PriceLadder::erase(const int64_t key) {
+    const auto idx = static_cast<uint64_t>(key - anchor_);
+    if (idx < capacity_) {
+        clearBit(idx);
+        --windowCount_;
+    } else {
+        far_.erase(key);
+    }
+}
+
+void PriceLadder::recentreIfDrifted(const int64_t bestKey) {
+    if (bestKey - anchor_ >= static_cast<int64_t>(capacity_ / 2)) {
+        recentre(bestKey);
+    }
+}
+
+void PriceLadder::recentre(const int64_t bestKey) {
+    scratch_.clear();
+    for (size_t w = 0; w < words_.size(); ++w) {
+        uint64_t bits = words_[w];
+        while (bits) {
+            const size_t idx = (w << 6) + std::countr_zero(bits);
+            scratch_.emplace_back(anchor_ + static_cast<int64_t>(idx), slots_[idx]);
+            bits &= bits - 1;
+        }
+    }
+    std::ranges::fill(words_, 0);
+    std::ranges::fill(summary_, 0);
+    windowCount_ = 0;
+
+    anchor_ = bestKey - static_cast<int64_t>(capacity_ / 4);
+    const int64_t windowEnd = anchor_ + static_cast<int64_t>(capacity_);
+
+    while (!far_.empty() && far_.begin()->first < windowEnd) {
+        place(far_.begin()->first, far_.begin()->second);
+        far_.erase(far_.begin());
+    }
+    for (const auto& [key, node] : scratch_) {
+        place(key, node);
+    }
+}
+
+void PriceLadder::clear() {
+    std::ranges::fill(words_, 0);
+    std::ranges::fill(summary_, 0);
+    far_.clear();
+    windowCount_ = 0;
+}
@@ -1,65 +1,60 @@
 #include "RollingDifferenceDepthStatistics.h"
-#include <algorithm>
-#include <limits>
+#include <stdexcept>
 
-void RollingDifferenceDepthStatistics::Bucket::resetDepthBucket() {
-    bidDifferenceDepthEntryCount = 0;
-    askDifferenceDepthEntryCount = 0;
-    hasDifferenceDepthData       = false;
+void RollingDifferenceDepthStatistics::update(const DifferenceDepthEntry& entry) {
+    const int64_t ts = entry.timestampOfReceive;
+    window_.advanceTo(ts);
+    window_.record(ts, [&entry](Bucket& bucket) {
+        if (entry.isAsk) ++bucket.askDifferenceDepthEntryCount;
+        else             ++bucket.bidDifferenceDepthEntryCount;
+    });
 }
 
-size_t RollingDifferenceDepthStatistics::getBucketIndex(const int64_t timestamp) {
-    return (timestamp / BUCKET_SIZE_US) % MAX_BUCKETS;
+RollingDifferenceDepthStatistics::WindowCounts RollingDifferenceDepthStatistics::windowCounts(const int64_t windowMicros) const {
+    const auto [closed, current] = window_.parts(windowMicros);
+    if (!closed) return {};
+
+    WindowCounts counts = *closed;
+    if (current) {
+        counts.bidDifferenceDepthEntryCount += current->bidDifferenceDepthEntryCount;
+        counts.askDifferenceDepthEntryCount += current->askDifferenceDepthEntryCount;
+    }
+    return counts;
 }
 
-void RollingDifferenceDepthStatistics::advanceDepthToTimestamp(const int64_t timestamp) {
-    if (timestamp <= lastDepthTimestamp_) return;
-    const int64_t old_bucket_time = lastDepthTimestamp_ / BUCKET_SIZE_US;
-    const int64_t new_bucket_time = timestamp / BUCKET_SIZE_US;
-    const int64_t buckets_to_clear = std::min(new_bucket_time - old_bucket_time, static_cast<int64_t>(MAX_BUCKETS));
-    for (int64_t i = 1; i <= buckets_to_clear; ++i) {
-        const size_t idx = getBucketIndex((old_bucket_time + i) * BUCKET_SIZE_US);
-        buckets_[idx].start_time = (old_bucket_time + i) * BUCKET_SIZE_US;
-        buckets_[idx].resetDepthBucket();
+void RollingDifferenceDepthStatistics::windowSnapshot(const std::span<const int64_t> windowsMicros, const std::span<WindowCounts> out) const {
+    if (out.size() < windowsMicros.size()) {
+        throw std::runtime_error("RollingDifferenceDepthStatistics::windowSnapshot output is shorter than the window list");
+    }
+    for (size_t i = 0; i < windowsMicros.size(); ++i) {
+        out[i] = windowCounts(windowsMicros[i]);
     }
-    currentBucketIdx_ = getBucketIndex(timestamp);
-    lastDepthTimestamp_ = timestamp;
 }
 
-void RollingDifferenceDepthStatistics::update(const DifferenceDepthEntry& entry) {
-    const int64_t ts = entry.timestampOfReceive;
+size_t RollingDifferenceDepthStatistics::bidDifferenceDepthEntryCount(const int64_t windowMicros) const {
+    return windowCounts(windowMicros).bidDifferenceDepthEntryCount;
+}
 
-    advanceDepthToTimestamp(ts);
+size_t RollingDifferenceDepthStatistics::askDifferenceDepthEntryCount(const int64_t windowMicros) const {
+    return windowCounts(windowMicros).askDifferenceDepthEntryCount;
+}
 
-    const size_t idx = getBucketIndex(ts);
-    Bucket& bucket = buckets_[idx];
-    bucket.start_time = (ts / BUCKET_SIZE_US) * BUCKET_SIZE_US;
+void RollingDifferenceDepthStatistics::Bucket::saveState(Checkpoint::Writer& w) const {
+    w.write<uint64_t>(bidDifferenceDepthEntryCount);
+    w.write<uint64_t>(askDifferenceDepthEntryCount);
+    w.writeBool(hasData);
+}
 
-    bucket.hasDifferenceDepthData = true;
-    if (entry.isAsk) ++bucket.askDifferenceDepthEntryCount;
-    else         ++bucket.bidDifferenceDepthEntryCount;
+void RollingDifferenceDepthStatistics::Bucket::loadState(Checkpoint::Reader& r) {
+    bidDifferenceDepthEntryCount = r.read<uint64_t>();
+    askDifferenceDepthEntryCount = r.read<uint64_t>();
+    hasData = r.readBool();
 }
 
-size_t RollingDifferenceDepthStatistics::bidDifferenceDepthEntryCount(const int windowDurationSeconds) const {
-    if (lastDepthTimestamp_ == 0) return 0;
-    const int64_t cutoff = lastDepthTimestamp_ - static_cast<int64_t>(windowDurationSeconds) * BUCKET_SIZE_US;
-    size_t total = 0;
-    for (auto const& bucket : buckets_) {
-        if (bucket.hasDifferenceDepthData && bucket.start_time >= cutoff) {
-            total += bucket.bidDifferenceDepthEntryCount;
-        }
-    }
-    return total;
+void RollingDifferenceDepthStatistics::saveState(Checkpoint::Writer& w) const {
+    window_.saveState(w);
 }
 
-size_t RollingDifferenceDepthStatistics::askDifferenceDepthEntryCount(const int windowDurationSeconds) const {
-    if (lastDepthTimestamp_ == 0) return 0;
-    const int64_t cutoff = lastDepthTimestamp_ - static_cast<int64_t>(windowDurationSeconds) * BUCKET_SIZE_US;
-    size_t total = 0;
-    for (auto const& bucket : buckets_) {
-        if (bucket.hasDifferenceDepthData && bucket.start_time >= cutoff) {
-            total += bucket.askDifferenceDepthEntryCount;
-        }
-    }
-    return total;
+void RollingDifferenceDepthStatistics::loadState(Checkpoint::Reader& r) {
+    window_.loadState(r);
 }
@@ -1,216 +1,147 @@
 #include "RollingTradeStatistics.h"
 #include <algorithm>
-#include <limits>
-
-void RollingTradeStatistics::Bucket::resetTradeBucket() {
-    buyTradesCount              = 0;
-    sellTradesCount             = 0;
-    cumulatedBuyTradesQuantity  = 0.0;
-    cumulatedSellTradesQuantity = 0.0;
-    firstTradePrice             = 0.0;
-    lastTradePrice              = 0.0;
-    biggestBuyTrade             = 0.0;
-    biggestSellTrade            = 0.0;
-    hasTradeData                = false;
-}
-
-size_t RollingTradeStatistics::getBucketIndex(const int64_t timestamp) {
-    return (timestamp / BUCKET_SIZE_US) % MAX_BUCKETS;
-}
-
-void RollingTradeStatistics::advanceTradeToTimestamp(const int64_t timestamp) {
-    if (timestamp <= lastTradeTimestamp_) return;
-    const int64_t old_bucket_time = lastTradeTimestamp_ / BUCKET_SIZE_US;
-    const int64_t new_bucket_time = timestamp / BUCKET_SIZE_US;
-    const int64_t buckets_to_clear = std::min(new_bucket_time - old_bucket_time, static_cast<int64_t>(MAX_BUCKETS));
-    for (int64_t i = 1; i <= buckets_to_clear; ++i) {
-        const size_t idx = getBucketIndex((old_bucket_time + i) * BUCKET_SIZE_US);
-        buckets_[idx].start_time = (old_bucket_time + i) * BUCKET_SIZE_US;
-        buckets_[idx].resetTradeBucket();
+#include <stdexcept>
+#include <string>
+
+RollingTradeStatistics::RollingTradeStatistics() {
+    for (size_t i = 0; i < INDICATOR_CANDLE_SECONDS.size(); ++i) {
+        indicators_[i] = CandleIndicators(INDICATOR_CANDLE_SECONDS[i]);
     }
-    currentBucketIdx_ = getBucketIndex(timestamp);
-    lastTradeTimestamp_ = timestamp;
 }
 
 void RollingTradeStatistics::update(const TradeEntry& e) {
-    lastTradePrice_ = e.price;
-
     const int64_t ts = e.timestampOfReceive;
-    advanceTradeToTimestamp(ts);
-
-    const size_t idx = getBucketIndex(ts);
-    Bucket& bucket = buckets_[idx];
-    bucket.start_time = (ts / BUCKET_SIZE_US) * BUCKET_SIZE_US;
-
-    if (!bucket.hasTradeData) {
-        bucket.firstTradePrice = e.price;
-        bucket.hasTradeData = true;
-    }
-    bucket.lastTradePrice = e.price;
-    if (!e.isBuyerMarketMaker) {
-        ++bucket.buyTradesCount;
-        bucket.cumulatedBuyTradesQuantity += e.quantity;
-        bucket.biggestBuyTrade = std::max(bucket.biggestBuyTrade, e.quantity);
-    } else {
-        ++bucket.sellTradesCount;
-        bucket.cumulatedSellTradesQuantity += e.quantity;
-        bucket.biggestSellTrade = std::max(bucket.biggestSellTrade, e.quantity);
+    if (ts > window_.lastTimestamp()) {
+        for (CandleIndicators& indicators : indicators_) indicators.advanceTo(ts, lastTradePrice_);
     }
-}
-
-size_t RollingTradeStatistics::buyTradeCount(const int windowDurationSeconds) const {
-    if (lastTradeTimestamp_ == 0) return 0;
-
-    int64_t cutoff = lastTradeTimestamp_ - static_cast<int64_t>(windowDurationSeconds) * BUCKET_SIZE_US;
-    size_t total = 0;
+    window_.advanceTo(ts);
+    lastTradePrice_ = e.price;
 
-    for (const auto& bucket : buckets_) {
-        if (bucket.hasTradeData && bucket.start_time >= cutoff) {
-            total += bucket.buyTradesCount;
+    window_.record(ts, [&e](Bucket& bucket) {
+        bucket.lastTradePrice = e.price;
+        if (!e.isBuyerMarketMaker) {
+            ++bucket.buyTradesCount;
+            bucket.cumulatedBuyTradesQuantity += e.quantity;
+            bucket.biggestBuyTrade = std::max(bucket.biggestBuyTrade, e.quantity);
+        } else {
+            ++bucket.sellTradesCount;
+            bucket.cumulatedSellTradesQuantity += e.quantity;
+            bucket.biggestSellTrade = std::max(bucket.biggestSellTrade, e.quantity);
         }
-    }
-    return total;
+    });
 }
 
-size_t RollingTradeStatistics::sellTradeCount(const int windowDurationSeconds) const {
-    if (lastTradeTimestamp_ == 0) return 0;
-
-    int64_t cutoff = lastTradeTimestamp_ - static_cast<int64_t>(windowDurationSeconds) * BUCKET_SIZE_US;
-    size_t total = 0;
-
-    for (const auto& bucket : buckets_) {
-        if (bucket.hasTradeData && bucket.start_time >= cutoff) {
-            total += bucket.sellTradesCount;
-        }
+RollingTradeStatistics::WindowTotals RollingTradeStatistics::windowTotals(const int64_t windowMicros) const {
+    WindowTotals totals;
+    const auto [closed, current] = window_.parts(windowMicros);
+    if (!closed) return totals;
+
+    totals.buyTradeCount = closed->buyTradesCount;
+    totals.sellTradeCount = closed->sellTradesCount;
+    totals.buyTradeVolume = closed->cumulatedBuyTradesQuantity;
+    totals.sellTradeVolume = closed->cumulatedSellTradesQuantity;
+    if (current) {
+        totals.buyTradeCount += current->buyTradesCount;
+        totals.sellTradeCount += current->sellTradesCount;
+        totals.buyTradeVolume += current->cumulatedBuyTradesQuantity;
+        totals.sellTradeVolume += current->cumulatedSellTradesQuantity;
     }
-    return total;
+    return totals;
 }
 
-double RollingTradeStatistics::buyTradeVolume(const int windowDurationSeconds) const {
-    if (lastTradeTimestamp_ == 0) return 0.0;
-
-    int64_t cutoff = lastTradeTimestamp_ - static_cast<int64_t>(windowDurationSeconds) * BUCKET_SIZE_US;
-    double total = 0.0;
-
-    for (const auto& bucket : buckets_) {
-        if (bucket.hasTradeData && bucket.start_time >= cutoff) {
-            total += bucket.cumulatedBuyTradesQuantity;
-        }
+void RollingTradeStatistics::windowSnapshot(const std::span<const int64_t> windowsMicros, const std::span<WindowTotals> out) const {
+    if (out.size() < windowsMicros.size()) {
+        throw std::runtime_error("RollingTradeStatistics::windowSnapshot output is shorter than the window list");
     }
-    return total;
-}
-
-double RollingTradeStatistics::sellTradeVolume(const int windowDurationSeconds) const {
-    if (lastTradeTimestamp_ == 0) return 0.0;
-
-    int64_t cutoff = lastTradeTimestamp_ - static_cast<int64_t>(windowDurationSeconds) * BUCKET_SIZE_US;
-    double total = 0.0;
-
-    for (const auto& bucket : buckets_) {
-        if (bucket.hasTradeData && bucket.start_time >= cutoff) {
-            total += bucket.cumulatedSellTradesQuantity;
-        }
+    for (size_t i = 0; i < windowsMicros.size(); ++i) {
+        out[i] = windowTotals(windowsMicros[i]);
     }
-    return total;
 }
 
-double RollingTradeStatistics::priceDifference(const int windowDurationSeconds) const {
-    if (lastTradeTimestamp_ == 0) return 0.0;
-
-    const int64_t cutoff = lastTradeTimestamp_ - static_cast<int64_t>(windowDurationSeconds) * BUCKET_SIZE_US;
-
-    double price_at_cutoff = 0.0;
-    int64_t best_cutoff_time = std::numeric_limits<int64_t>::min();
-
-    double current_price = 0.0;
-    int64_t best_current_time = std::numeric_limits<int64_t>::min();
-
-    for (const auto& bucket : buckets_) {
-        if (!bucket.hasTradeData) continue;
-
-        if (bucket.start_time > best_current_time) {
-            best_current_time = bucket.start_time;
-            current_price = bucket.lastTradePrice;
-        }
-
-        if (bucket.start_time <= cutoff && bucket.start_time > best_cutoff_time) {
-            best_cutoff_time = bucket.start_time;
-            price_at_cutoff = bucket.lastTradePrice;
-        }
-    }
-
-    if (best_current_time == std::numeric_limits<int64_t>::min() ||
-        best_cutoff_time == std::numeric_limits<int64_t>::min()) {
-        return 0.0;
-        }
-
-    return current_price - price_at_cutoff;
+size_t RollingTradeStatistics::buyTradeCount(const int64_t windowMicros) const {
+    return windowTotals(windowMicros).buyTradeCount;
 }
 
-double RollingTradeStatistics::oldestPrice(const int windowTimeSeconds) const {
-    if (lastTradeTimestamp_ == 0) return 0.0;
-
-    const int64_t cutoff = lastTradeTimestamp_ - static_cast<int64_t>(windowTimeSeconds) * BUCKET_SIZE_US;
+size_t RollingTradeStatistics::sellTradeCount(const int64_t windowMicros) const {
+    return windowTotals(windowMicros).sellTradeCount;
+}
 
-    double priceAtCutoff     = 0.0;
-    int64_t bestCutoffBucket = std::numeric_limits<int64_t>::min();
+double RollingTradeStatistics::buyTradeVolume(const int64_t windowMicros) const {
+    return windowTotals(windowMicros).buyTradeVolume;
+}
 
-    for (auto const& bucket : buckets_) {
-        if (!bucket.hasTradeData) continue;
+double RollingTradeStatistics::sellTradeVolume(const int64_t windowMicros) const {
+    return windowTotals(windowMicros).sellTradeVolume;
+}
 
-        if (bucket.start_time <= cutoff &&
-            bucket.start_time > bestCutoffBucket) {
-            bestCutoffBucket = bucket.start_time;
-            priceAtCutoff    = bucket.lastTradePrice;
-            }
-    }
+double RollingTradeStatistics::priceDifference(const int64_t windowMicros) const {
+    // the price at the cutoff is the last price of the newest bucket starting at or before it
+    const Bucket* current = window_.newest(windowMicros, PRICE_LOOKBACK_MICROS);
+    const Bucket* atCutoff = window_.newestAtCutoff(windowMicros, PRICE_LOOKBACK_MICROS);
+    if (!current || !atCutoff) return 0.0;
 
-    return priceAtCutoff;
+    return current->lastTradePrice - atCutoff->lastTradePrice;
 }
 
-double RollingTradeStatistics::biggestBuyTradeNSeconds(const int windowSeconds) const {
-    if (lastTradeTimestamp_ == 0) return 0.0;
-
-    const int64_t cutoff = lastTradeTimestamp_ - static_cast<int64_t>(windowSeconds) * BUCKET_SIZE_US;
-    double biggest = 0.0;
+double RollingTradeStatistics::oldestPrice(const int64_t windowMicros) const {
+    const Bucket* atCutoff = window_.newestAtCutoff(windowMicros, PRICE_LOOKBACK_MICROS);
+    return atCutoff ? atCutoff->lastTradePrice : 0.0;
+}
 
-    for (auto const& bucket : buckets_) {
-        if (bucket.hasTradeData && bucket.start_time >= cutoff) {
-            biggest = std::max(biggest, bucket.biggestBuyTrade);
-        }
-    }
-    return biggest;
+double RollingTradeStatistics::biggestBuyTrade(const int64_t windowMicros) const {
+    const auto [closed, current] = window_.parts(windowMicros);
+    if (!closed) return 0.0;
+    return std::max(closed->biggestBuyTrade, current ? current->biggestBuyTrade : 0.0);
 }
 
-double RollingTradeStatistics::biggestSellTradeNSeconds(const int windowSeconds) const {
-    if (lastTradeTimestamp_ == 0) return 0.0;
+double RollingTradeStatistics::biggestSellTrade(const int64_t windowMicros) const {
+    const auto [closed, current] = window_.parts(windowMicros);
+    if (!closed) return 0.0;
+    return std::max(closed->biggestSellTrade, current ? current->biggestSellTrade : 0.0);
+}
 
-    const int64_t cutoff = lastTradeTimestamp_ - static_cast<int64_t>(windowSeconds) * BUCKET_SIZE_US;
-    double biggest = 0.0;
+double RollingTradeStatistics::simpleMovingAverage(const int64_t windowMicros) const {
+    const BucketTotals totals = window_.totals(windowMicros);
+    return totals.tradeBucketsCount > 0 ? totals.lastTradePriceSum / static_cast<double>(totals.tradeBucketsCount) : 0.0;
+}
 
-    for (auto const& bucket : buckets_) {
-        if (bucket.hasTradeData && bucket.start_time >= cutoff) {
-            biggest = std::max(biggest, bucket.biggestSellTrade);
-        }
+const CandleIndicators& RollingTradeStatistics::indicators(const int candleSeconds) const {
+    for (const CandleIndicators& indicators : indicators_) {
+        if (indicators.candleSeconds() == candleSeconds) return indicators;
     }
-    return biggest;
+    throw std::runtime_error("No indicator state for " + std::to_string(candleSeconds) + " s candles");
 }
 
-double RollingTradeStatistics::simpleMovingAverage(const int windowTimeSeconds) const {
-    if (lastTradeTimestamp_ == 0)
-        return 0.0;
-
-    const int64_t cutoff = lastTradeTimestamp_ - static_cast<int64_t>(windowTimeSeconds) * BUCKET_SIZE_US;
+void RollingTradeStatistics::Bucket::saveState(Checkpoint::Writer& w) const {
+    w.write<uint64_t>(buyTradesCount);
+    w.write<uint64_t>(sellTradesCount);
+    w.write(cumulatedBuyTradesQuantity);
+    w.write(cumulatedSellTradesQuantity);
+    w.write(lastTradePrice);
+    w.write(biggestBuyTrade);
+    w.write(biggestSellTrade);
+    w.writeBool(hasData);
+}
 
-    double sum = 0.0;
-    size_t count = 0;
+void RollingTradeStatistics::Bucket::loadState(Checkpoint::Reader& r) {
+    buyTradesCount = r.read<uint64_t>();
+    sellTradesCount = r.read<uint64_t>();
+    cumulatedBuyTradesQuantity = r.read<double>();
+    cumulatedSellTradesQuantity = r.read<double>();
+    lastTradePrice = r.read<double>();
+    biggestBuyTrade = r.read<double>();
+    biggestSellTrade = r.read<double>();
+    hasData = r.readBool();
+}
 
-    for (auto const& bucket : buckets_) {
-        if (bucket.hasTradeData && bucket.start_time >= cutoff) {
-            sum += bucket.lastTradePrice;
-            ++count;
-        }
-    }
+void RollingTradeStatistics::saveState(Checkpoint::Writer& w) const {
+    window_.saveState(w);
+    w.write(lastTradePrice_);
+    for (const CandleIndicators& indicators : indicators_) indicators.saveState(w);
+}
 
-    return (count > 0) ? (sum / static_cast<double>(count)) : 0.0;
+void RollingTradeStatistics::loadState(Checkpoint::Reader& r) {
+    window_.loadState(r);
+    lastTradePrice_ = r.read<double>();
+    for (CandleIndicators& indicators : indicators_) indicators.loadState(r);
 }
@@ -34,73 +34,76 @@ inline double finiteAtanh(double x) {
 
 namespace SingleVariableCounter {
 
-    double calculateBestAskPrice(const OrderBook& orderBook) {
+    double calculateBestAskPrice(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         return orderBook.bestAskPrice();
     }
 
-    double calculateBestBidPrice(const OrderBook& orderBook) {
+    double calculateBestBidPrice(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         return orderBook.bestBidPrice();
     }
 
-    double calculateMidPrice(const OrderBook& orderBook) {
-        return (orderBook.bestBidPrice() + orderBook.bestAskPrice()) * 0.5;
+    double calculateMidPrice(SnapshotContext& context) {
+        return context.midPrice();
     }
 
-    double calculateMicroPriceDiff(const OrderBook& orderBook){
-        const double microPrice =
-            (orderBook.bestAskPrice() * orderBook.bestBidQuantity() + orderBook.bestBidPrice() * orderBook.bestAskQuantity()) / (orderBook.bestBidQuantity() + orderBook.bestAskQuantity());
-        const double midPrice = calculateMidPrice(orderBook);
+    double calculateMicroPriceDiff(SnapshotContext& context){
+        const double microPrice = context.microPrice();
+        const double midPrice = context.midPrice();
         return microPrice - midPrice;
     }
 
-    double calculateMicroPriceImbalance(const OrderBook& orderBook){
-        const double microPrice =
-            (orderBook.bestAskPrice() * orderBook.bestBidQuantity() + orderBook.bestBidPrice() * orderBook.bestAskQuantity()) / (orderBook.bestBidQuantity() + orderBook.bestAskQuantity());
-        const double midPrice = calculateMidPrice(orderBook);
+    double calculateMicroPriceImbalance(SnapshotContext& context){
+        const double microPrice = context.microPrice();
+        const double midPrice = context.midPrice();
         return (microPrice - midPrice) / (microPrice + midPrice);
     }
 
-    double calculateMicroPriceFisherImbalance(const OrderBook& orderBook){
-        return std::atanh(calculateMicroPriceImbalance(orderBook));
+    double calculateMicroPriceFisherImbalance(SnapshotContext& context){
+        return std::atanh(calculateMicroPriceImbalance(context));
     }
 
-    double calculateMicroPriceDeviation(const OrderBook& orderBook){
-        const double microPrice =
-            (orderBook.bestAskPrice() * orderBook.bestBidQuantity() + orderBook.bestBidPrice() * orderBook.bestAskQuantity()) / (orderBook.bestBidQuantity() + orderBook.bestAskQuantity());
-        const double midPrice = calculateMidPrice(orderBook);
+    double calculateMicroPriceDeviation(SnapshotContext& context){
+        const double microPrice = context.microPrice();
+        const double midPrice = context.midPrice();
         return (microPrice - midPrice) * 100 / midPrice;
     }
 
-    double calculateMicroPriceLogRatio(const OrderBook& orderBook){
-        const double microPrice =
-            (orderBook.bestAskPrice() * orderBook.bestBidQuantity() + orderBook.bestBidPrice() * orderBook.bestAskQuantity()) / (orderBook.bestBidQuantity() + orderBook.bestAskQuantity());
-        const double midPrice = calculateMidPrice(orderBook);
+    double calculateMicroPriceLogRatio(SnapshotContext& context){
+        const double microPrice = context.microPrice();
+        const double midPrice = context.midPrice();
         return std::log(microPrice / midPrice);
     }
 
-    double calculateBestBidQuantity(const OrderBook& orderBook){
+    double calculateBestBidQuantity(SnapshotContext& context){
+        const OrderBook& orderBook = context.orderBook();
         return orderBook.bestBidQuantity();
     }
 
-    double calculateBestAskQuantity(const OrderBook& orderBook){
+    double calculateBestAskQuantity(SnapshotContext& context){
+        const OrderBook& orderBook = context.orderBook();
         return orderBook.bestAskQuantity();
     }
 
-    double calculateBestOrderFlowDiff(const OrderBook& orderBook) {
+    double calculateBestOrderFlowDiff(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         return orderBook.deltaBestBidQuantity() - orderBook.deltaBestAskQuantity();
     }
 
-    double calculateBestOrderFlowImbalance(const OrderBook& orderBook) {
+    double calculateBestOrderFlowImbalance(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const double den = std::abs(orderBook.deltaBestBidQuantity()) + std::abs(orderBook.deltaBestAskQuantity());
         if (den <= 0.0) return 0.0;
         return (orderBook.deltaBestBidQuantity() - orderBook.deltaBestAskQuantity()) / den;
     }
 
-    double calculateBestOrderFlowFisherImbalance(const OrderBook& orderBook) {
-        return finiteAtanh(calculateBestOrderFlowImbalance(orderBook));
+    double calculateBestOrderFlowFisherImbalance(SnapshotContext& context) {
+        return finiteAtanh(calculateBestOrderFlowImbalance(context));
     }
 
-    void computeBestOFIDeltasCKS(const OrderBook& orderBook, double& dQbid_net, double& dQask_net, double& dQbid_pos, double& dQask_pos){
+    void computeBestOFIDeltasCKS(SnapshotContext& context, double& dQbid_net, double& dQask_net, double& dQbid_pos, double& dQask_pos){
+        const OrderBook& orderBook = context.orderBook();
         const double pBid  = orderBook.bestBidPrice();
         const double pAsk  = orderBook.bestAskPrice();
         const double qBid  = orderBook.bestBidQuantity();
@@ -128,45 +131,49 @@ namespace SingleVariableCounter {
         else                    dQask_pos = std::max(0.0, qAsk - qAsk0);
     }
 
-    double calculateBestOrderFlowCKSDiff(const OrderBook& orderBook){
+    double calculateBestOrderFlowCKSDiff(SnapshotContext& context){
         double dQbid, dQask, bpos, apos;
-        computeBestOFIDeltasCKS(orderBook, dQbid, dQask, bpos, apos);
+        computeBestOFIDeltasCKS(context, dQbid, dQask, bpos, apos);
         return dQbid - dQask;
     }
 
-    double calculateBestOrderFlowCKSImbalance(const OrderBook& orderBook){
+    double calculateBestOrderFlowCKSImbalance(SnapshotContext& context){
         double dQbid, dQask, bpos, apos;
-        computeBestOFIDeltasCKS(orderBook, dQbid, dQask, bpos, apos);
+        computeBestOFIDeltasCKS(context, dQbid, dQask, bpos, apos);
         const double den = std::abs(dQbid) + std::abs(dQask);
         if (den <= 0.0) return 0.0;
         return (dQbid - dQask) / den;
     }
 
-    double calculateBestOrderFlowCKSFisherImbalance(const OrderBook& orderBook){
-        return finiteAtanh(calculateBestOrderFlowCKSImbalance(orderBook));
+    double calculateBestOrderFlowCKSFisherImbalance(SnapshotContext& context){
+        return finiteAtanh(calculateBestOrderFlowCKSImbalance(context));
     }
 
-    double calculateOrderFlowDiff(const OrderBook& orderBook) {
+    double calculateOrderFlowDiff(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         return orderBook.deltaSumBidQuantity() - orderBook.deltaSumAskQuantity();
     }
 
-    double calculateOrderFlowImbalance(const OrderBook& orderBook) {
+    double calculateOrderFlowImbalance(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const double den = std::abs(orderBook.deltaSumBidQuantity()) + std::abs(orderBook.deltaSumAskQuantity());
         if (den <= 0.0) return 0.0;
         return (orderBook.deltaSumBidQuantity() - orderBook.deltaSumAskQuantity()) / den;
     }
 
-    double calculateOrderFlowFisherImbalance(const OrderBook& orderBook) {
-        return finiteAtanh(calculateOrderFlowImbalance(orderBook));
+    double calculateOrderFlowFisherImbalance(SnapshotContext& context) {
+        return finiteAtanh(calculateOrderFlowImbalance(context));
     }
 
-    double calculateQueueCountFlowDelta(const OrderBook& orderBook) {
+    double calculateQueueCountFlowDelta(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const auto bidQueueCount = static_cast<double>(orderBook.deltaBidCount());
         const auto askQueueCount = static_cast<double>(orderBook.deltaAskCount());
         return bidQueueCount - askQueueCount;
     }
 
-    double calculateQueueCountFlowImbalance(const OrderBook& orderBook) {
+    double calculateQueueCountFlowImbalance(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const auto bidQueueCount = static_cast<double>(orderBook.deltaBidCount());
         const auto askQueueCount = static_cast<double>(orderBook.deltaAskCount());
         const auto sum = bidQueueCount + askQueueCount;
@@ -176,100 +183,113 @@ namespace SingleVariableCounter {
         return (bidQueueCount - askQueueCount) / sum;
     }
 
-    double calculateQueueCountFlowFisherImbalance(const OrderBook& orderBook) {
-        return finiteAtanh(calculateQueueCountFlowImbalance(orderBook));
+    double calculateQueueCountFlowFisherImbalance(SnapshotContext& context) {
+        return finiteAtanh(calculateQueueCountFlowImbalance(context));
     }
 
-    double calculateBestVolumeDiff(const OrderBook& orderBook) {
+    double calculateBestVolumeDiff(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const double bestAskQuantity = orderBook.bestAskQuantity();
         const double bestBidQuantity = orderBook.bestBidQuantity();
         return bestBidQuantity - bestAskQuantity;
     }
 
-    double calculateBestVolumeImbalance(const OrderBook& orderBook) {
+    double calculateBestVolumeImbalance(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const double bestAskQuantity = orderBook.bestAskQuantity();
         const double bestBidQuantity = orderBook.bestBidQuantity();
         return (bestBidQuantity - bestAskQuantity) / (bestBidQuantity + bestAskQuantity);
     }
 
-    double calculateBestVolumeFisherImbalance(const OrderBook& orderBook) {
-        return std::atanh(calculateBestVolumeImbalance(orderBook));
+    double calculateBestVolumeFisherImbalance(SnapshotContext& context) {
+        return std::atanh(calculateBestVolumeImbalance(context));
     }
 
-    double calculateBestVolumeLogRatio(const OrderBook& orderBook) {
+    double calculateBestVolumeLogRatio(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const double bestAskQuantity = orderBook.bestAskQuantity();
         const double bestBidQuantity = orderBook.bestBidQuantity();
         return std::log(bestBidQuantity/bestAskQuantity);
     }
 
-    double calculateBestVolumeSignedLogRatioXVolume(const OrderBook& orderBook) {
+    double calculateBestVolumeSignedLogRatioXVolume(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const double bestBidQuantity = orderBook.bestBidQuantity();
         const double bestAskQuantity = orderBook.bestAskQuantity();
-        return calculateBestVolumeLogRatio(orderBook) * (bestBidQuantity + bestAskQuantity);
+        return calculateBestVolumeLogRatio(context) * (bestBidQuantity + bestAskQuantity);
     }
 
-    double calculateBestNPriceLevelsVolumeImbalance(const OrderBook& orderBook, const int nPriceLevels) {
-        const double cumulativeSumTopNBidsQuantities = orderBook.cumulativeQuantityOfTopNBids(nPriceLevels);
-        const double cumulativeSumTopNAsksQuantities = orderBook.cumulativeQuantityOfTopNAsks(nPriceLevels);
+    double calculateBestNPriceLevelsVolumeImbalance(SnapshotContext& context, const int nPriceLevels) {
+        const double cumulativeSumTopNBidsQuantities = context.cumulativeQuantityOfTopNBids(nPriceLevels);
+        const double cumulativeSumTopNAsksQuantities = context.cumulativeQuantityOfTopNAsks(nPriceLevels);
         return (cumulativeSumTopNBidsQuantities - cumulativeSumTopNAsksQuantities)
             / (cumulativeSumTopNBidsQuantities + cumulativeSumTopNAsksQuantities);
     }
 
-    double calculateBestNPriceLevelsVolumeDiff(const OrderBook& orderBook, const int nPriceLevels) {
-        return orderBook.cumulativeQuantityOfTopNBids(nPriceLevels) - orderBook.cumulativeQuantityOfTopNAsks(nPriceLevels);
+    double calculateBestNPriceLevelsVolumeDiff(SnapshotContext& context, const int nPriceLevels) {
+        return context.cumulativeQuantityOfTopNBids(nPriceLevels) - context.cumulativeQuantityOfTopNAsks(nPriceLevels);
     }
 
-    double calculateBestNPriceLevelsVolumeLogRatio(const OrderBook& orderBook, const int nPriceLevels) {
+    double calculateBestNPriceLevelsVolumeLogRatio(SnapshotContext& context, const int nPriceLevels) {
         return std::log(
-            orderBook.cumulativeQuantityOfTopNBids(nPriceLevels) / orderBook.cumulativeQuantityOfTopNAsks(nPriceLevels)
+            context.cumulativeQuantityOfTopNBids(nPriceLevels) / context.cumulativeQuantityOfTopNAsks(nPriceLevels)
             );
     }
 
-    double calculateBestNPriceLevelsVolumeLogRatioXVolume(const OrderBook& orderBook, const int nPriceLevels) {
+    double calculateBestNPriceLevelsVolumeLogRatioXVolume(SnapshotContext& context, const int nPriceLevels) {
         const double cumulativeQuantityOfTopNLevels =
-            orderBook.cumulativeQuantityOfTopNBids(nPriceLevels) + orderBook.cumulativeQuantityOfTopNAsks(nPriceLevels);
-        return calculateBestNPriceLevelsVolumeLogRatio(orderBook, nPriceLevels) * cumulativeQuantityOfTopNLevels;
+            context.cumulativeQuantityOfTopNBids(nPriceLevels) + context.cumulativeQuantityOfTopNAsks(nPriceLevels);
+        return calculateBestNPriceLevelsVolumeLogRatio(context, nPriceLevels) * cumulativeQuantityOfTopNLevels;
     }
 
-    double calculateVolumeImbalance(const OrderBook& orderBook) {
+    double calculateVolumeImbalance(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         return (orderBook.sumBidQuantity() - orderBook.sumAskQuantity())
             / (orderBook.sumBidQuantity() + orderBook.sumAskQuantity());
     }
 
-    double calculateVolumeDiff(const OrderBook& orderBook) {
+    double calculateVolumeDiff(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         return orderBook.sumBidQuantity() - orderBook.sumAskQuantity();
     }
 
-    double calculateVolumeLogRatio(const OrderBook& orderBook) {
+    double calculateVolumeLogRatio(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         return std::log(
             orderBook.sumBidQuantity() / orderBook.sumAskQuantity()
             );
     }
 
-    double calculateVolumeLogRatioXVolume(const OrderBook& orderBook) {
-        return calculateVolumeLogRatio(orderBook) * orderBook.sumTotalAskBidQuantity();
+    double calculateVolumeLogRatioXVolume(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
+        return calculateVolumeLogRatio(context) * orderBook.sumTotalAskBidQuantity();
     }
 
-    double calculateQueueImbalance(const OrderBook& orderBook) {
+    double calculateQueueImbalance(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         return static_cast<double>(static_cast<int>(orderBook.bidCount()) - static_cast<int>(orderBook.askCount()))
             / static_cast<double>(static_cast<int>(orderBook.bidCount()) + static_cast<int>(orderBook.askCount()));
     }
 
-    double calculateQueueDiff(const OrderBook& orderBook) {
+    double calculateQueueDiff(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         return static_cast<double>(orderBook.bidCount()) - static_cast<double>(orderBook.askCount());
     }
 
-    double calculateQueueLogRatio(const OrderBook& orderBook) {
+    double calculateQueueLogRatio(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         return std::log(
             static_cast<double>(orderBook.bidCount()) / static_cast<double>(orderBook.askCount())
             );
     }
 
-    double calculateQueueLogRatioXVolume(const OrderBook& orderBook) {
-        return calculateQueueLogRatio(orderBook) * orderBook.sumTotalAskBidQuantity();
+    double calculateQueueLogRatioXVolume(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
+        return calculateQueueLogRatio(context) * orderBook.sumTotalAskBidQuantity();
     }
 
-    double calculateGap(const OrderBook& orderBook) {
+    double calculateGap(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const double bestBidPrice = orderBook.bestBidPrice();
         const double bestAskPrice = orderBook.bestAskPrice();
         const double secondBidPrice = orderBook.secondBidPrice();
@@ -281,31 +301,33 @@ namespace SingleVariableCounter {
         return tradeEntry->isBuyerMarketMaker;
     }
 
-    double calculateVwapDeviation(const OrderBook& orderBook) {
+    double calculateVwapDeviation(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const double sumBidsAsksQuantity = orderBook.sumAskQuantity() + orderBook.sumBidQuantity();
         const double vwap = orderBook.sumOfPriceTimesQuantity() / sumBidsAsksQuantity;
-        const double midPrice = calculateMidPrice(orderBook);
+        const double midPrice = context.midPrice();
         return (vwap - midPrice) / midPrice;
     }
 
-    double calculateVwapLogRatio(const OrderBook& orderBook) {
+    double calculateVwapLogRatio(SnapshotContext& context) {
+        const OrderBook& orderBook = context.orderBook();
         const double sumBidsAsksQuantity = orderBook.sumAskQuantity() + orderBook.sumBidQuantity();
         const double vwap = orderBook.sumOfPriceTimesQuantity() / sumBidsAsksQuantity;
-        const double midPrice = calculateMidPrice(orderBook);
+        const double midPrice = context.midPrice();
         return std::log(midPrice / vwap);
     }
 
-    double calculateSimplifiedSlopeImbalance(const OrderBook& orderBook)
+    double calculateSimplifiedSlopeImbalance(SnapshotContext& context)
     {
         constexpr size_t K = 5;
 
-        const double bestFiveAsksQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNAsks(K);
-        const double bestFiveBidsQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNBids(K);
+        const double bestFiveAsksQuantityCumulativeSum = context.cumulativeQuantityOfTopNAsks(K);
+        const double bestFiveBidsQuantityCumulativeSum = context.cumulativeQuantityOfTopNBids(K);
 
-        const double bestFifthAskPrice = orderBook.bestNthAskPrice(K);
-        const double bestFifthBidPrice = orderBook.bestNthBidPrice(K);
+        const double bestFifthAskPrice = context.bestNthAskPrice(K);
+        const double bestFifthBidPrice = context.bestNthBidPrice(K);
 
-        const double midPrice = calculateMidPrice(orderBook);
+        const double midPrice = context.midPrice();
 
         const double bidSlope = bestFiveBidsQuantityCumulativeSum / (midPrice - bestFifthBidPrice);
         const double askSlope = bestFiveAsksQuantityCumulativeSum / (bestFifthAskPrice - midPrice);
@@ -313,17 +335,17 @@ namespace SingleVariableCounter {
         return (bidSlope - askSlope) / (bidSlope + askSlope);
     }
 
-    double calculateSimplifiedSlopeDiff(const OrderBook& orderBook)
+    double calculateSimplifiedSlopeDiff(SnapshotContext& context)
     {
         constexpr size_t K = 5;
 
-        const double bestFiveAsksQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNAsks(K);
-        const double bestFiveBidsQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNBids(K);
+        const double bestFiveAsksQuantityCumulativeSum = context.cumulativeQuantityOfTopNAsks(K);
+        const double bestFiveBidsQuantityCumulativeSum = context.cumulativeQuantityOfTopNBids(K);
 
-        const double bestFifthAskPrice = orderBook.bestNthAskPrice(K);
-        const double bestFifthBidPrice = orderBook.bestNthBidPrice(K);
+        const double bestFifthAskPrice = context.bestNthAskPrice(K);
+        const double bestFifthBidPrice = context.bestNthBidPrice(K);
 
-        const double midPrice = calculateMidPrice(orderBook);
+        const double midPrice = context.midPrice();
 
         const double bidSlope = bestFiveBidsQuantityCumulativeSum / (midPrice - bestFifthBidPrice);
         const double askSlope = bestFiveAsksQuantityCumulativeSum / (bestFifthAskPrice - midPrice);
@@ -331,17 +353,17 @@ namespace SingleVariableCounter {
         return bidSlope - askSlope;
     }
 
-    double calculateSimplifiedSlopeLogRatio(const OrderBook& orderBook)
+    double calculateSimplifiedSlopeLogRatio(SnapshotContext& context)
     {
         constexpr size_t K = 5;
 
-        const double bestFiveAsksQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNAsks(K);
-        const double bestFiveBidsQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNBids(K);
+        const double bestFiveAsksQuantityCumulativeSum = context.cumulativeQuantityOfTopNAsks(K);
+        const double bestFiveBidsQuantityCumulativeSum = context.cumulativeQuantityOfTopNBids(K);
 
-        const double bestFifthAskPrice = orderBook.bestNthAskPrice(K);
-        const double bestFifthBidPrice = orderBook.bestNthBidPrice(K);
+        const double bestFifthAskPrice = context.bestNthAskPrice(K);
+        const double bestFifthBidPrice = context.bestNthBidPrice(K);
 
-        const double midPrice = calculateMidPrice(orderBook);
+        const double midPrice = context.midPrice();
 
         const double bidSlope = bestFiveBidsQuantityCumulativeSum / (midPrice - bestFifthBidPrice);
         const double askSlope = bestFiveAsksQuantityCumulativeSum / (bestFifthAskPrice - midPrice);
@@ -349,17 +371,17 @@ namespace SingleVariableCounter {
         return std::log(bidSlope/askSlope);
     }
 
-    double calculateBgcSlopeImbalance(const OrderBook& orderBook)
+    double calculateBgcSlopeImbalance(SnapshotContext& context)
     {
         constexpr size_t K = 5;
 
-        const double bestFiveAsksQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNAsks(K);
-        const double bestFiveBidsQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNBids(K);
+        const double bestFiveAsksQuantityCumulativeSum = context.cumulativeQuantityOfTopNAsks(K);
+        const double bestFiveBidsQuantityCumulativeSum = context.cumulativeQuantityOfTopNBids(K);
 
-        const double bestFifthAskPrice = orderBook.bestNthAskPrice(K);
-        const double bestFifthBidPrice = orderBook.bestNthBidPrice(K);
+        const double bestFifthAskPrice = context.bestNthAskPrice(K);
+        const double bestFifthBidPrice = context.bestNthBidPrice(K);
 
-        const double midPrice = calculateMidPrice(orderBook);
+        const double midPrice = context.midPrice();
 
         const double bidSlope = (midPrice - bestFifthBidPrice) / bestFiveBidsQuantityCumulativeSum;
         const double askSlope = (bestFifthAskPrice - midPrice) / bestFiveAsksQuantityCumulativeSum;
@@ -367,17 +389,17 @@ namespace SingleVariableCounter {
         return (bidSlope - askSlope) / (bidSlope + askSlope);
     }
 
-    double calculateBgcSlopeDiff(const OrderBook& orderBook)
+    double calculateBgcSlopeDiff(SnapshotContext& context)
     {
         constexpr size_t K = 5;
 
-        const double bestFiveAsksQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNAsks(K);
-        const double bestFiveBidsQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNBids(K);
+        const double bestFiveAsksQuantityCumulativeSum = context.cumulativeQuantityOfTopNAsks(K);
+        const double bestFiveBidsQuantityCumulativeSum = context.cumulativeQuantityOfTopNBids(K);
 
-        const double bestFifthAskPrice = orderBook.bestNthAskPrice(K);
-        const double bestFifthBidPrice = orderBook.bestNthBidPrice(K);
+        const double bestFifthAskPrice = context.bestNthAskPrice(K);
+        const double bestFifthBidPrice = context.bestNthBidPrice(K);
 
-        const double midPrice = calculateMidPrice(orderBook);
+        const double midPrice = context.midPrice();
 
         const double bidSlope = (midPrice - bestFifthBidPrice) / bestFiveBidsQuantityCumulativeSum;
         const double askSlope = (bestFifthAskPrice - midPrice) / bestFiveAsksQuantityCumulativeSum;
@@ -385,16 +407,16 @@ namespace SingleVariableCounter {
         return bidSlope - askSlope;
     }
 
-    double calculateBgcSlopeLogRatio(const OrderBook& orderBook) {
+    double calculateBgcSlopeLogRatio(SnapshotContext& context) {
         constexpr size_t K = 5;
 
-        const double bestFiveAsksQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNAsks(K);
-        const double bestFiveBidsQuantityCumulativeSum = orderBook.cumulativeQuantityOfTopNBids(K);
+        const double bestFiveAsksQuantityCumulativeSum = context.cumulativeQuantityOfTopNAsks(K);
+        const double bestFiveBidsQuantityCumulativeSum = context.cumulativeQuantityOfTopNBids(K);
 
-        const double bestFifthAskPrice = orderBook.bestNthAskPrice(K);
-        const double bestFifthBidPrice = orderBook.bestNthBidPrice(K);
+        const double bestFifthAskPrice = context.bestNthAskPrice(K);
+        const double bestFifthBidPrice = context.bestNthBidPrice(K);
 
-        const double midPrice = calculateMidPrice(orderBook);
+        const double midPrice = context.midPrice();
 
         const double bidSlope = (midPrice - bestFifthBidPrice) / bestFiveBidsQuantityCumulativeSum;
         const double askSlope = (bestFifthAskPrice - midPrice) / bestFiveAsksQuantityCumulativeSum;
@@ -402,51 +424,57 @@ namespace SingleVariableCounter {
         return std::log(bidSlope/askSlope);
     }
 
-    double calculateDifferenceDepthCount(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, const int windowTimeSeconds){
-        const auto bidDifferenceDepthEntryCount  = static_cast<double>(rollingDifferenceDepthStatistics.bidDifferenceDepthEntryCount(windowTimeSeconds));
-        const auto askDifferenceDepthEntryCount = static_cast<double>(rollingDifferenceDepthStatistics.askDifferenceDepthEntryCount(windowTimeSeconds));
+    double calculateDifferenceDepthCount(SnapshotContext& context, const int64_t windowMicros){
+        const auto counts = context.depthCounts(windowMicros);
+        const auto bidDifferenceDepthEntryCount  = static_cast<double>(counts.bidDifferenceDepthEntryCount);
+        const auto askDifferenceDepthEntryCount = static_cast<double>(counts.askDifferenceDepthEntryCount);
         return bidDifferenceDepthEntryCount + askDifferenceDepthEntryCount;
     }
 
-    double calculateTradeCount(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        const auto buyTradeCount  = static_cast<double>(rollingTradeStatistics.buyTradeCount(windowTimeSeconds));
-        const auto sellTradeCount = static_cast<double>(rollingTradeStatistics.sellTradeCount(windowTimeSeconds));
+    double calculateTradeCount(SnapshotContext& context, const int64_t windowMicros){
+        const auto totals = context.tradeTotals(windowMicros);
+        const auto buyTradeCount  = static_cast<double>(totals.buyTradeCount);
+        const auto sellTradeCount = static_cast<double>(totals.sellTradeCount);
         return buyTradeCount + sellTradeCount;
     }
 
-    double calculateDifferenceDepthCountDiff(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, const int windowTimeSeconds){
-        const auto bidDifferenceDepthEntryCount = static_cast<double>(rollingDifferenceDepthStatistics.bidDifferenceDepthEntryCount(windowTimeSeconds));
-        const auto askDifferenceDepthEntryCount = static_cast<double>(rollingDifferenceDepthStatistics.askDifferenceDepthEntryCount(windowTimeSeconds));
+    double calculateDifferenceDepthCountDiff(SnapshotContext& context, const int64_t windowMicros){
+        const auto counts = context.depthCounts(windowMicros);
+        const auto bidDifferenceDepthEntryCount = static_cast<double>(counts.bidDifferenceDepthEntryCount);
+        const auto askDifferenceDepthEntryCount = static_cast<double>(counts.askDifferenceDepthEntryCount);
 
         return bidDifferenceDepthEntryCount - askDifferenceDepthEntryCount;
     }
 
-    double calculateDifferenceDepthCountImbalance(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, const int windowTimeSeconds){
-        const auto askDifferenceDepthEntryCount = static_cast<double>(rollingDifferenceDepthStatistics.askDifferenceDepthEntryCount(windowTimeSeconds));
-        const auto bidDifferenceDepthEntryCount = static_cast<double>(rollingDifferenceDepthStatistics.bidDifferenceDepthEntryCount(windowTimeSeconds));
+    double calculateDifferenceDepthCountImbalance(SnapshotContext& context, const int64_t windowMicros){
+        const auto counts = context.depthCounts(windowMicros);
+        const auto askDifferenceDepthEntryCount = static_cast<double>(counts.askDifferenceDepthEntryCount);
+        const auto bidDifferenceDepthEntryCount = static_cast<double>(counts.bidDifferenceDepthEntryCount);
         const double total = bidDifferenceDepthEntryCount + askDifferenceDepthEntryCount;
 
         if (total == 0.0) return 0.0;
         return (bidDifferenceDepthEntryCount - askDifferenceDepthEntryCount) / total;
     }
 
-    double calculateDifferenceDepthCountFisherImbalance(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, const int windowTimeSeconds){
-        return finiteAtanh(calculateDifferenceDepthCountImbalance(rollingDifferenceDepthStatistics, windowTimeSeconds));
+    double calculateDifferenceDepthCountFisherImbalance(SnapshotContext& context, const int64_t windowMicros){
+        return finiteAtanh(calculateDifferenceDepthCountImbalance(context, windowMicros));
     }
 
-    double calculateDifferenceDepthCountLogRatio(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, const int windowTimeSeconds)
+    double calculateDifferenceDepthCountLogRatio(SnapshotContext& context, const int64_t windowMicros)
     {
-        const auto bidDifferenceDepthEntryCount = static_cast<double>(rollingDifferenceDepthStatistics.bidDifferenceDepthEntryCount(windowTimeSeconds));
-        const auto askDifferenceDepthEntryCount = static_cast<double>(rollingDifferenceDepthStatistics.askDifferenceDepthEntryCount(windowTimeSeconds));
+        const auto counts = context.depthCounts(windowMicros);
+        const auto bidDifferenceDepthEntryCount = static_cast<double>(counts.bidDifferenceDepthEntryCount);
+        const auto askDifferenceDepthEntryCount = static_cast<double>(counts.askDifferenceDepthEntryCount);
 
         constexpr double eps = 1e-12;
         return std::log((bidDifferenceDepthEntryCount + eps) / (askDifferenceDepthEntryCount + eps));
     }
 
-    double calculateDifferenceDepthCountLogRatioXEventCount(const RollingDifferenceDepthStatistics& rollingDifferenceDepthStatistics, const int windowTimeSeconds)
+    double calculateDifferenceDepthCountLogRatioXEventCount(SnapshotContext& context, const int64_t windowMicros)
     {
-        const auto bidDifferenceDepthEntryCount = static_cast<double>(rollingDifferenceDepthStatistics.bidDifferenceDepthEntryCount(windowTimeSeconds));
-        const auto askDifferenceDepthEntryCount = static_cast<double>(rollingDifferenceDepthStatistics.askDifferenceDepthEntryCount(windowTimeSeconds));
+        const auto counts = context.depthCounts(windowMicros);
+        const auto bidDifferenceDepthEntryCount = static_cast<double>(counts.bidDifferenceDepthEntryCount);
+        const auto askDifferenceDepthEntryCount = static_cast<double>(counts.askDifferenceDepthEntryCount);
         const auto total = bidDifferenceDepthEntryCount + askDifferenceDepthEntryCount;
 
         constexpr double eps = 1e-12;
@@ -454,16 +482,18 @@ namespace SingleVariableCounter {
         return std::log((bidDifferenceDepthEntryCount + eps) / (askDifferenceDepthEntryCount + eps)) * total;
     }
 
-    double calculateTradeCountDiff(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        const auto buyTradeCount  = static_cast<double>(rollingTradeStatistics.buyTradeCount(windowTimeSeconds));
-        const auto sellTradeCount = static_cast<double>(rollingTradeStatistics.sellTradeCount(windowTimeSeconds));
+    double calculateTradeCountDiff(SnapshotContext& context, const int64_t windowMicros){
+        const auto totals = context.tradeTotals(windowMicros);
+        const auto buyTradeCount  = static_cast<double>(totals.buyTradeCount);
+        const auto sellTradeCount = static_cast<double>(totals.sellTradeCount);
 
         return buyTradeCount - sellTradeCount;
     }
 
-    double calculateTradeCountImbalance(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        const auto buys  = static_cast<double>(rollingTradeStatistics.buyTradeCount(windowTimeSeconds));
-        const auto sells = static_cast<double>(rollingTradeStatistics.sellTradeCount(windowTimeSeconds));
+    double calculateTradeCountImbalance(SnapshotContext& context, const int64_t windowMicros){
+        const auto totals = context.tradeTotals(windowMicros);
+        const auto buys  = static_cast<double>(totals.buyTradeCount);
+        const auto sells = static_cast<double>(totals.sellTradeCount);
 
         const double total = buys + sells;
         if (total <= 0.0) return 0.0;
@@ -471,28 +501,31 @@ namespace SingleVariableCounter {
         return (buys - sells) / total;
     }
 
-    double calculateTradeCountFisherImbalance(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        return finiteAtanh(calculateTradeCountImbalance(rollingTradeStatistics, windowTimeSeconds));
+    double calculateTradeCountFisherImbalance(SnapshotContext& context, const int64_t windowMicros){
+        return finiteAtanh(calculateTradeCountImbalance(context, windowMicros));
     }
 
-    double calculateTradeCountLogRatio(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        const auto buys  = static_cast<double>(rollingTradeStatistics.buyTradeCount(windowTimeSeconds));
-        const auto sells = static_cast<double>(rollingTradeStatistics.sellTradeCount(windowTimeSeconds));
+    double calculateTradeCountLogRatio(SnapshotContext& context, const int64_t windowMicros){
+        const auto totals = context.tradeTotals(windowMicros);
+        const auto buys  = static_cast<double>(totals.buyTradeCount);
+        const auto sells = static_cast<double>(totals.sellTradeCount);
 
         constexpr double eps = 1e-12;
 
         return std::log((buys + eps) / (sells + eps));
     }
 
-    double calculateTradeVolumeDiff(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        const double buyTradeVolume = rollingTradeStatistics.buyTradeVolume(windowTimeSeconds);
-        const double sellTradeVolume = rollingTradeStatistics.sellTradeVolume(windowTimeSeconds);
+    double calculateTradeVolumeDiff(SnapshotContext& context, const int64_t windowMicros){
+        const auto totals = context.tradeTotals(windowMicros);
+        const double buyTradeVolume = totals.buyTradeVolume;
+        const double sellTradeVolume = totals.sellTradeVolume;
         return buyTradeVolume - sellTradeVolume;
     }
 
-    double calculateTradeVolumeImbalance(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        const auto buyTradeVolume  = rollingTradeStatistics.buyTradeVolume(windowTimeSeconds);
-        const auto sellTradeVolume = rollingTradeStatistics.sellTradeVolume(windowTimeSeconds);
+    double calculateTradeVolumeImbalance(SnapshotContext& context, const int64_t windowMicros){
+        const auto totals = context.tradeTotals(windowMicros);
+        const auto buyTradeVolume  = totals.buyTradeVolume;
+        const auto sellTradeVolume = totals.sellTradeVolume;
 
         const double total = buyTradeVolume + sellTradeVolume;
         if (total <= 0.0) return 0.0;
@@ -500,32 +533,35 @@ namespace SingleVariableCounter {
         return (buyTradeVolume - sellTradeVolume) / total;
     }
 
-    double calculateTradeVolumeLogRatio(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
+    double calculateTradeVolumeLogRatio(SnapshotContext& context, const int64_t windowMicros){
+        const auto totals = context.tradeTotals(windowMicros);
         constexpr double eps = 1e-12;
-        const double buyTradeVolume = rollingTradeStatistics.buyTradeVolume(windowTimeSeconds);
-        const double sellTradeVolume = rollingTradeStatistics.sellTradeVolume(windowTimeSeconds);
+        const double buyTradeVolume = totals.buyTradeVolume;
+        const double sellTradeVolume = totals.sellTradeVolume;
 
         return std::log((buyTradeVolume + eps) / (sellTradeVolume + eps));
     }
 
-    double calculateAvgTradeSizeDiff(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        const double buyTradeVolume = rollingTradeStatistics.buyTradeVolume(windowTimeSeconds);
-        const double sellTradeVolume = rollingTradeStatistics.sellTradeVolume(windowTimeSeconds);
+    double calculateAvgTradeSizeDiff(SnapshotContext& context, const int64_t windowMicros){
+        const auto totals = context.tradeTotals(windowMicros);
+        const double buyTradeVolume = totals.buyTradeVolume;
+        const double sellTradeVolume = totals.sellTradeVolume;
 
-        const auto buyTradeCount  = static_cast<double>(rollingTradeStatistics.buyTradeCount(windowTimeSeconds));
-        const auto sellTradeCount = static_cast<double>(rollingTradeStatistics.sellTradeCount(windowTimeSeconds));
+        const auto buyTradeCount  = static_cast<double>(totals.buyTradeCount);
+        const auto sellTradeCount = static_cast<double>(totals.sellTradeCount);
         const double avgTradeSizeBid = buyTradeCount > 0.0 ? buyTradeVolume / buyTradeCount : 0.0;
         const double avgTradeSizeAsk = sellTradeCount > 0.0 ? sellTradeVolume / sellTradeCount : 0.0;
 
         return avgTradeSizeBid - avgTradeSizeAsk;
     }
 
-    double calculateAvgTradeSizeImbalance(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        const double buyTradeVolume = rollingTradeStatistics.buyTradeVolume(windowTimeSeconds);
-        const double sellTradeVolume = rollingTradeStatistics.sellTradeVolume(windowTimeSeconds);
+    double calculateAvgTradeSizeImbalance(SnapshotContext& context, const int64_t windowMicros){
+        const auto totals = context.tradeTotals(windowMicros);
+        const double buyTradeVolume = totals.buyTradeVolume;
+        const double sellTradeVolume = totals.sellTradeVolume;
 
-        const auto buyTradeCount  = static_cast<double>(rollingTradeStatistics.buyTradeCount(windowTimeSeconds));
-        const auto sellTradeCount = static_cast<double>(rollingTradeStatistics.sellTradeCount(windowTimeSeconds));
+        const auto buyTradeCount  = static_cast<double>(totals.buyTradeCount);
+        const auto sellTradeCount = static_cast<double>(totals.sellTradeCount);
         const double avgTradeSizeBid = buyTradeCount > 0.0 ? buyTradeVolume / buyTradeCount : 0.0;
         const double avgTradeSizeAsk = sellTradeCount > 0.0 ? sellTradeVolume / sellTradeCount : 0.0;
 
@@ -533,12 +569,13 @@ namespace SingleVariableCounter {
         return den == 0.0 ? 0.0 : (avgTradeSizeBid - avgTradeSizeAsk) / den;
     }
 
-    double calculateAvgTradeSizeLogRatio(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        const double buyTradeVolume = rollingTradeStatistics.buyTradeVolume(windowTimeSeconds);
-        const double sellTradeVolume = rollingTradeStatistics.sellTradeVolume(windowTimeSeconds);
+    double calculateAvgTradeSizeLogRatio(SnapshotContext& context, const int64_t windowMicros){
+        const auto totals = context.tradeTotals(windowMicros);
+        const double buyTradeVolume = totals.buyTradeVolume;
+        const double sellTradeVolume = totals.sellTradeVolume;
 
-        const auto buyTradeCount  = static_cast<double>(rollingTradeStatistics.buyTradeCount(windowTimeSeconds));
-        const auto sellTradeCount = static_cast<double>(rollingTradeStatistics.sellTradeCount(windowTimeSeconds));
+        const auto buyTradeCount  = static_cast<double>(totals.buyTradeCount);
+        const auto sellTradeCount = static_cast<double>(totals.sellTradeCount);
         const double avgTradeSizeBid = buyTradeCount > 0.0 ? buyTradeVolume / buyTradeCount : 0.0;
         const double avgTradeSizeAsk = sellTradeCount > 0.0 ? sellTradeVolume / sellTradeCount : 0.0;
 
@@ -546,109 +583,55 @@ namespace SingleVariableCounter {
         return std::log((avgTradeSizeBid + eps) / (avgTradeSizeAsk + eps));
     }
 
-    double calculateBiggestSingleBuyTradeVolume(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        return rollingTradeStatistics.biggestBuyTradeNSeconds(windowTimeSeconds);
+    double calculateBiggestSingleBuyTradeVolume(SnapshotContext& context, const int64_t windowMicros){
+        return context.trades().biggestBuyTrade(windowMicros);
     }
 
-    double calculateBiggestSingleSellTradeVolume(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        return rollingTradeStatistics.biggestSellTradeNSeconds(windowTimeSeconds);
+    double calculateBiggestSingleSellTradeVolume(SnapshotContext& context, const int64_t windowMicros){
+        return context.trades().biggestSellTrade(windowMicros);
     }
 
-    double calculatePriceDifference(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
-        return rollingTradeStatistics.priceDifference(windowTimeSeconds);
+    double calculatePriceDifference(SnapshotContext& context, const int64_t windowMicros){
+        return context.priceDifference(windowMicros);
     }
 
-    double calculateRateOfReturn(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds) {
-        const double priceDifference = rollingTradeStatistics.priceDifference(windowTimeSeconds);
+    double calculateRateOfReturn(SnapshotContext& context, const int64_t windowMicros) {
+        const double priceDifference = context.priceDifference(windowMicros);
 
-        const double oldestPrice = rollingTradeStatistics.oldestPrice(windowTimeSeconds);
+        const double oldestPrice = context.oldestPrice(windowMicros);
 
         if (oldestPrice == 0.0) return 0.0;
 
         return priceDifference * 100 / oldestPrice;
     }
 
-    double calculateLogReturnRatio(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds){
+    double calculateLogReturnRatio(SnapshotContext& context, const int64_t windowMicros){
         constexpr double eps = 1e-12;
-        const double oldestPrice = rollingTradeStatistics.oldestPrice(windowTimeSeconds);
-        const double lastTradePrice = rollingTradeStatistics.lastTradePrice();
+        const double oldestPrice = context.oldestPrice(windowMicros);
+        const double lastTradePrice = context.trades().lastTradePrice();
 
         return std::log((lastTradePrice + eps)/(oldestPrice + eps));
     }
 
-    double calculateLogKylesLambda(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds) {
+    double calculateLogKylesLambda(SnapshotContext& context, const int64_t windowMicros) {
         constexpr double eps = 1e-12;
-        const double priceChange = std::abs(rollingTradeStatistics.priceDifference(windowTimeSeconds));
-        const double totalVolume = std::abs(
-            rollingTradeStatistics.buyTradeVolume(windowTimeSeconds) -
-            rollingTradeStatistics.sellTradeVolume(windowTimeSeconds)
-            );
+        const double priceChange = std::abs(context.priceDifference(windowMicros));
+        const auto totals = context.tradeTotals(windowMicros);
+        const double totalVolume = std::abs(totals.buyTradeVolume - totals.sellTradeVolume);
 
         return std::log((priceChange + eps) / (totalVolume + eps));
     }
 
-    double calculateRSI(const RollingTradeStatistics& rollingTradeStatistics, const int startWindowTimeSeconds, const int windowTimeSeconds)
-    {
-        const int periods = 14;
-        double gainSum = 0.0, lossSum = 0.0;
-
-        for (int i = 1; i <= periods; ++i) {
-            int t1 = startWindowTimeSeconds + i * windowTimeSeconds;
-            int t0 = startWindowTimeSeconds + (i - 1) * windowTimeSeconds;
-
-            double diff_i = rollingTradeStatistics.priceDifference(t1) - rollingTradeStatistics.priceDifference(t0);
-            if (diff_i > 0)
-            {
-                gainSum += diff_i;
-            }
-            else
-            {
-                lossSum += -diff_i;
-            }
-        }
-
-        const double avgGain = gainSum / periods;
-        const double avgLoss = lossSum / periods;
-
-        if (avgGain + avgLoss == 0.0) {
-            return 50.0;  // brak ruchu ⇒ RSI na poziomie środka skali
-        }
-
-        double rs = (avgLoss == 0.0)
-                  ? std::numeric_limits<double>::infinity()
-                  : (avgGain / avgLoss);
-        const double rsi = 100.0 - (100.0 / (1.0 + rs));
-        return rsi;
-    }
-
-    double calculateStochRSI(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds) {
-        constexpr int periods = 14;
-        std::array<double, periods> rsiValues;
-
-        // rsiValues[0] = RSI na ostatnich 14 świecach
-        // rsiValues[1] = RSI od świecy -1 do -14 itd.
-        for (int i = 0; i < periods; ++i) {
-            const int offset = i * windowTimeSeconds;
-            rsiValues[i] = calculateRSI(rollingTradeStatistics, offset, windowTimeSeconds);
-        }
-
-        const double minR = *std::ranges::min_element(rsiValues);
-        const double maxR = *std::ranges::max_element(rsiValues);
-        const double curr = rsiValues[0];
-
-        if (maxR == minR) return 0.0;
-        return (curr - minR) / (maxR - minR);
-    }
-
-    double calculateMacd(const RollingTradeStatistics& rollingTradeStatistics, const int windowTimeSeconds)
-    {
-        constexpr int shortPeriod = 12;
-        constexpr int longPeriod  = 26;
+    double calculateRSI(SnapshotContext& context, const int windowTimeSeconds) {
+        return context.trades().rsi(windowTimeSeconds);
+    }
 
-        const double emaShort = rollingTradeStatistics.simpleMovingAverage(windowTimeSeconds * shortPeriod);
-        const double emaLong  = rollingTradeStatistics.simpleMovingAverage(windowTimeSeconds * longPeriod);
+    double calculateStochRSI(SnapshotContext& context, const int windowTimeSeconds) {
+        return context.trades().stochRsi(windowTimeSeconds);
+    }
 
-        return round8(emaShort - emaLong);
+    double calculateMacd(SnapshotContext& context, const int windowTimeSeconds) {
+        return round8(context.trades().macd(windowTimeSeconds));
     }
 
 }
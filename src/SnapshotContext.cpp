@@ -0,0 +1,79 @@
+#include "SnapshotContext.h"
+#include "MarketState.h"
+
+SnapshotContext::SnapshotContext(const SnapshotContext& other)
+    : marketState_(other.marketState_)
+    , orderBook_(other.orderBook_)
+    , trades_(other.trades_)
+    , depth_(other.depth_)
+{}
+
+SnapshotContext& SnapshotContext::operator=(const SnapshotContext& other) {
+    marketState_ = other.marketState_;
+    orderBook_ = other.orderBook_;
+    trades_ = other.trades_;
+    depth_ = other.depth_;
+    memos_.reset();
+    return *this;
+}
+
+void SnapshotContext::reset(const MarketState& marketState) {
+    marketState_ = &marketState;
+    orderBook_ = &marketState.orderBook;
+    trades_ = &marketState.rollingTradeStatistics;
+    depth_ = &marketState.rollingDifferenceDepthStatistics;
+
+    if (!memos_) {
+        memos_ = std::make_unique<Memos>();
+    } else if (++generation_ == 0) {
+        // stamps from 2^32 rows ago would read as current again
+        *memos_ = Memos{};
+        generation_ = 1;
+    }
+}
+
+double SnapshotContext::midPrice() {
+    return memo<&Memos::midPrice>([this] {
+        return (orderBook_->bestBidPrice() + orderBook_->bestAskPrice()) * 0.5;
+    });
+}
+
+double SnapshotContext::microPrice() {
+    return memo<&Memos::microPrice>([this] {
+        const OrderBook& book = *orderBook_;
+        return (book.bestAskPrice() * book.bestBidQuantity() + book.bestBidPrice() * book.bestAskQuantity())
+            / (book.bestBidQuantity() + book.bestAskQuantity());
+    });
+}
+
+double SnapshotContext::cumulativeQuantityOfTopNBids(const size_t n) {
+    return memo<&Memos::topNBids>(n, [&] { return orderBook_->cumulativeQuantityOfTopNBids(n); });
+}
+
+double SnapshotContext::cumulativeQuantityOfTopNAsks(const size_t n) {
+    return memo<&Memos::topNAsks>(n, [&] { return orderBook_->cumulativeQuantityOfTopNAsks(n); });
+}
+
+double SnapshotContext::bestNthBidPrice(const size_t n) {
+    return memo<&Memos::nthBidPrice>(n, [&] { return orderBook_->bestNthBidPrice(n); });
+}
+
+double SnapshotContext::bestNthAskPrice(const size_t n) {
+    return memo<&Memos::nthAskPrice>(n, [&] { return orderBook_->bestNthAskPrice(n); });
+}
+
+RollingTradeStatistics::WindowTotals SnapshotContext::tradeTotals(const int64_t windowMicros) {
+    return memoWindow<&Memos::tradeTotals>(windowMicros, [&] { return trades_->windowTotals(windowMicros); });
+}
+
+double SnapshotContext::priceDifference(const int64_t windowMicros) {
+    return memoWindow<&Memos::priceDifference>(windowMicros, [&] { return trades_->priceDifference(windowMicros); });
+}
+
+double SnapshotContext::oldestPrice(const int64_t windowMicros) {
+    return memoWindow<&Memos::oldestPrice>(windowMicros, [&] { return trades_->oldestPrice(windowMicros); });
+}
+
+RollingDifferenceDepthStatistics::WindowCounts SnapshotContext::depthCounts(const int64_t windowMicros) {
+    return memoWindow<&Memos::depthCounts>(windowMicros, [&] { return depth_->windowCounts(windowMicros); });
+}
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "EntryStream.h"
+#include "MMapData.h"
+#include "TimestampIndex.h"
+
+static_assert(sizeof(TimestampIndex::Header) == 48);
+static_assert(sizeof(TimestampIndex::Boundary) == 16 && sizeof(TimestampIndex::AssetPoint) == 24);
+
+namespace {
+    int64_t writeTimeOf(const std::string& path) {
+        return static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+    }
+
+    template <typename T>
+    void writeAll(std::ofstream& out, const std::vector<T>& values) {
+        out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+    template <typename T>
+    void readAll(std::ifstream& in, std::vector<T>& values, const size_t count) {
+        values.resize(count);
+        in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+    }
+}
+
+TimestampIndex TimestampIndex::build(const std::string& csvPath, const uint64_t strideBytes) {
+    MMapData file(csvPath);
+    const std::string_view view = file.view();
+
+    TimestampIndex index;
+    index.sourceSize_ = file.size();
+    index.sourceWriteTime_ = writeTimeOf(csvPath);
+
+    size_t pos = 0;
+    std::string_view headerLine;
+    while (pos < view.size()) {
+        const size_t nl = view.find('\n', pos);
+        const std::string_view line = view.substr(pos, (nl == std::string_view::npos ? view.size() : nl) - pos);
+        pos = nl == std::string_view::npos ? view.size() : nl + 1;
+        if (!line.empty() && line[0] != '#') {
+            headerLine = line;
+            break;
+        }
+    }
+    if (headerLine.empty()) throw std::runtime_error("Header not found in file: " + csvPath);
+
+    std::vector<uint32_t> ends;
+    const DecodePlan plan = EntryDecoder::planMultiAssetParameters(buildColMap(splitFields(headerLine, ends)));
+    index.dataBegin_ = pos;
+
+    CSVIndex lines;
+    DecodedEntry entry;
+    bool groupStart = true;
+    uint64_t groupOffset = pos;
+    size_t asset = 0;
+    uint64_t nextBoundary = pos;
+    // last trade group of every asset so far, and its copy at every boundary
+    std::vector<uint64_t> lastTrades;
+    std::vector<std::vector<uint64_t>> lastTradesAtBoundaries;
+    while (pos < view.size()) {
+        size_t end = view.size();
+        if (view.size() - pos > EntryStream::DEFAULT_CHUNK_BYTES) {
+            const size_t nl = view.find('\n', pos + EntryStream::DEFAULT_CHUNK_BYTES);
+            if (nl != std::string_view::npos) end = nl + 1;
+        }
+        const std::string_view slice = view.substr(pos, end - pos);
+        lines.build(slice);
+
+        lines.forEachLine([&](const CSVFields& tokens) {
+            const std::string_view line = tokens.line();
+            if (line.empty() || line[0] == '#') return;
+            if (plan.decodeRow(plan, tokens, entry, nullptr) != ParseStatus::OK) return;
+
+            if (groupStart) {
+                groupOffset = pos + static_cast<uint64_t>(line.data() - slice.data());
+                const AssetPoint point{entry.timestampOfReceive, groupOffset, entry.symbol, entry.market};
+                if (groupOffset >= nextBoundary) {
+                    index.boundaries_.push_back({entry.timestampOfReceive, groupOffset});
+                    lastTradesAtBoundaries.push_back(lastTrades);
+                    nextBoundary = groupOffset + strideBytes;
+                }
+                if (entry.isSnapshot()) index.snapshots_.push_back(point);
+                const auto known = std::ranges::find_if(index.assets_, [&](const AssetPoint& a) { return a.symbol == entry.symbol && a.market == entry.market; });
+                asset = static_cast<size_t>(known - index.assets_.begin());
+                if (known == index.assets_.end()) {
+                    index.assets_.push_back(point);
+                    lastTrades.push_back(NO_TRADE);
+                }
+            }
+            if (entry.isTrade()) lastTrades[asset] = groupOffset;
+            groupStart = entry.isLast();
+        });
+
+        file.discardBefore(end);
+        pos = end;
+    }
+
+    index.lastTrades_.reserve(lastTradesAtBoundaries.size() * index.assets_.size());
+    for (std::vector<uint64_t>& atBoundary : lastTradesAtBoundaries) {
+        atBoundary.resize(index.assets_.size(), NO_TRADE);
+        index.lastTrades_.insert(index.lastTrades_.end(), atBoundary.begin(), atBoundary.end());
+    }
+    return index;
+}
+
+std::optional<TimestampIndex> TimestampIndex::load(const std::string& csvPath) {
+    const std::string path = sidecarPathOf(csvPath);
+    std::error_code ec;
+    const uint64_t sidecarSize = std::filesystem::file_size(path, ec);
+    if (ec) return std::nullopt;
+
+    std::ifstream in(path, std::ios::binary);
+    Header header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return std::nullopt;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) return std::nullopt;
+    if (sidecarSize != sizeof(Header) + header.boundaryCount * sizeof(Boundary)
+                       + (uint64_t{header.snapshotCount} + header.assetCount) * sizeof(AssetPoint)
+                       + uint64_t{header.boundaryCount} * header.assetCount * sizeof(uint64_t)) return std::nullopt;
+    if (header.sourceSize != std::filesystem::file_size(csvPath) || header.sourceWriteTime != writeTimeOf(csvPath)) return std::nullopt;
+
+    TimestampIndex index;
+    index.sourceSize_ = header.sourceSize;
+    index.sourceWriteTime_ = header.sourceWriteTime;
+    index.dataBegin_ = header.dataBegin;
+    readAll(in, index.boundaries_, header.boundaryCount);
+    readAll(in, index.snapshots_, header.snapshotCount);
+    readAll(in, index.assets_, header.assetCount);
+    readAll(in, index.lastTrades_, uint64_t{header.boundaryCount} * header.assetCount);
+    if (!in) return std::nullopt;
+    return index;
+}
+
+TimestampIndex TimestampIndex::loadOrBuild(const std::string& csvPath) {
+    if (std::optional<TimestampIndex> index = load(csvPath)) return std::move(*index);
+
+    TimestampIndex index = build(csvPath);
+    try {
+        index.save(csvPath);
+    } catch (const std::exception&) {}
+    return index;
+}
+
+void TimestampIndex::save(const std::string& csvPath) const {
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.sourceSize = sourceSize_;
+    header.sourceWriteTime = sourceWriteTime_;
+    header.dataBegin = dataBegin_;
+    header.boundaryCount = static_cast<uint32_t>(boundaries_.size());
+    header.snapshotCount = static_cast<uint32_t>(snapshots_.size());
+    header.assetCount = static_cast<uint32_t>(assets_.size());
+
+    const std::string path = sidecarPathOf(csvPath);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot open timestamp index for writing: " + path);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeAll(out, boundaries_);
+    writeAll(out, snapshots_);
+    writeAll(out, assets_);
+    writeAll(out, lastTrades_);
+    if (!out) throw std::runtime_error("Cannot write timestamp index: " + path);
+}
+
+std::pair<uint64_t, uint64_t> TimestampIndex::replayRange(const int64_t startTimestampOfReceive, const int64_t endTimestampOfReceive, const int64_t warmupMicros) const {
+    const int64_t warmupFrom = startTimestampOfReceive < std::numeric_limits<int64_t>::min() + warmupMicros
+        ? std::numeric_limits<int64_t>::min()
+        : startTimestampOfReceive - warmupMicros;
+
+    // groups before the last boundary ahead of warmupFrom hold nothing newer than it
+    const auto warm = std::ranges::lower_bound(boundaries_, warmupFrom, {}, &Boundary::timestampOfReceive);
+    uint64_t begin = warm == boundaries_.begin() ? dataBegin_ : std::prev(warm)->offset;
+
+    // rows from the last boundary ahead of start on are replayed anyway, so an asset's
+    // last trade ahead of start is either among them or recorded at that boundary
+    const auto started = std::ranges::lower_bound(boundaries_, startTimestampOfReceive, {}, &Boundary::timestampOfReceive);
+    const auto tradesAt = static_cast<size_t>(started - boundaries_.begin());
+
+    for (size_t a = 0; a < assets_.size(); ++a) {
+        const AssetPoint& asset = assets_[a];
+        if (asset.timestampOfReceive >= startTimestampOfReceive) continue;
+        uint64_t from = asset.offset;
+        for (const AssetPoint& snapshot : snapshots_) {
+            if (snapshot.timestampOfReceive >= startTimestampOfReceive) break;
+            if (snapshot.symbol == asset.symbol && snapshot.market == asset.market) from = snapshot.offset;
+        }
+        if (tradesAt > 0) from = std::min(from, lastTradeBefore(tradesAt - 1, a));
+        begin = std::min(begin, from);
+    }
+
+    const auto last = std::ranges::lower_bound(boundaries_, endTimestampOfReceive, {}, &Boundary::timestampOfReceive);
+    const uint64_t end = last == boundaries_.end() ? sourceSize_ : last->offset;
+    return {begin, std::max(begin, end)};
+}